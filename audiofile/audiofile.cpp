@@ -61,6 +61,29 @@ bool AudioFile::open(const QByteArray& b)
       {
       buf = b;
       idx = 0;
+      return openVirtual();
+      }
+
+//---------------------------------------------------------
+//   open
+//    read from the file on demand instead of loading
+//    all of it into memory
+//---------------------------------------------------------
+
+bool AudioFile::open(const QString& path)
+      {
+      file.setFileName(path);
+      if (!file.open(QIODevice::ReadOnly))
+            return false;
+      return openVirtual();
+      }
+
+//---------------------------------------------------------
+//   openVirtual
+//---------------------------------------------------------
+
+bool AudioFile::openVirtual()
+      {
       sf  = sf_open_virtual(&sfio, SFM_READ, &info, this);
       hasInstrument = sf_command(sf, SFC_GET_INSTRUMENT, &inst, sizeof(inst)) == SF_TRUE;
       _type = info.format & SF_FORMAT_OGG ? fltp : s16p;
@@ -109,6 +132,20 @@ sf_count_t AudioFile::readData(short* data, sf_count_t frames)
 
 sf_count_t AudioFile::seek(sf_count_t offset, int whence)
       {
+      if (file.isOpen()) {
+            switch(whence) {
+                  case SEEK_SET:
+                        file.seek(offset);
+                        break;
+                  case SEEK_CUR:
+                        file.seek(file.pos() + offset);
+                        break;
+                  case SEEK_END:
+                        file.seek(file.size() + offset);
+                        break;
+                  }
+            return file.pos();
+            }
       switch(whence) {
             case SEEK_SET:
                   idx = offset;
@@ -129,6 +166,8 @@ sf_count_t AudioFile::seek(sf_count_t offset, int whence)
 
 sf_count_t AudioFile::read(void* ptr, sf_count_t count)
       {
+      if (file.isOpen())
+            return file.read(static_cast<char*>(ptr), count);
       count = qMin(count, (sf_count_t)(buf.size() - idx));
       memcpy(ptr, buf.data() + idx, count);
       idx += count;
@@ -19,6 +19,10 @@
 #include <math.h>
 #include "zita.h"
 
+#ifdef ZITA_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace Ms {
 
 enum {
@@ -233,6 +237,33 @@ void Diff1::fini()
       _line = 0;
       }
 
+//---------------------------------------------------------
+//   readBlock
+//    the next n line outputs; n must not exceed the line
+//    length
+//---------------------------------------------------------
+
+void Diff1::readBlock(float* z, int n) const
+      {
+      int k = std::min(n, _size - _i);
+      memcpy (z, _line + _i, k * sizeof (float));
+      memcpy (z + k, _line, (n - k) * sizeof (float));
+      }
+
+//---------------------------------------------------------
+//   writeBlock
+//---------------------------------------------------------
+
+void Diff1::writeBlock(const float* x, int n)
+      {
+      int k = std::min(n, _size - _i);
+      memcpy (_line + _i, x, k * sizeof (float));
+      memcpy (_line, x + k, (n - k) * sizeof (float));
+      _i += n;
+      if (_i >= _size)
+            _i -= _size;
+      }
+
 Delay::Delay()
    : _size (0), _line (0)
       {
@@ -258,6 +289,33 @@ void Delay::fini ()
       _line = 0;
       }
 
+//---------------------------------------------------------
+//   readBlock
+//    the next n values read() returns; n must not exceed
+//    the delay
+//---------------------------------------------------------
+
+void Delay::readBlock(float* x, int n) const
+      {
+      int k = std::min(n, _size - _i);
+      memcpy (x, _line + _i, k * sizeof (float));
+      memcpy (x + k, _line, (n - k) * sizeof (float));
+      }
+
+//---------------------------------------------------------
+//   writeBlock
+//---------------------------------------------------------
+
+void Delay::writeBlock(const float* x, int n)
+      {
+      int k = std::min(n, _size - _i);
+      memcpy (_line + _i, x, k * sizeof (float));
+      memcpy (_line, x + k, (n - k) * sizeof (float));
+      _i += n;
+      if (_i >= _size)
+            _i -= _size;
+      }
+
 Vdelay::Vdelay ()
    : _size (0), _line (0)
       {
@@ -291,14 +349,88 @@ void Vdelay::set_delay (int del)
             _ir += _size;
       }
 
-void Filt1::set_params (float del, float tmf, float tlo, float wlo, float thi, float chi)
+//---------------------------------------------------------
+//   Filt1
+//---------------------------------------------------------
+
+Filt1::Filt1()
+   : _ramp (false)
+      {
+      for (int i = 0; i < LANES; i++) {
+            _gmf [i] = _glo [i] = _wlo [i] = _whi [i] = 0;
+            _slo [i] = _shi [i] = 0;
+            _dgmf [i] = _dglo [i] = _dwlo [i] = _dwhi [i] = 0;
+            }
+      }
+
+//---------------------------------------------------------
+//   set_params
+//    the new coefficients take effect in prepare()
+//---------------------------------------------------------
+
+void Filt1::set_params (int lane, float del, float tmf, float tlo, float wlo, float thi, float chi)
       {
-      _gmf = powf (0.001f, del / tmf);
-      _glo = powf (0.001f, del / tlo) / _gmf - 1.0f;
-      _wlo = wlo;
-      float g    = powf (0.001f, del / thi) / _gmf;
+      _tgmf [lane] = powf (0.001f, del / tmf);
+      _tglo [lane] = powf (0.001f, del / tlo) / _tgmf [lane] - 1.0f;
+      _twlo [lane] = wlo;
+      float g    = powf (0.001f, del / thi) / _tgmf [lane];
       float t    = (1 - g * g) / (2 * g * g * chi);
-      _whi = (sqrtf (1 + 4 * t) - 1) / (2 * t);
+      _twhi [lane] = (sqrtf (1 + 4 * t) - 1) / (2 * t);
+      }
+
+//---------------------------------------------------------
+//   prepare
+//    ramp to the new coefficients within nsamp frames or
+//    use them right away
+//---------------------------------------------------------
+
+void Filt1::prepare (int nsamp, bool smooth)
+      {
+      for (int i = 0; i < LANES; i++) {
+            if (smooth) {
+                  _dgmf [i] = (_tgmf [i] - _gmf [i]) / nsamp;
+                  _dglo [i] = (_tglo [i] - _glo [i]) / nsamp;
+                  _dwlo [i] = (_twlo [i] - _wlo [i]) / nsamp;
+                  _dwhi [i] = (_twhi [i] - _whi [i]) / nsamp;
+                  }
+            else {
+                  _gmf [i] = _tgmf [i];
+                  _glo [i] = _tglo [i];
+                  _wlo [i] = _twlo [i];
+                  _whi [i] = _twhi [i];
+                  }
+            }
+      _ramp = smooth;
+      }
+
+//---------------------------------------------------------
+//   step
+//    advance the ramp by nsamp frames; the coefficients
+//    are constant within a processed block
+//---------------------------------------------------------
+
+void Filt1::step (int nsamp)
+      {
+      if (!_ramp)
+            return;
+      for (int i = 0; i < LANES; i++) {
+            _gmf [i] += _dgmf [i] * nsamp;
+            _glo [i] += _dglo [i] * nsamp;
+            _wlo [i] += _dwlo [i] * nsamp;
+            _whi [i] += _dwhi [i] * nsamp;
+            }
+      }
+
+//---------------------------------------------------------
+//   finish
+//    end of the ramp; land exactly on the new coefficients
+//---------------------------------------------------------
+
+void Filt1::finish ()
+      {
+      if (!_ramp)
+            return;
+      prepare (1, false);
       }
 
 float ZitaReverb::_tdiff1 [8] = {
@@ -350,12 +482,16 @@ void ZitaReverb::init(float fsamp)
 
       _vdelay0.init ((int)(0.1f * _fsamp));
       _vdelay1.init ((int)(0.1f * _fsamp));
+      _block = BLOCK;
       for (int i = 0; i < 8; i++) {
             int k1 = (int)(floorf (_tdiff1 [i] * _fsamp + 0.5f));
             int k2 = (int)(floorf (_tdelay [i] * _fsamp + 0.5f));
             _diff1 [i].init (k1, (i & 1) ? -0.6f : 0.6f);
             _delay [i].init (k2 - k1);
+            // a block reads all line outputs before it writes
+            _block = std::min(_block, std::min(k1, k2 - k1));
             }
+      _filtValid = false;
 
       _pareq1.setfsamp(fsamp);
       _pareq2.setfsamp(fsamp);
@@ -384,6 +520,7 @@ void ZitaReverb::prepare (int nfram)
       int c = _cntC1;
 
       _d0 = _d1 = 0;
+      _filt1.finish ();
 
       if (a != _cntA2) {
             int k = (int)(floorf ((_ipdel - 0.020f) * _fsamp + 0.5f));
@@ -400,8 +537,10 @@ void ZitaReverb::prepare (int nfram)
             else
                   chi = 1 - cosf (6.2832f * _fdamp / _fsamp);
             for (int i = 0; i < 8; i++) {
-                  _filt1 [i].set_params (_tdelay [i], _rtmid, _rtlow, wlo, 0.5f * _rtmid, chi);
+                  _filt1.set_params (i, _tdelay [i], _rtmid, _rtlow, wlo, 0.5f * _rtmid, chi);
                   }
+            _filt1.prepare (nfram, _filtValid);
+            _filtValid = true;
             _cntB2 = b;
             }
 
@@ -418,15 +557,223 @@ void ZitaReverb::prepare (int nfram)
       }
 
 //---------------------------------------------------------
-//   process
+//   processFrames
+//    n frames, one lane after the other
 //---------------------------------------------------------
 
-void ZitaReverb::process (int nfram, float* inp, float* out)
+void ZitaReverb::processFrames(int n, const float* inp, float* out)
+      {
+      float t, x0, x1, x2, x3, x4, x5, x6, x7;
+      const float g = sqrtf (0.125f);
+
+      const float* p0 = inp;
+      const float* p1 = inp + 1;
+      float* q0 = out;
+      float* q1 = out + 1;
+
+      for (int i = 0; i < n * 2; i += 2) {
+            _vdelay0.write (p0 [i]);
+            _vdelay1.write (p1 [i]);
+
+            t = 0.3f * _vdelay0.read ();
+            x0 = _diff1 [0].process (_delay [0].read () + t);
+            x1 = _diff1 [1].process (_delay [1].read () + t);
+            x2 = _diff1 [2].process (_delay [2].read () - t);
+            x3 = _diff1 [3].process (_delay [3].read () - t);
+            t = 0.3f * _vdelay1.read ();
+            x4 = _diff1 [4].process (_delay [4].read () + t);
+            x5 = _diff1 [5].process (_delay [5].read () + t);
+            x6 = _diff1 [6].process (_delay [6].read () - t);
+            x7 = _diff1 [7].process (_delay [7].read () - t);
+
+            t = x0 - x1; x0 += x1;  x1 = t;
+            t = x2 - x3; x2 += x3;  x3 = t;
+            t = x4 - x5; x4 += x5;  x5 = t;
+            t = x6 - x7; x6 += x7;  x7 = t;
+            t = x0 - x2; x0 += x2;  x2 = t;
+            t = x1 - x3; x1 += x3;  x3 = t;
+            t = x4 - x6; x4 += x6;  x6 = t;
+            t = x5 - x7; x5 += x7;  x7 = t;
+            t = x0 - x4; x0 += x4;  x4 = t;
+            t = x1 - x5; x1 += x5;  x5 = t;
+            t = x2 - x6; x2 += x6;  x6 = t;
+            t = x3 - x7; x3 += x7;  x7 = t;
+
+            _g1 += _d1;
+
+            q0 [i] = _g1 * (x1 + x2);
+            q1 [i] = _g1 * (x1 - x2);
+
+            _delay [0].write (_filt1.process (0, g * x0));
+            _delay [1].write (_filt1.process (1, g * x1));
+            _delay [2].write (_filt1.process (2, g * x2));
+            _delay [3].write (_filt1.process (3, g * x3));
+            _delay [4].write (_filt1.process (4, g * x4));
+            _delay [5].write (_filt1.process (5, g * x5));
+            _delay [6].write (_filt1.process (6, g * x6));
+            _delay [7].write (_filt1.process (7, g * x7));
+            }
+      }
+
+#ifdef ZITA_SSE2
+//---------------------------------------------------------
+//   lanesToFrames
+//    n frames of the eight lanes in lane order to frame
+//    order, n a multiple of four
+//---------------------------------------------------------
+
+static void lanesToFrames(const float (*lane)[ZitaReverb::BLOCK], float* frames, int n)
+      {
+      for (int i = 0; i < n; i += 4) {
+            for (int l = 0; l < 8; l += 4) {
+                  __m128 r0 = _mm_load_ps (lane [l] + i);
+                  __m128 r1 = _mm_load_ps (lane [l + 1] + i);
+                  __m128 r2 = _mm_load_ps (lane [l + 2] + i);
+                  __m128 r3 = _mm_load_ps (lane [l + 3] + i);
+                  _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+                  _mm_store_ps (frames + i * 8 + l, r0);
+                  _mm_store_ps (frames + (i + 1) * 8 + l, r1);
+                  _mm_store_ps (frames + (i + 2) * 8 + l, r2);
+                  _mm_store_ps (frames + (i + 3) * 8 + l, r3);
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   framesToLanes
+//---------------------------------------------------------
+
+static void framesToLanes(const float* frames, float (*lane)[ZitaReverb::BLOCK], int n)
+      {
+      for (int i = 0; i < n; i += 4) {
+            for (int l = 0; l < 8; l += 4) {
+                  __m128 r0 = _mm_load_ps (frames + i * 8 + l);
+                  __m128 r1 = _mm_load_ps (frames + (i + 1) * 8 + l);
+                  __m128 r2 = _mm_load_ps (frames + (i + 2) * 8 + l);
+                  __m128 r3 = _mm_load_ps (frames + (i + 3) * 8 + l);
+                  _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+                  _mm_store_ps (lane [l] + i, r0);
+                  _mm_store_ps (lane [l + 1] + i, r1);
+                  _mm_store_ps (lane [l + 2] + i, r2);
+                  _mm_store_ps (lane [l + 3] + i, r3);
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   processLanes
+//    n <= _block frames with the eight lanes of the
+//    feedback network in two SSE registers. As every line
+//    is longer than the block, all line outputs are read
+//    up front and the inputs written afterwards. Computes
+//    the same operations as processFrames().
+//---------------------------------------------------------
+
+void ZitaReverb::processLanes(int n, const float* inp, float* out)
       {
-      float t, g, x0, x1, x2, x3, x4, x5, x6, x7;
-      g = sqrtf (0.125f);
+      alignas(16) float ta [BLOCK];
+      alignas(16) float tb [BLOCK];
+      alignas(16) float lane [8][BLOCK];
+      alignas(16) float line [BLOCK * 8];     // delay outputs, then filter outputs
+      alignas(16) float diff [BLOCK * 8];     // diffuser outputs, then inputs
+      alignas(16) float h [4];
+      const int m = (n + 3) & ~3;
+
+      for (int i = 0; i < n; i++) {
+            _vdelay0.write (inp [i * 2]);
+            _vdelay1.write (inp [i * 2 + 1]);
+            ta [i] = 0.3f * _vdelay0.read ();
+            tb [i] = 0.3f * _vdelay1.read ();
+            }
+      for (int l = 0; l < 8; l++) {
+            _delay [l].readBlock (lane [l], n);
+            std::fill (lane [l] + n, lane [l] + m, 0.0f);
+            }
+      lanesToFrames (lane, line, m);
+      for (int l = 0; l < 8; l++) {
+            _diff1 [l].readBlock (lane [l], n);
+            std::fill (lane [l] + n, lane [l] + m, 0.0f);
+            }
+      lanesToFrames (lane, diff, m);
+
+      const __m128 neg13 = _mm_setr_ps (0.0f, -0.0f, 0.0f, -0.0f);   // sign bits to negate lanes
+      const __m128 neg23 = _mm_setr_ps (0.0f, 0.0f, -0.0f, -0.0f);
+      const __m128 g     = _mm_set1_ps (sqrtf (0.125f));
+      const __m128 eps   = _mm_set1_ps (1e-10f);
+      const __m128 c0    = _mm_setr_ps (_diff1 [0]._c, _diff1 [1]._c, _diff1 [2]._c, _diff1 [3]._c);
+      const __m128 c1    = _mm_setr_ps (_diff1 [4]._c, _diff1 [5]._c, _diff1 [6]._c, _diff1 [7]._c);
+      const __m128 gmf0  = _mm_loadu_ps (_filt1._gmf), gmf1 = _mm_loadu_ps (_filt1._gmf + 4);
+      const __m128 glo0  = _mm_loadu_ps (_filt1._glo), glo1 = _mm_loadu_ps (_filt1._glo + 4);
+      const __m128 wlo0  = _mm_loadu_ps (_filt1._wlo), wlo1 = _mm_loadu_ps (_filt1._wlo + 4);
+      const __m128 whi0  = _mm_loadu_ps (_filt1._whi), whi1 = _mm_loadu_ps (_filt1._whi + 4);
+      __m128 slo0 = _mm_loadu_ps (_filt1._slo), slo1 = _mm_loadu_ps (_filt1._slo + 4);
+      __m128 shi0 = _mm_loadu_ps (_filt1._shi), shi1 = _mm_loadu_ps (_filt1._shi + 4);
+      float g1 = _g1;
+
+      for (int i = 0; i < n; i++) {
+            float* d = diff + i * 8;
+            float* l = line + i * 8;
+
+            // diffusers, lanes 2, 3, 6 and 7 subtract the input
+            __m128 z0 = _mm_load_ps (d);
+            __m128 z1 = _mm_load_ps (d + 4);
+            __m128 x0 = _mm_add_ps (_mm_load_ps (l), _mm_xor_ps (_mm_set1_ps (ta [i]), neg23));
+            __m128 x1 = _mm_add_ps (_mm_load_ps (l + 4), _mm_xor_ps (_mm_set1_ps (tb [i]), neg23));
+            x0 = _mm_sub_ps (x0, _mm_mul_ps (c0, z0));
+            x1 = _mm_sub_ps (x1, _mm_mul_ps (c1, z1));
+            _mm_store_ps (d, x0);
+            _mm_store_ps (d + 4, x1);
+            x0 = _mm_add_ps (z0, _mm_mul_ps (c0, x0));
+            x1 = _mm_add_ps (z1, _mm_mul_ps (c1, x1));
+
+            // Hadamard mixing: pairs of neighbours, of
+            // neighbour pairs and of the two registers
+            x0 = _mm_add_ps (_mm_shuffle_ps (x0, x0, _MM_SHUFFLE(2, 3, 0, 1)), _mm_xor_ps (x0, neg13));
+            x1 = _mm_add_ps (_mm_shuffle_ps (x1, x1, _MM_SHUFFLE(2, 3, 0, 1)), _mm_xor_ps (x1, neg13));
+            x0 = _mm_add_ps (_mm_shuffle_ps (x0, x0, _MM_SHUFFLE(1, 0, 3, 2)), _mm_xor_ps (x0, neg23));
+            x1 = _mm_add_ps (_mm_shuffle_ps (x1, x1, _MM_SHUFFLE(1, 0, 3, 2)), _mm_xor_ps (x1, neg23));
+            __m128 t = x0;
+            x0 = _mm_add_ps (x0, x1);
+            x1 = _mm_sub_ps (t, x1);
+
+            g1 += _d1;
+            _mm_store_ps (h, x0);
+            out [i * 2]     = g1 * (h [1] + h [2]);
+            out [i * 2 + 1] = g1 * (h [1] - h [2]);
+
+            // damping filters
+            x0 = _mm_mul_ps (g, x0);
+            x1 = _mm_mul_ps (g, x1);
+            slo0 = _mm_add_ps (slo0, _mm_add_ps (_mm_mul_ps (wlo0, _mm_sub_ps (x0, slo0)), eps));
+            slo1 = _mm_add_ps (slo1, _mm_add_ps (_mm_mul_ps (wlo1, _mm_sub_ps (x1, slo1)), eps));
+            x0 = _mm_add_ps (x0, _mm_mul_ps (glo0, slo0));
+            x1 = _mm_add_ps (x1, _mm_mul_ps (glo1, slo1));
+            shi0 = _mm_add_ps (shi0, _mm_mul_ps (whi0, _mm_sub_ps (x0, shi0)));
+            shi1 = _mm_add_ps (shi1, _mm_mul_ps (whi1, _mm_sub_ps (x1, shi1)));
+            _mm_store_ps (l, _mm_mul_ps (gmf0, shi0));
+            _mm_store_ps (l + 4, _mm_mul_ps (gmf1, shi1));
+            }
+
+      _g1 = g1;
+      _mm_storeu_ps (_filt1._slo, slo0);
+      _mm_storeu_ps (_filt1._slo + 4, slo1);
+      _mm_storeu_ps (_filt1._shi, shi0);
+      _mm_storeu_ps (_filt1._shi + 4, shi1);
+      framesToLanes (line, lane, m);
+      for (int l = 0; l < 8; l++)
+            _delay [l].writeBlock (lane [l], n);
+      framesToLanes (diff, lane, m);
+      for (int l = 0; l < 8; l++)
+            _diff1 [l].writeBlock (lane [l], n);
+      }
+#endif
 
+//---------------------------------------------------------
+//   process
+//---------------------------------------------------------
 
+void ZitaReverb::process (int nfram, float* inp, float* out)
+      {
       while (nfram) {
             if (!_nsamp) {
                   prepare(_fragm);
@@ -435,52 +782,16 @@ void ZitaReverb::process (int nfram, float* inp, float* out)
 
             int k = _nsamp < nfram ? _nsamp : nfram;
 
-            float* p0 = inp;
-            float* p1 = inp + 1;
-            float* q0 = out;
-            float* q1 = out + 1;
-
-            for (int i = 0; i < k * 2; i += 2) {
-                  _vdelay0.write (p0 [i]);
-                  _vdelay1.write (p1 [i]);
-
-                  t = 0.3f * _vdelay0.read ();
-                  x0 = _diff1 [0].process (_delay [0].read () + t);
-                  x1 = _diff1 [1].process (_delay [1].read () + t);
-                  x2 = _diff1 [2].process (_delay [2].read () - t);
-                  x3 = _diff1 [3].process (_delay [3].read () - t);
-                  t = 0.3f * _vdelay1.read ();
-                  x4 = _diff1 [4].process (_delay [4].read () + t);
-                  x5 = _diff1 [5].process (_delay [5].read () + t);
-                  x6 = _diff1 [6].process (_delay [6].read () - t);
-                  x7 = _diff1 [7].process (_delay [7].read () - t);
-
-                  t = x0 - x1; x0 += x1;  x1 = t;
-                  t = x2 - x3; x2 += x3;  x3 = t;
-                  t = x4 - x5; x4 += x5;  x5 = t;
-                  t = x6 - x7; x6 += x7;  x7 = t;
-                  t = x0 - x2; x0 += x2;  x2 = t;
-                  t = x1 - x3; x1 += x3;  x3 = t;
-                  t = x4 - x6; x4 += x6;  x6 = t;
-                  t = x5 - x7; x5 += x7;  x7 = t;
-                  t = x0 - x4; x0 += x4;  x4 = t;
-                  t = x1 - x5; x1 += x5;  x5 = t;
-                  t = x2 - x6; x2 += x6;  x6 = t;
-                  t = x3 - x7; x3 += x7;  x7 = t;
-
-                  _g1 += _d1;
-
-                  q0 [i] = _g1 * (x1 + x2);
-                  q1 [i] = _g1 * (x1 - x2);
-
-                  _delay [0].write (_filt1 [0].process (g * x0));
-                  _delay [1].write (_filt1 [1].process (g * x1));
-                  _delay [2].write (_filt1 [2].process (g * x2));
-                  _delay [3].write (_filt1 [3].process (g * x3));
-                  _delay [4].write (_filt1 [4].process (g * x4));
-                  _delay [5].write (_filt1 [5].process (g * x5));
-                  _delay [6].write (_filt1 [6].process (g * x6));
-                  _delay [7].write (_filt1 [7].process (g * x7));
+            for (int i = 0; i < k;) {
+                  int n = std::min(k - i, _block);
+#ifdef ZITA_SSE2
+                  if (_vectorized)
+                        processLanes(n, inp + i * 2, out + i * 2);
+                  else
+#endif
+                        processFrames(n, inp + i * 2, out + i * 2);
+                  _filt1.step(n);
+                  i += n;
                   }
             _pareq1.process (k, out);
             _pareq2.process (k, out);
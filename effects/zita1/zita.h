@@ -21,6 +21,10 @@
 
 #include "effects/effect.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZITA_SSE2
+#endif
+
 namespace Ms {
 
 class EffectGui;
@@ -105,33 +109,49 @@ class Diff1
                   _i = 0;
             return z + _c * x;
             }
+      void  readBlock (float* z, int n) const;
+      void  writeBlock (const float* x, int n);
       };
 
 //---------------------------------------------------------
 //   Filt1
+//    the damping filters of the eight feedback lanes,
+//    stored by lane so that all lanes are processed in
+//    SIMD registers. New coefficients are reached with a
+//    linear ramp over one fragment.
 //---------------------------------------------------------
 
 class Filt1
       {
       friend class ZitaReverb;
 
-      Filt1 () : _slo (0), _shi (0) {}
-      ~Filt1 () {}
+      enum { LANES = 8 };
 
-      void  set_params (float del, float tmf, float tlo, float wlo, float thi, float chi);
+      Filt1();
+      ~Filt1() {}
 
-      float process(float x) {
-            _slo += _wlo * (x - _slo) + 1e-10f;
-            x += _glo * _slo;
-            _shi += _whi * (x - _shi);
-            return _gmf * _shi;
+      void  set_params (int lane, float del, float tmf, float tlo, float wlo, float thi, float chi);
+      void  prepare (int nsamp, bool smooth);
+      void  step (int nsamp);
+      void  finish ();
+
+      float process(int i, float x) {
+            _slo[i] += _wlo[i] * (x - _slo[i]) + 1e-10f;
+            x += _glo[i] * _slo[i];
+            _shi[i] += _whi[i] * (x - _shi[i]);
+            return _gmf[i] * _shi[i];
             }
-      float   _gmf;
-      float   _glo;
-      float   _wlo;
-      float   _whi;
-      float   _slo;
-      float   _shi;
+      float   _gmf[LANES];
+      float   _glo[LANES];
+      float   _wlo[LANES];
+      float   _whi[LANES];
+      float   _slo[LANES];
+      float   _shi[LANES];
+
+      // ramp to the coefficients of the last set_params()
+      float   _tgmf[LANES], _tglo[LANES], _twlo[LANES], _twhi[LANES];
+      float   _dgmf[LANES], _dglo[LANES], _dwlo[LANES], _dwhi[LANES];
+      bool    _ramp;
       };
 
 //---------------------------------------------------------
@@ -155,6 +175,8 @@ class Delay
             if (_i == _size)
                   _i = 0;
             }
+      void  readBlock (float* x, int n) const;
+      void  writeBlock (const float* x, int n);
       int     _i;
       int     _size;
       float  *_line;
@@ -206,7 +228,7 @@ class ZitaReverb : public Effect
       Vdelay  _vdelay0;
       Vdelay  _vdelay1;
       Diff1   _diff1[8];
-      Filt1   _filt1[8];
+      Filt1   _filt1;
       Delay   _delay[8];
 
       volatile int _cntA1;
@@ -235,10 +257,19 @@ class ZitaReverb : public Effect
 
       int _fragm;
       int _nsamp;
+      int _block;
+      bool _filtValid;
+      bool _vectorized { true };
 
       void prepare(int n);
+      void processFrames(int n, const float* inp, float* out);
+#ifdef ZITA_SSE2
+      void processLanes(int n, const float* inp, float* out);
+#endif
 
    public:
+      static const int BLOCK = 64;
+
       ZitaReverb() : Effect() {}
       ~ZitaReverb();
 
@@ -246,6 +277,7 @@ class ZitaReverb : public Effect
       void fini();
 
       virtual void process(int n, float* inp, float* out);
+      void setVectorized(bool val) { _vectorized = val; }     // off processes the lanes one by one
 
       void set_delay(float v) { _ipdel = v; _cntA1++; }
       float delay() const     { return _ipdel; }
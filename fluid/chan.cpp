@@ -244,7 +244,9 @@ void Channel::pitchWheelSens(int val)
 void Channel::setPreset(Preset* p)
       {
       if (_preset != p) {
-            if (p)
+            if (p && synth->asyncSampleLoading())
+                  p->loadSamplesAsync();
+            else if (p)
                   p->loadSamples();
             _preset = p;
             }
@@ -21,6 +21,7 @@
 #include "fluid.h"
 #include "voice.h"
 #include "sfont.h"
+#include "dspkernels.h"
 
 namespace FluidS {
 
@@ -71,6 +72,56 @@ inline bool Voice::updateAmpInc(unsigned int &nextNewAmpInc, std::map<int, qreal
       return true;
       }
 
+//---------------------------------------------------------
+//   interpolateRun
+//    Interpolate the samples from dsp_i on with the dsp
+//    kernel of this CPU as long as updateAmpInc() would
+//    not change anything: the amplitude increment stays,
+//    the voice is not turned off and the amplitude is not
+//    0. The phase has to stay at or below end_index and
+//    all points the kernel reads within the sample data.
+//    Advances dsp_phase and amp; returns the number of
+//    samples done, 0 if the caller has to interpolate the
+//    next sample itself.
+//---------------------------------------------------------
+
+static const int DSP_RUN     = 64;
+static const int DSP_MIN_RUN = 8;
+
+unsigned Voice::interpolateRun(int kind, Phase& dsp_phase, Phase dsp_phase_incr, unsigned dsp_i, unsigned n,
+   unsigned end_index, unsigned nextNewAmpInc, qreal dsp_amp_incr)
+      {
+      static const int pointsBefore[DSP_INTERP_COUNT] = { 0, 0, 1, 4 };
+      static const int pointsAfter[DSP_INTERP_COUNT]  = { 0, 1, 3, 4 };
+
+      if (amp == 0.0f || dsp_i >= nextNewAmpInc || dsp_phase_incr.data <= 0)
+            return 0;
+      qint64 run = std::min<qint64>(std::min(n, nextNewAmpInc) - dsp_i, DSP_RUN);
+      if (positionToTurnOff > 0)
+            run = std::min<qint64>(run, qint64(positionToTurnOff) - dsp_i);
+
+      // the none kernel rounds to the nearest point
+      const qint64 p0   = dsp_phase.data + (kind == DSP_INTERP_NONE ? 0x80000000LL : 0);
+      const qint64 last = std::min<qint64>(end_index, qint64(sample->end) - pointsAfter[kind]);
+      if ((p0 >> 32) - pointsBefore[kind] < 0 || (p0 >> 32) > last)
+            return 0;
+      run = std::min(run, (((last + 1) << 32) - 1 - p0) / dsp_phase_incr.data + 1);
+      if (run < DSP_MIN_RUN)
+            return 0;
+
+      float amps[DSP_RUN];
+      for (int i = 0; i < run; ++i) {
+            if (amp == 0.0f) {
+                  run = i;
+                  break;
+                  }
+            amps[i] = amp;
+            amp += dsp_amp_incr;
+            }
+      dspKernels().interpolate[kind](sample->data, dsp_phase.data, dsp_phase_incr.data, amps, dsp_buf.data() + dsp_i, int(run));
+      dsp_phase.data += run * dsp_phase_incr.data;
+      return unsigned(run);
+      }
 
 /* Interpolation (find a value between two samples of the original waveform) */
 
@@ -129,6 +180,7 @@ void Voice::dsp_float_config()
                   sinc_table7[FLUID_INTERP_MAX - i2 - 1][i] = v;
                   }
             }
+      initDspKernels(interp_coeff_linear, interp_coeff, sinc_table7);
       fluid_check_fpe("interpolation table calculation");
       }
 
@@ -145,7 +197,7 @@ int Voice::dsp_float_interpolate_none(unsigned n)
 
       Phase dsp_phase = voice->phase;
       Phase dsp_phase_incr; //  end_phase;
-      short int *dsp_data = voice->sample->data;
+      const short int *dsp_data = voice->sample->data;
       auto curSample2AmpInc = Sample2AmpInc.begin();
       qreal dsp_amp_incr = curSample2AmpInc->second;
       unsigned int nextNewAmpInc = curSample2AmpInc->first;
@@ -169,6 +221,11 @@ int Voice::dsp_float_interpolate_none(unsigned n)
 
             /* interpolate sequence of sample points */
             for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
+                  if (unsigned run = interpolateRun(DSP_INTERP_NONE, dsp_phase, dsp_phase_incr, dsp_i, n, end_index, nextNewAmpInc, dsp_amp_incr)) {
+                        dsp_i += run - 1;
+                        dsp_phase_index = dsp_phase.index_round();
+                        continue;
+                        }
                   dsp_buf[dsp_i] = amp * dsp_data[dsp_phase_index];
 
                   /* increment phase and amplitude */
@@ -210,7 +267,7 @@ int Voice::dsp_float_interpolate_linear(unsigned n)
       Voice* voice = this;
       Phase dsp_phase = voice->phase;
       Phase dsp_phase_incr; // end_phase;
-      short int *dsp_data = voice->sample->data;
+      const short int *dsp_data = voice->sample->data;
       auto curSample2AmpInc = Sample2AmpInc.begin();
       qreal dsp_amp_incr = curSample2AmpInc->second;
       unsigned int nextNewAmpInc = curSample2AmpInc->first;
@@ -243,6 +300,11 @@ int Voice::dsp_float_interpolate_linear(unsigned n)
 
             /* interpolate the sequence of sample points */
             for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
+                  if (unsigned run = interpolateRun(DSP_INTERP_LINEAR, dsp_phase, dsp_phase_incr, dsp_i, n, end_index, nextNewAmpInc, dsp_amp_incr)) {
+                        dsp_i += run - 1;
+                        dsp_phase_index = dsp_phase.index();
+                        continue;
+                        }
                   coeffs = interp_coeff_linear[fluid_phase_fract_to_tablerow (dsp_phase)];
                   dsp_buf[dsp_i] = amp * (coeffs[0] * dsp_data[dsp_phase_index]
 				  + coeffs[1] * dsp_data[dsp_phase_index+1]);
@@ -304,7 +366,7 @@ int Voice::dsp_float_interpolate_linear(unsigned n)
 int Voice::dsp_float_interpolate_4th_order(unsigned n)
       {
       Phase dsp_phase_incr; // end_phase;
-      short int* dsp_data = sample->data;
+      const short int* dsp_data = sample->data;
       auto curSample2AmpInc = Sample2AmpInc.begin();
       qreal dsp_amp_incr = curSample2AmpInc->second;
       unsigned int nextNewAmpInc = curSample2AmpInc->first;
@@ -366,6 +428,11 @@ int Voice::dsp_float_interpolate_4th_order(unsigned n)
 
             /* interpolate the sequence of sample points */
             for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
+                  if (unsigned run = interpolateRun(DSP_INTERP_4TH, phase, dsp_phase_incr, dsp_i, n, end_index, nextNewAmpInc, dsp_amp_incr)) {
+                        dsp_i += run - 1;
+                        dsp_phase_index = phase.index();
+                        continue;
+                        }
                   coeffs = interp_coeff[fluid_phase_fract_to_tablerow (phase)];
                   auto val = amp * (coeffs[0] * dsp_data[dsp_phase_index-1]
                                    + coeffs[1] * dsp_data[dsp_phase_index]
@@ -456,7 +523,7 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
 
       Phase dsp_phase = voice->phase;
       Phase dsp_phase_incr; // end_phase;
-      short int *dsp_data = voice->sample->data;
+      const short int *dsp_data = voice->sample->data;
       auto curSample2AmpInc = Sample2AmpInc.begin();
       qreal dsp_amp_incr = curSample2AmpInc->second;
       unsigned int nextNewAmpInc = curSample2AmpInc->first;
@@ -579,6 +646,11 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
 
             /* interpolate the sequence of sample points */
             for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
+                  if (unsigned run = interpolateRun(DSP_INTERP_7TH, dsp_phase, dsp_phase_incr, dsp_i, n, end_index, nextNewAmpInc, dsp_amp_incr)) {
+                        dsp_i += run - 1;
+                        dsp_phase_index = dsp_phase.index();
+                        continue;
+                        }
                   coeffs = sinc_table7[fluid_phase_fract_to_tablerow (dsp_phase)];
 
                   dsp_buf[dsp_i] = amp * (coeffs[0] * (float)dsp_data[dsp_phase_index-3]
@@ -0,0 +1,422 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "fluid.h"
+#include "dspkernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLUID_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FLUID_HAVE_AVX2
+#define FLUID_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define FLUID_HAVE_AVX2
+#define FLUID_TARGET_AVX2
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace FluidS {
+
+//
+// the interpolation tables of Voice; the 7th order rows
+// get a leading 0 to fill 8 floats
+//
+
+alignas(16) static float linearTable[FLUID_INTERP_MAX][2];
+alignas(16) static float cubicTable[FLUID_INTERP_MAX][4];
+alignas(32) static float sincTable[FLUID_INTERP_MAX][8];
+
+static inline int tableRow(qint64 phase)  { return int(quint32(phase) >> 24); }
+static inline int phaseIndex(qint64 phase) { return int(phase >> 32); }
+
+//---------------------------------------------------------
+//   initDspKernels
+//---------------------------------------------------------
+
+void initDspKernels(const float linear[][2], const float cubic[][4], const float sinc7[][7])
+      {
+      for (int i = 0; i < FLUID_INTERP_MAX; ++i) {
+            linearTable[i][0] = linear[i][0];
+            linearTable[i][1] = linear[i][1];
+            for (int k = 0; k < 4; ++k)
+                  cubicTable[i][k] = cubic[i][k];
+            sincTable[i][0] = 0.0f;
+            for (int k = 0; k < 7; ++k)
+                  sincTable[i][k + 1] = sinc7[i][k];
+            }
+      }
+
+//---------------------------------------------------------
+//   scalar kernels
+//    the expressions of the dsp_float_interpolate_*
+//    loops
+//---------------------------------------------------------
+
+static void interpolateNoneScalar(const short* data, qint64 phase, qint64 incr, const float* amp, float* out, int frames)
+      {
+      for (int i = 0; i < frames; ++i, phase += incr)
+            out[i] = amp[i] * data[phaseIndex(phase + 0x80000000LL)];
+      }
+
+static void interpolateLinearScalar(const short* data, qint64 phase, qint64 incr, const float* amp, float* out, int frames)
+      {
+      for (int i = 0; i < frames; ++i, phase += incr) {
+            const float* c = linearTable[tableRow(phase)];
+            const short* d = data + phaseIndex(phase);
+            out[i] = amp[i] * (c[0] * d[0] + c[1] * d[1]);
+            }
+      }
+
+static void interpolate4thScalar(const short* data, qint64 phase, qint64 incr, const float* amp, float* out, int frames)
+      {
+      for (int i = 0; i < frames; ++i, phase += incr) {
+            const float* c = cubicTable[tableRow(phase)];
+            const short* d = data + phaseIndex(phase);
+            out[i] = amp[i] * (c[0] * d[-1] + c[1] * d[0] + c[2] * d[1] + c[3] * d[2]);
+            }
+      }
+
+static void interpolate7thScalar(const short* data, qint64 phase, qint64 incr, const float* amp, float* out, int frames)
+      {
+      for (int i = 0; i < frames; ++i, phase += incr) {
+            const float* c = sincTable[tableRow(phase)] + 1;
+            const short* d = data + phaseIndex(phase);
+            out[i] = amp[i] * (c[0] * (float)d[-3]
+               + c[1] * (float)d[-2]
+               + c[2] * (float)d[-1]
+               + c[3] * (float)d[0]
+               + c[4] * (float)d[1]
+               + c[5] * (float)d[2]
+               + c[6] * (float)d[3]);
+            }
+      }
+
+static void mixScalar(const float* in, int frames, float ampLeft, float ampRight, float ampReverb, float ampChorus,
+   float* out, float* reverb, float* chorus)
+      {
+      for (int i = 0; i < frames; ++i) {
+            float vv = in[i] * ampLeft;
+            *out++ += vv;
+            *reverb++ += vv * ampReverb;
+            *chorus++ += vv * ampChorus;
+
+            vv = in[i] * ampRight;
+            *out++ += vv;
+            *reverb++ += vv * ampReverb;
+            *chorus++ += vv * ampChorus;
+            }
+      }
+
+static const DspKernels scalarKernels = {
+      "scalar",
+      { interpolateNoneScalar, interpolateLinearScalar, interpolate4thScalar, interpolate7thScalar },
+      mixScalar
+      };
+
+#ifdef FLUID_HAVE_SSE2
+//---------------------------------------------------------
+//   SSE2 kernels
+//    four output samples per iteration; the points and
+//    coefficients of four samples are transposed so the
+//    sums keep the order of the scalar expressions
+//---------------------------------------------------------
+
+static inline __m128 loadPoints(const short* p)
+      {
+      const __m128i s = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+      return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+      }
+
+static void interpolateNoneSse2(const short* data, qint64 phase, qint64 incr, const float* amp, float* out, int frames)
+      {
+      int i = 0;
+      for (; i + 4 <= frames; i += 4, phase += 4 * incr) {
+            const __m128 x = _mm_setr_ps(data[phaseIndex(phase + 0x80000000LL)],
+               data[phaseIndex(phase + incr + 0x80000000LL)],
+               data[phaseIndex(phase + 2 * incr + 0x80000000LL)],
+               data[phaseIndex(phase + 3 * incr + 0x80000000LL)]);
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(amp + i), x));
+            }
+      interpolateNoneScalar(data, phase, incr, amp + i, out + i, frames - i);
+      }
+
+static void interpolateLinearSse2(const short* data, qint64 phase, qint64 incr, const float* amp, float* out, int frames)
+      {
+      int i = 0;
+      for (; i + 4 <= frames; i += 4, phase += 4 * incr) {
+            const short* d[4];
+            const float* c[4];
+            for (int k = 0; k < 4; ++k) {
+                  d[k] = data + phaseIndex(phase + k * incr);
+                  c[k] = linearTable[tableRow(phase + k * incr)];
+                  }
+            const __m128 x0 = _mm_setr_ps(d[0][0], d[1][0], d[2][0], d[3][0]);
+            const __m128 x1 = _mm_setr_ps(d[0][1], d[1][1], d[2][1], d[3][1]);
+            const __m128 c0 = _mm_setr_ps(c[0][0], c[1][0], c[2][0], c[3][0]);
+            const __m128 c1 = _mm_setr_ps(c[0][1], c[1][1], c[2][1], c[3][1]);
+            const __m128 y  = _mm_add_ps(_mm_mul_ps(c0, x0), _mm_mul_ps(c1, x1));
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(amp + i), y));
+            }
+      interpolateLinearScalar(data, phase, incr, amp + i, out + i, frames - i);
+      }
+
+static void interpolate4thSse2(const short* data, qint64 phase, qint64 incr, const float* amp, float* out, int frames)
+      {
+      int i = 0;
+      for (; i + 4 <= frames; i += 4, phase += 4 * incr) {
+            __m128 x0 = loadPoints(data + phaseIndex(phase) - 1);
+            __m128 x1 = loadPoints(data + phaseIndex(phase + incr) - 1);
+            __m128 x2 = loadPoints(data + phaseIndex(phase + 2 * incr) - 1);
+            __m128 x3 = loadPoints(data + phaseIndex(phase + 3 * incr) - 1);
+            __m128 c0 = _mm_load_ps(cubicTable[tableRow(phase)]);
+            __m128 c1 = _mm_load_ps(cubicTable[tableRow(phase + incr)]);
+            __m128 c2 = _mm_load_ps(cubicTable[tableRow(phase + 2 * incr)]);
+            __m128 c3 = _mm_load_ps(cubicTable[tableRow(phase + 3 * incr)]);
+            _MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            __m128 y = _mm_mul_ps(c0, x0);
+            y = _mm_add_ps(y, _mm_mul_ps(c1, x1));
+            y = _mm_add_ps(y, _mm_mul_ps(c2, x2));
+            y = _mm_add_ps(y, _mm_mul_ps(c3, x3));
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(amp + i), y));
+            }
+      interpolate4thScalar(data, phase, incr, amp + i, out + i, frames - i);
+      }
+
+static void interpolate7thSse2(const short* data, qint64 phase, qint64 incr, const float* amp, float* out, int frames)
+      {
+      int i = 0;
+      for (; i + 4 <= frames; i += 4, phase += 4 * incr) {
+            __m128 lo[4], hi[4], clo[4], chi[4];
+            for (int k = 0; k < 4; ++k) {
+                  // points -4 .. 3 around the index, coefficients 0, c0 .. c6
+                  const short* d = data + phaseIndex(phase + k * incr) - 4;
+                  const float* c = sincTable[tableRow(phase + k * incr)];
+                  lo[k]  = loadPoints(d);
+                  hi[k]  = loadPoints(d + 4);
+                  clo[k] = _mm_load_ps(c);
+                  chi[k] = _mm_load_ps(c + 4);
+                  }
+            _MM_TRANSPOSE4_PS(lo[0], lo[1], lo[2], lo[3]);
+            _MM_TRANSPOSE4_PS(hi[0], hi[1], hi[2], hi[3]);
+            _MM_TRANSPOSE4_PS(clo[0], clo[1], clo[2], clo[3]);
+            _MM_TRANSPOSE4_PS(chi[0], chi[1], chi[2], chi[3]);
+            __m128 y = _mm_mul_ps(clo[1], lo[1]);
+            y = _mm_add_ps(y, _mm_mul_ps(clo[2], lo[2]));
+            y = _mm_add_ps(y, _mm_mul_ps(clo[3], lo[3]));
+            for (int k = 0; k < 4; ++k)
+                  y = _mm_add_ps(y, _mm_mul_ps(chi[k], hi[k]));
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(amp + i), y));
+            }
+      interpolate7thScalar(data, phase, incr, amp + i, out + i, frames - i);
+      }
+
+static void mixSse2(const float* in, int frames, float ampLeft, float ampRight, float ampReverb, float ampChorus,
+   float* out, float* reverb, float* chorus)
+      {
+      const __m128 pan = _mm_setr_ps(ampLeft, ampRight, ampLeft, ampRight);
+      const __m128 rev = _mm_set1_ps(ampReverb);
+      const __m128 cho = _mm_set1_ps(ampChorus);
+      int i = 0;
+      for (; i + 4 <= frames; i += 4) {
+            const __m128 v = _mm_loadu_ps(in + i);
+            const __m128 vv[2] = { _mm_mul_ps(_mm_unpacklo_ps(v, v), pan), _mm_mul_ps(_mm_unpackhi_ps(v, v), pan) };
+            for (int k = 0; k < 2; ++k) {
+                  float* o = out + 2 * i + 4 * k;
+                  float* r = reverb + 2 * i + 4 * k;
+                  float* c = chorus + 2 * i + 4 * k;
+                  _mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), vv[k]));
+                  _mm_storeu_ps(r, _mm_add_ps(_mm_loadu_ps(r), _mm_mul_ps(vv[k], rev)));
+                  _mm_storeu_ps(c, _mm_add_ps(_mm_loadu_ps(c), _mm_mul_ps(vv[k], cho)));
+                  }
+            }
+      mixScalar(in + i, frames - i, ampLeft, ampRight, ampReverb, ampChorus, out + 2 * i, reverb + 2 * i, chorus + 2 * i);
+      }
+
+static const DspKernels sse2Kernels = {
+      "SSE2",
+      { interpolateNoneSse2, interpolateLinearSse2, interpolate4thSse2, interpolate7thSse2 },
+      mixSse2
+      };
+#endif
+
+#ifdef FLUID_HAVE_AVX2
+//---------------------------------------------------------
+//   AVX2 kernels
+//    eight output samples per iteration, points and
+//    coefficients are gathered
+//---------------------------------------------------------
+
+FLUID_TARGET_AVX2 static inline __m256i phaseIndices(qint64 phase, qint64 incr, __m256i* rows)
+      {
+      alignas(32) int idx[8];
+      alignas(32) int row[8];
+      for (int k = 0; k < 8; ++k, phase += incr) {
+            idx[k] = phaseIndex(phase);
+            row[k] = tableRow(phase);
+            }
+      *rows = _mm256_load_si256(reinterpret_cast<const __m256i*>(row));
+      return _mm256_load_si256(reinterpret_cast<const __m256i*>(idx));
+      }
+
+// the points at idx + offset; reads one short more
+FLUID_TARGET_AVX2 static inline __m256 gatherPoints(const short* data, __m256i idx, int offset)
+      {
+      const __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(data), _mm256_add_epi32(idx, _mm256_set1_epi32(offset)), 2);
+      return _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16));
+      }
+
+FLUID_TARGET_AVX2 static void interpolate4thAvx2(const short* data, qint64 phase, qint64 incr, const float* amp, float* out, int frames)
+      {
+      int i = 0;
+      for (; i + 8 <= frames; i += 8, phase += 8 * incr) {
+            __m256i rows;
+            const __m256i idx  = phaseIndices(phase, incr, &rows);
+            const __m256i rows4 = _mm256_slli_epi32(rows, 2);
+            __m256 y = _mm256_mul_ps(_mm256_i32gather_ps(&cubicTable[0][0], rows4, 4), gatherPoints(data, idx, -1));
+            for (int k = 1; k < 4; ++k)
+                  y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_i32gather_ps(&cubicTable[0][k], rows4, 4), gatherPoints(data, idx, k - 1)));
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(amp + i), y));
+            }
+      interpolate4thScalar(data, phase, incr, amp + i, out + i, frames - i);
+      }
+
+FLUID_TARGET_AVX2 static void interpolate7thAvx2(const short* data, qint64 phase, qint64 incr, const float* amp, float* out, int frames)
+      {
+      int i = 0;
+      for (; i + 8 <= frames; i += 8, phase += 8 * incr) {
+            __m256i rows;
+            const __m256i idx  = phaseIndices(phase, incr, &rows);
+            const __m256i rows8 = _mm256_slli_epi32(rows, 3);
+            __m256 y = _mm256_mul_ps(_mm256_i32gather_ps(&sincTable[0][1], rows8, 4), gatherPoints(data, idx, -3));
+            for (int k = 1; k < 7; ++k)
+                  y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_i32gather_ps(&sincTable[0][k + 1], rows8, 4), gatherPoints(data, idx, k - 3)));
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(amp + i), y));
+            }
+      interpolate7thScalar(data, phase, incr, amp + i, out + i, frames - i);
+      }
+
+FLUID_TARGET_AVX2 static void mixAvx2(const float* in, int frames, float ampLeft, float ampRight, float ampReverb, float ampChorus,
+   float* out, float* reverb, float* chorus)
+      {
+      const __m256 pan = _mm256_setr_ps(ampLeft, ampRight, ampLeft, ampRight, ampLeft, ampRight, ampLeft, ampRight);
+      const __m256 rev = _mm256_set1_ps(ampReverb);
+      const __m256 cho = _mm256_set1_ps(ampChorus);
+      int i = 0;
+      for (; i + 8 <= frames; i += 8) {
+            const __m256 v  = _mm256_loadu_ps(in + i);
+            const __m256 lo = _mm256_unpacklo_ps(v, v);     // 0 0 1 1 | 4 4 5 5
+            const __m256 hi = _mm256_unpackhi_ps(v, v);     // 2 2 3 3 | 6 6 7 7
+            const __m256 vv[2] = {
+                  _mm256_mul_ps(_mm256_permute2f128_ps(lo, hi, 0x20), pan),
+                  _mm256_mul_ps(_mm256_permute2f128_ps(lo, hi, 0x31), pan)
+                  };
+            for (int k = 0; k < 2; ++k) {
+                  float* o = out + 2 * i + 8 * k;
+                  float* r = reverb + 2 * i + 8 * k;
+                  float* c = chorus + 2 * i + 8 * k;
+                  _mm256_storeu_ps(o, _mm256_add_ps(_mm256_loadu_ps(o), vv[k]));
+                  _mm256_storeu_ps(r, _mm256_add_ps(_mm256_loadu_ps(r), _mm256_mul_ps(vv[k], rev)));
+                  _mm256_storeu_ps(c, _mm256_add_ps(_mm256_loadu_ps(c), _mm256_mul_ps(vv[k], cho)));
+                  }
+            }
+      mixScalar(in + i, frames - i, ampLeft, ampRight, ampReverb, ampChorus, out + 2 * i, reverb + 2 * i, chorus + 2 * i);
+      }
+
+#ifdef FLUID_HAVE_SSE2
+static const DspKernels avx2Kernels = {
+      "AVX2",
+      { interpolateNoneSse2, interpolateLinearSse2, interpolate4thAvx2, interpolate7thAvx2 },
+      mixAvx2
+      };
+#else
+static const DspKernels avx2Kernels = {
+      "AVX2",
+      { interpolateNoneScalar, interpolateLinearScalar, interpolate4thAvx2, interpolate7thAvx2 },
+      mixAvx2
+      };
+#endif
+
+//---------------------------------------------------------
+//   cpuHasAvx2
+//---------------------------------------------------------
+
+static bool cpuHasAvx2()
+      {
+#if defined(_MSC_VER)
+      int info[4];
+      __cpuid(info, 0);
+      if (info[0] < 7)
+            return false;
+      __cpuid(info, 1);
+      const bool osxsave = info[2] & (1 << 27);
+      const bool avx     = info[2] & (1 << 28);
+      if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+            return false;
+      __cpuidex(info, 7, 0);
+      return info[1] & (1 << 5);
+#else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+#endif
+      }
+#endif
+
+//---------------------------------------------------------
+//   supportedDspKernels
+//    the variants this CPU can run, the scalar one first
+//    and the fastest last
+//---------------------------------------------------------
+
+std::vector<const DspKernels*> supportedDspKernels()
+      {
+      std::vector<const DspKernels*> kernels { &scalarKernels };
+#ifdef FLUID_HAVE_SSE2
+      kernels.push_back(&sse2Kernels);
+#endif
+#ifdef FLUID_HAVE_AVX2
+      if (cpuHasAvx2())
+            kernels.push_back(&avx2Kernels);
+#endif
+      return kernels;
+      }
+
+static const DspKernels* forcedKernels = nullptr;
+
+//---------------------------------------------------------
+//   dspKernels
+//    the fastest variant, unless set by setDspKernels()
+//---------------------------------------------------------
+
+const DspKernels& dspKernels()
+      {
+      static const DspKernels* best = supportedDspKernels().back();
+      return forcedKernels ? *forcedKernels : *best;
+      }
+
+//---------------------------------------------------------
+//   setDspKernels
+//    for tests and benchmarks; nullptr selects the
+//    fastest variant again
+//---------------------------------------------------------
+
+void setDspKernels(const DspKernels* kernels)
+      {
+      forcedKernels = kernels;
+      }
+
+} // namespace FluidS
@@ -0,0 +1,69 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __FLUID_DSPKERNELS_H__
+#define __FLUID_DSPKERNELS_H__
+
+#include <vector>
+
+namespace FluidS {
+
+enum DspInterp {
+      DSP_INTERP_NONE,
+      DSP_INTERP_LINEAR,
+      DSP_INTERP_4TH,
+      DSP_INTERP_7TH,
+      DSP_INTERP_COUNT
+      };
+
+//---------------------------------------------------------
+//   InterpolateFn
+//    out[i] = amp[i] * the sample data interpolated at
+//    phase + i * incr (32.32 fixed point, see Phase) for
+//    i < frames. The caller guarantees that data can be
+//    read from index - 4 to index + 4 of every phase.
+//    The 7th order kernel expects the phase shifted by
+//    half a sample, like the voice uses it.
+//---------------------------------------------------------
+
+typedef void (*InterpolateFn)(const short* data, qint64 phase, qint64 incr, const float* amp, float* out, int frames);
+
+//---------------------------------------------------------
+//   MixFn
+//    mix frames mono samples into the interleaved stereo
+//    out, reverb and chorus buses
+//---------------------------------------------------------
+
+typedef void (*MixFn)(const float* in, int frames, float ampLeft, float ampRight, float ampReverb, float ampChorus,
+   float* out, float* reverb, float* chorus);
+
+//---------------------------------------------------------
+//   DspKernels
+//    Interpolation and mixing loops of a voice for one
+//    instruction set. All variants compute the same
+//    operations in the same order as the scalar one, so
+//    their results are identical.
+//---------------------------------------------------------
+
+struct DspKernels {
+      const char* name;
+      InterpolateFn interpolate[DSP_INTERP_COUNT];
+      MixFn mix;
+      };
+
+extern void initDspKernels(const float linear[][2], const float cubic[][4], const float sinc7[][7]);
+extern const DspKernels& dspKernels();
+extern void setDspKernels(const DspKernels*);
+extern std::vector<const DspKernels*> supportedDspKernels();
+
+} // namespace FluidS
+#endif
@@ -109,6 +109,8 @@ Fluid::~Fluid()
       {
       _state = FLUID_SYNTH_STOPPED;
       _globalTerminate = true;
+      _loadPool.clear();
+      _loadPool.waitForDone();
       while (!mutex.tryLock()) {}
       qDeleteAll(activeVoices);
       qDeleteAll(freeVoices);
@@ -344,6 +346,17 @@ Preset* Fluid::find_preset(unsigned banknum, unsigned prognum)
       return 0;
       }
 
+//---------------------------------------------------------
+//   prefetch
+//---------------------------------------------------------
+
+void Fluid::prefetch(int bank, int program)
+      {
+      Preset* preset = find_preset(bank, program);
+      if (preset)
+            preset->loadSamplesAsync();
+      }
+
 //---------------------------------------------------------
 //   program_change
 //---------------------------------------------------------
@@ -680,12 +693,10 @@ bool Fluid::loadSoundFonts(const QStringList& sl)
                   ok = false;
                   }
             else {
-                  locker.relock();
                   if (sfload(path) == -1) {
                         qDebug("loading sf failed: <%s>", qPrintable(path));
                         ok = false;
                         }
-                  locker.unlock();
                   }
             }
       return ok;
@@ -698,7 +709,6 @@ bool Fluid::loadSoundFonts(const QStringList& sl)
 
 bool Fluid::addSoundFont(const QString& s)
       {
-      QMutexLocker locker(&mutex);
       bool rv = (sfload(s) == -1) ? false : true;
       return rv;
       }
@@ -723,6 +733,8 @@ bool Fluid::removeSoundFont(const QString& s)
 
 //---------------------------------------------------------
 //   sfload
+//    the file is read without holding the mutex, so
+//    process() keeps running while a soundfont loads
 //---------------------------------------------------------
 
 int Fluid::sfload(const QString& filename)
@@ -744,6 +756,7 @@ int Fluid::sfload(const QString& filename)
             return -1;
             }
 
+      QMutexLocker locker(&mutex);
       sf->setId(++sfont_id);
 
       /* insert the sfont as the first one on the list */
@@ -771,6 +784,7 @@ bool Fluid::sfunload(int id)
       sfonts.removeAll(sf);   // remove the SoundFont from the list
       updatePatchList();
 
+      _loadPool.waitForDone();  // samples of sf may still be loading
       delete sf;
       return true;
       }
@@ -22,6 +22,7 @@
 #ifndef __FLUID_S_H__
 #define __FLUID_S_H__
 
+#include <atomic>
 #include "synthesizer/synthesizer.h"
 #include "synthesizer/midipatch.h"
 
@@ -312,14 +313,17 @@ class Fluid : public Synthesizer {
       float _masterTuning;                // usually 440.0
       double _tuning[128];                // the pitch of every key, in cents
 
-      int _loadProgress = 0;
+      std::atomic<int> _loadProgress { 0 };
       bool _loadWasCanceled = false;
 
       QMutex mutex;
       void updatePatchList();
 
       //the variable is used to stop loading samples from the sf files
-      bool _globalTerminate = false;
+      std::atomic<bool> _globalTerminate { false };
+
+      QThreadPool _loadPool;              // decodes samples
+      bool _asyncSampleLoading = false;   // program changes do not wait for samples
 
    protected:
       int _state;                         // the synthesizer state
@@ -352,6 +356,7 @@ class Fluid : public Synthesizer {
 
       virtual void allSoundsOff(int);
       virtual void allNotesOff(int);
+      virtual void prefetch(int bank, int program);
 
       int loadProgress()            { return _loadProgress; }
       void setLoadProgress(int val) { _loadProgress = val; }
@@ -424,6 +429,10 @@ class Fluid : public Synthesizer {
       bool globalTerminate() { return _globalTerminate; }
       void setGlobalTerminate(bool terminate = true) { _globalTerminate = terminate; }
 
+      bool asyncSampleLoading() const          { return _asyncSampleLoading; }
+      void setAsyncSampleLoading(bool val)     { _asyncSampleLoading = val;  }
+      void waitForSamples()                    { _loadPool.waitForDone();    }
+
       friend class Voice;
       friend class Preset;
       };
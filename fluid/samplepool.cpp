@@ -0,0 +1,236 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "config.h"
+#include "samplepool.h"
+
+namespace FluidS {
+
+//---------------------------------------------------------
+//   ~MappedFile
+//---------------------------------------------------------
+
+MappedFile::~MappedFile()
+      {
+      if (data)
+            file.unmap(const_cast<uchar*>(data));
+      }
+
+//---------------------------------------------------------
+//   instance
+//---------------------------------------------------------
+
+SamplePool* SamplePool::instance()
+      {
+      static SamplePool pool;
+      return &pool;
+      }
+
+//---------------------------------------------------------
+//   fileKey
+//    a replaced soundfont file gets a new key
+//---------------------------------------------------------
+
+QString SamplePool::fileKey(const QString& path)
+      {
+      QFileInfo fi(path);
+      return QString("%1:%2:%3").arg(fi.canonicalFilePath()).arg(fi.size()).arg(fi.lastModified().toMSecsSinceEpoch());
+      }
+
+//---------------------------------------------------------
+//   mapFile
+//    map path, or share the mapping of another user;
+//    called with _mutex locked
+//---------------------------------------------------------
+
+std::shared_ptr<MappedFile> SamplePool::mapFile(const QString& path, QString* key)
+      {
+      *key = fileKey(path);
+      std::shared_ptr<MappedFile> mf = _files.value(*key).lock();
+      if (mf)
+            return mf;
+      mf = std::make_shared<MappedFile>();
+      mf->file.setFileName(path);
+      if (!mf->file.open(QIODevice::ReadOnly)) {
+            qDebug("SamplePool: cannot open <%s>", qPrintable(path));
+            return nullptr;
+            }
+      mf->size = mf->file.size();
+      mf->data = mf->file.map(0, mf->size);
+      if (!mf->data) {
+            qDebug("SamplePool: cannot map <%s>", qPrintable(path));
+            return nullptr;
+            }
+      _files.insert(*key, mf);
+      return mf;
+      }
+
+//---------------------------------------------------------
+//   pcm
+//    frames 16 bit little endian samples at byte offset
+//---------------------------------------------------------
+
+SampleBufferPtr SamplePool::pcm(const QString& path, qint64 offset, unsigned frames)
+      {
+      QString key;
+      std::shared_ptr<MappedFile> mf;
+      {
+      QMutexLocker locker(&_mutex);
+      mf = mapFile(path, &key);
+      }
+      if (!mf || offset < 0 || offset + qint64(frames) * qint64(sizeof(short)) > mf->size)
+            return nullptr;
+
+      std::shared_ptr<SampleBuffer> sb = std::make_shared<SampleBuffer>();
+      sb->frames = frames;
+      const uchar* src = mf->data + offset;
+      if (QSysInfo::ByteOrder == QSysInfo::LittleEndian && (quintptr(src) % alignof(short)) == 0) {
+            sb->data = reinterpret_cast<const short*>(src);
+            sb->file = mf;
+            }
+      else {
+            sb->decoded.resize(frames);
+            for (unsigned i = 0; i < frames; ++i)
+                  sb->decoded[i] = short(src[2 * i] | (src[2 * i + 1] << 8));
+            sb->data = sb->decoded.data();
+            }
+      return sb;
+      }
+
+#ifdef SOUNDFONT3
+//---------------------------------------------------------
+//   oggVorbis
+//    the decoded sample stored as size bytes at offset
+//---------------------------------------------------------
+
+SampleBufferPtr SamplePool::oggVorbis(const QString& path, qint64 offset, unsigned size)
+      {
+      QString key;
+      std::shared_ptr<MappedFile> mf;
+      {
+      QMutexLocker locker(&_mutex);
+      mf = mapFile(path, &key);
+      if (!mf)
+            return nullptr;
+      key += QString("@%1").arg(offset);
+      auto i = _samples.find(key);
+      if (i != _samples.end()) {
+            i->lastUse = ++_clock;
+            ++_hits;
+            return i->buffer;
+            }
+      ++_misses;
+      }
+      if (offset < 0 || offset + qint64(size) > mf->size)
+            return nullptr;
+
+      // decode without holding the lock
+      std::shared_ptr<SampleBuffer> sb = std::make_shared<SampleBuffer>();
+      if (!decodeOggVorbis(reinterpret_cast<const char*>(mf->data + offset), size, sb->decoded))
+            return nullptr;
+      sb->data   = sb->decoded.data();
+      sb->frames = unsigned(sb->decoded.size());
+
+      QMutexLocker locker(&_mutex);
+      auto i = _samples.find(key);
+      if (i != _samples.end()) {                // decoded by another thread meanwhile
+            i->lastUse = ++_clock;
+            return i->buffer;
+            }
+      _samples.insert(key, { sb, ++_clock });
+      _decodedBytes += qint64(sb->decoded.size() * sizeof(short));
+      trim();
+      return sb;
+      }
+#endif
+
+//---------------------------------------------------------
+//   trim
+//    evict unused samples, least recently used first,
+//    until the decoded data fits into the budget;
+//    called with _mutex locked
+//---------------------------------------------------------
+
+void SamplePool::trim()
+      {
+      if (_decodedBytes <= _budget)
+            return;
+      std::vector<std::pair<quint64, QString>> unused;
+      for (auto i = _samples.cbegin(); i != _samples.cend(); ++i) {
+            // only the pool holds it; new references are handed out with _mutex locked
+            if (i->buffer.use_count() == 1)
+                  unused.push_back({ i->lastUse, i.key() });
+            }
+      std::sort(unused.begin(), unused.end());
+      for (const auto& u : unused) {
+            if (_decodedBytes <= _budget)
+                  break;
+            Entry e = _samples.take(u.second);
+            _decodedBytes -= qint64(e.buffer->decoded.size() * sizeof(short));
+            }
+      }
+
+//---------------------------------------------------------
+//   setBudget
+//---------------------------------------------------------
+
+void SamplePool::setBudget(qint64 bytes)
+      {
+      QMutexLocker locker(&_mutex);
+      _budget = bytes;
+      trim();
+      }
+
+qint64 SamplePool::budget() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _budget;
+      }
+
+//---------------------------------------------------------
+//   decodedBytes
+//    memory used by cached decoded samples
+//---------------------------------------------------------
+
+qint64 SamplePool::decodedBytes() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _decodedBytes;
+      }
+
+int SamplePool::hits() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _hits;
+      }
+
+int SamplePool::misses() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _misses;
+      }
+
+//---------------------------------------------------------
+//   clear
+//    drop all cached samples; samples in use stay valid
+//---------------------------------------------------------
+
+void SamplePool::clear()
+      {
+      QMutexLocker locker(&_mutex);
+      _samples.clear();
+      _decodedBytes = 0;
+      _hits   = 0;
+      _misses = 0;
+      }
+
+} // namespace FluidS
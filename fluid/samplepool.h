@@ -0,0 +1,98 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __FLUID_SAMPLEPOOL_H__
+#define __FLUID_SAMPLEPOOL_H__
+
+#include <memory>
+
+namespace FluidS {
+
+//---------------------------------------------------------
+//   MappedFile
+//    a soundfont file mapped into memory
+//---------------------------------------------------------
+
+struct MappedFile {
+      QFile file;
+      const uchar* data { nullptr };
+      qint64 size       { 0 };
+
+      ~MappedFile();
+      };
+
+//---------------------------------------------------------
+//   SampleBuffer
+//    16 bit sample data, either pointing into a mapped
+//    file or owning decoded data
+//---------------------------------------------------------
+
+struct SampleBuffer {
+      const short* data { nullptr };
+      unsigned frames   { 0 };
+      std::vector<short> decoded;
+      std::shared_ptr<MappedFile> file;   // keeps data valid for mapped samples
+      };
+
+typedef std::shared_ptr<const SampleBuffer> SampleBufferPtr;
+
+//---------------------------------------------------------
+//   SamplePool
+//    Process-wide store for soundfont sample data shared
+//    by all Fluid instances.
+//    Each soundfont file is mapped once; SF2 samples are
+//    served from the mapping without a copy. Decoded SF3
+//    samples are cached. Cached samples no Sample uses
+//    any more are evicted in LRU order when the decoded
+//    data exceeds the memory budget.
+//    Thread safe.
+//---------------------------------------------------------
+
+class SamplePool {
+      struct Entry {
+            std::shared_ptr<SampleBuffer> buffer;
+            quint64 lastUse;
+            };
+
+      mutable QMutex _mutex;
+      QHash<QString, std::weak_ptr<MappedFile>> _files;     // by fileKey()
+      QHash<QString, Entry> _samples;                       // decoded samples
+      qint64 _budget       { 512 * 1024 * 1024 };
+      qint64 _decodedBytes { 0 };
+      quint64 _clock       { 0 };
+      int _hits            { 0 };
+      int _misses          { 0 };
+
+      SamplePool() {}
+      static QString fileKey(const QString& path);
+      std::shared_ptr<MappedFile> mapFile(const QString& path, QString* key);
+      void trim();
+
+   public:
+      static SamplePool* instance();
+
+      SampleBufferPtr pcm(const QString& path, qint64 offset, unsigned frames);
+#ifdef SOUNDFONT3
+      SampleBufferPtr oggVorbis(const QString& path, qint64 offset, unsigned size);
+      static bool decodeOggVorbis(const char* src, int size, std::vector<short>& data);
+#endif
+
+      void setBudget(qint64 bytes);
+      qint64 budget() const;
+      qint64 decodedBytes() const;
+      int hits() const;
+      int misses() const;
+      void clear();
+      };
+
+} // namespace FluidS
+#endif
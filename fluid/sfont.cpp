@@ -24,6 +24,7 @@
 #include "sfont.h"
 #include "fluid.h"
 #include "voice.h"
+#include "samplepool.h"
 
 // #define DEBUG_SFONT
 
@@ -136,46 +137,74 @@ Preset::~Preset()
             delete z;
       }
 
+//---------------------------------------------------------
+//   pendingSamples
+//    the distinct samples of all instruments of this
+//    preset which are not loaded yet
+//---------------------------------------------------------
+
+QList<Sample*> Preset::pendingSamples() const
+      {
+      QSet<Sample*> samples;
+      auto addInstrument = [&samples](Instrument* i) {
+            if (i->global_zone && i->global_zone->sample)
+                  samples.insert(i->global_zone->sample);
+            for (Zone* iz : i->zones) {
+                  if (iz->sample)
+                        samples.insert(iz->sample);
+                  }
+            };
+      if (_global_zone && _global_zone->instrument)
+            addInstrument(_global_zone->instrument);
+      for (Zone* z : zones)
+            addInstrument(z->instrument);
+
+      QList<Sample*> pending;
+      for (Sample* sample : samples) {
+            if (sample->valid() && !sample->loaded())
+                  pending.append(sample);
+            }
+      return pending;
+      }
+
 //---------------------------------------------------------
 //   loadSamples
 //    this is called if the preset is associated with a
-//    channel
+//    channel; the samples are decoded in parallel
 //---------------------------------------------------------
 
 void Preset::loadSamples()
       {
-      bool locked = sfont->synth->mutex.tryLock();
-
-      if (_global_zone && _global_zone->instrument) {
-            Instrument* i = _global_zone->instrument;
-            if (i->global_zone && i->global_zone->sample)
-                  i->global_zone->sample->load();
-
-            for (Zone* iz : i->zones)
-                  iz->sample->load();
+      Fluid* synth = sfont->synth;
+      QList<QFuture<void>> jobs;
+      for (Sample* sample : pendingSamples()) {
+            jobs.append(QtConcurrent::run(&synth->_loadPool, [synth, sample]() {
+                  if (!synth->globalTerminate())
+                        sample->load();
+                  }));
             }
+      synth->setLoadProgress(0);
+      for (int i = 0; i < jobs.size(); ++i) {
+            jobs[i].waitForFinished();
+            synth->setLoadProgress((i + 1) * 100 / jobs.size());
+            }
+      }
 
-      int currentInstrZone = 0;
-      float instrSize = (float)zones.size(); //float is used to properly calculate progress
-      for (Zone* z : zones) {
-            sfont->synth->setLoadProgress(currentInstrZone++ / instrSize * 100);
-            Instrument* i = z->instrument;
-            if (i->global_zone && i->global_zone->sample)
-                  i->global_zone->sample->load();
-
-            for (Zone* iz : i->zones) {
-                  if (sfont->synth->globalTerminate()) {
-                        if (locked)
-                              sfont->synth->mutex.unlock();
-                        return;
-                  }
+//---------------------------------------------------------
+//   loadSamplesAsync
+//    queue the samples for decoding and return at once;
+//    voices stay silent until their sample is loaded
+//---------------------------------------------------------
 
-                  iz->sample->load();
-                  }
+void Preset::loadSamplesAsync()
+      {
+      Fluid* synth = sfont->synth;
+      for (Sample* sample : pendingSamples()) {
+            QtConcurrent::run(&synth->_loadPool, [synth, sample]() {
+                  if (!synth->globalTerminate())
+                        sample->load();
+                  });
             }
-
-      if (locked)
-            sfont->synth->mutex.unlock();
       }
 
 //---------------------------------------------------------
@@ -202,7 +231,7 @@ bool Preset::noteon(Fluid* synth, unsigned id, int chan, int key, int vel, doubl
                   for(Zone* inst_zone : inst->get_zone()) {
                         /* make sure this instrument zone has a valid sample */
                         Sample* sample = inst_zone->get_sample();
-                        if (sample == 0 || sample->inRom())
+                        if (sample == 0 || sample->inRom() || !sample->ready())
                               continue;
                         /* check if the note falls into the key and velocity range of this
                            instrument */
@@ -618,7 +647,6 @@ Sample::Sample(SFont* s)
 
 Sample::~Sample()
       {
-      delete[] data;
       }
 
 //---------------------------------------------------------
@@ -627,57 +655,38 @@ Sample::~Sample()
 
 void Sample::load()
       {
-      if (!_valid || data)
+      if (!_valid)
             return;
-      QFile fd(sf->get_name());
-      if (!fd.open(QIODevice::ReadOnly))
+      int state = UNLOADED;
+      if (!_state.compare_exchange_strong(state, LOADING)) {
+            // loaded, or being loaded by another thread
+            while (_state == LOADING)
+                  QThread::yieldCurrentThread();
             return;
-      if (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) {
-            if (!fd.seek(sf->samplePos() + start))
-                  return;
-            }
-      else {
-            if (!fd.seek(sf->samplePos() + start * sizeof(short)))
-                  return;
             }
       unsigned int size = end - start;
+      bool ok = false;
 
       if (sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) {
 #ifdef SOUNDFONT3
-            std::vector<char> p;
-            p.resize(size);
-            if (fd.read(p.data(), size) != size) {
-                  qDebug("read %d failed", size);
-                  return;
-                  }
-            decompressOggVorbis(p.data(), size);
+            ok = decompressOggVorbis(size);
 #endif
             }
       else {
-            data = new short[size];
-            size *= sizeof(short);
-
-            if (fd.read((char*)data, size) != size)
-                  return;
-
-            if (QSysInfo::ByteOrder == QSysInfo::BigEndian) {
-                  unsigned char hi, lo;
-                  unsigned int i, j;
-                  short s;
-                  uchar* cbuf = (uchar*) data;
-                  for (i = 0, j = 0; j < size; i++) {
-                        lo = cbuf[j++];
-                        hi = cbuf[j++];
-                        s = (hi << 8) | lo;
-                        data[i] = s;
-                        }
+            _buffer = SamplePool::instance()->pcm(sf->get_name(), sf->samplePos() + start * sizeof(short), size);
+            if (_buffer) {
+                  data = _buffer->data;
+                  end       -= (start + 1);       // marks last sample, contrary to SF spec.
+                  loopstart -= start;
+                  loopend   -= start;
+                  start      = 0;
+                  ok = true;
                   }
-            end       -= (start + 1);       // marks last sample, contrary to SF spec.
-            loopstart -= start;
-            loopend   -= start;
-            start      = 0;
             }
-      optimize();
+      if (ok)
+            optimize();
+      // a failed sample is not retried, it has no data and stays silent
+      _state = LOADED;
       }
 
 //---------------------------------------------------------
@@ -25,6 +25,7 @@
 
 #include "config.h"
 #include "fluid.h"
+#include "samplepool.h"
 
 namespace FluidS {
 
@@ -130,7 +131,11 @@ class SFont {
 //---------------------------------------------------------
 
 class Sample {
+      enum { UNLOADED, LOADING, LOADED };
+
       bool _valid;
+      SampleBufferPtr _buffer;      // owner of data, shared through the SamplePool
+      std::atomic<int> _state { UNLOADED };
 
    public:
       SFont* sf;
@@ -143,7 +148,7 @@ class Sample {
       int pitchadj;
       int sampletype;
 
-      short* data;
+      const short* data;
 
       /** The amplitude, that will lower the level of the sample's loop to
           the noise floor. Needed for note turnoff optimization, will be
@@ -159,10 +164,12 @@ class Sample {
       bool inRom() const;
       void optimize();
       void load();
+      bool loaded() const   { return _state == LOADED; }
+      bool ready() const    { return _state == LOADED && data; }
       bool valid() const    { return _valid; }
       void setValid(bool v) { _valid = v; }
 #ifdef SOUNDFONT3
-      bool decompressOggVorbis(char* p, int size);
+      bool decompressOggVorbis(int size);
 #endif
       };
 
@@ -239,7 +246,9 @@ class Preset {
       bool importSfont();
 
       Zone* global_zone()                       { return _global_zone; }
+      QList<Sample*> pendingSamples() const;
       void loadSamples();
+      void loadSamplesAsync();
       QList<Zone*> getZones()                   { return zones; }
       };
 
@@ -2,33 +2,50 @@
 #include <stdlib.h>
 #include <math.h>
 #include "sfont.h"
+#include "samplepool.h"
 #include "audiofile/audiofile.h"
 
 namespace FluidS {
 
 //---------------------------------------------------------
-//   decompressOggVorbis
+//   decodeOggVorbis
 //---------------------------------------------------------
 
-bool Sample::decompressOggVorbis(char* src, int size)
+bool SamplePool::decodeOggVorbis(const char* src, int size, std::vector<short>& data)
       {
       AudioFile af;
-      QByteArray ba(src, size);
+      QByteArray ba = QByteArray::fromRawData(src, size);
 
-      start = 0;
-      end   = 0;
       if (!af.open(ba)) {
-            qDebug("Sample::decompressOggVorbis: open failed: %s", af.error());
+            qDebug("SamplePool::decodeOggVorbis: open failed: %s", af.error());
             return false;
             }
       int frames = af.frames();
-      data = new short[frames * af.channels()];
-      if (frames != af.readData(data, frames)) {
+      data.resize(frames * af.channels());
+      if (frames != af.readData(data.data(), frames)) {
             qDebug("Sample read failed: %s", af.error());
-            delete[] data;
-            data = 0;
+            data.clear();
+            return false;
             }
-      end = frames - 1;
+      return true;
+      }
+
+//---------------------------------------------------------
+//   decompressOggVorbis
+//    get the decoded sample from the pool, size bytes at
+//    start
+//---------------------------------------------------------
+
+bool Sample::decompressOggVorbis(int size)
+      {
+      _buffer = SamplePool::instance()->oggVorbis(sf->get_name(), sf->samplePos() + start, size);
+
+      start = 0;
+      end   = 0;
+      if (!_buffer)
+            return false;
+      data = _buffer->data;
+      end  = _buffer->frames - 1;
 
       if (loopend > end ||loopstart >= loopend || loopstart <= start) {
             /* can pad loop by 8 samples and ensure at least 4 for loop (2*8+4) */
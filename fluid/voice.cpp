@@ -23,6 +23,7 @@
 #include "sfont.h"
 #include "gen.h"
 #include "voice.h"
+#include "dspkernels.h"
 
 namespace FluidS {
 
@@ -1890,17 +1891,6 @@ void Voice::effects(int startBufIdx, int count, float* out, float* reverb, float
                         b02 += b02_incr;
                         b1  += b1_incr;
                         }
-
-                  //code duplication is needed to optimize using std::vector::operator[]
-                  float vv = dspValRef * amp_left;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
-
-                  vv = dspValRef * amp_right;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
                   }
             }
       else { /* The filter parameters are constant.  This is duplicated to save time. */
@@ -1910,19 +1900,11 @@ void Voice::effects(int startBufIdx, int count, float* out, float* reverb, float
                   dspValRef      = b02 * (dsp_centernode + hist2) + b1 * hist1;
                   hist2          = hist1;
                   hist1          = dsp_centernode;
-
-                  //code duplication is needed to optimize using std::vector::operator[]
-                  float vv = dspValRef * amp_left;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
-
-                  vv = dspValRef * amp_right;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
                   }
             }
+
+      /* mix into the output, reverb and chorus buses */
+      dspKernels().mix(dsp_buf.data() + startBufIdx, count, amp_left, amp_right, amp_reverb, amp_chorus, out, reverb, chorus);
       }
 }
 
@@ -264,6 +264,8 @@ public:
 
       static void dsp_float_config();
       bool updateAmpInc(unsigned int &nextNewAmpInc, std::map<int, qreal>::iterator &curSample2AmpInc, qreal &dsp_amp_incr, unsigned int &dsp_i);
+      unsigned interpolateRun(int kind, Phase& dsp_phase, Phase dsp_phase_incr, unsigned dsp_i, unsigned n,
+         unsigned end_index, unsigned nextNewAmpInc, qreal dsp_amp_incr);
       int dsp_float_interpolate_none(unsigned);
       int dsp_float_interpolate_linear(unsigned);
       int dsp_float_interpolate_4th_order(unsigned);
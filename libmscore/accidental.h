@@ -70,6 +70,7 @@ class Accidental final : public Element {
       AccidentalRole _role           { AccidentalRole::AUTO    };
 
    public:
+      ELEMENT_POOL(Accidental)
       Accidental(Score* s = 0);
       virtual Accidental* clone() const override  { return new Accidental(*this); }
       virtual ElementType type() const override   { return ElementType::ACCIDENTAL; }
@@ -669,16 +669,15 @@ struct Bm {
       static int key(int a, int b, int c) { return ((a & 0xff) << 16) | ((b & 0xff) << 8) | (c & 0xff); }
       };
 
-static QHash<int, Bm> bMetrics;
-
 //---------------------------------------------------------
 //   initBeamMetrics
 //---------------------------------------------------------
 
 #define B(a,b,c,d,e) bMetrics[Bm::key(a, b, c)] = Bm(d, e);
 
-static void initBeamMetrics()
+static QHash<int, Bm> initBeamMetrics()
       {
+      QHash<int, Bm> bMetrics;
       // up  step1 step2 stemLen1 slant
       //                 (- up)   (- up)
       // =================================== C
@@ -1051,6 +1050,7 @@ static void initBeamMetrics()
       B(0, -3,  2, 18, 4);
       B(0, -3,  3, 18, 5);
       B(0, -3,  4, 21, 5);
+      return bMetrics;
       }
 
 //---------------------------------------------------------
@@ -1060,12 +1060,9 @@ static void initBeamMetrics()
 
 static Bm beamMetric1(bool up, char l1, char l2)
       {
-      static int initialized = false;
-      if (!initialized) {
-            initBeamMetrics();
-            initialized = true;
-            }
-      return bMetrics[Bm::key(up, l1, l2)];
+      // built once and only read, as scores are laid out on several threads
+      static const QHash<int, Bm> bMetrics = initBeamMetrics();
+      return bMetrics.value(Bm::key(up, l1, l2));
       }
 
 //---------------------------------------------------------
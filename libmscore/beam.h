@@ -77,6 +77,7 @@ class Beam final : public Element {
             };
       Q_ENUM(Mode);
 
+      ELEMENT_POOL(Beam)
       Beam(Score* = 0);
       Beam(const Beam&);
       ~Beam();
@@ -87,6 +87,7 @@ class Chord final : public ChordRest {
       qreal noteHeadWidth() const;
 
    public:
+      ELEMENT_POOL(Chord)
       Chord(Score* s = 0);
       Chord(const Chord&, bool link = false);
       ~Chord();
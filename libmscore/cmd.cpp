@@ -94,7 +94,7 @@ void CmdState::reset()
       _oneElement = true;
       _mb = nullptr;
       _oneMeasureBase = true;
-      _locked = false;
+      _locked = 0;
       }
 
 //---------------------------------------------------------
@@ -298,8 +298,18 @@ void Score::update(bool resetCmdState)
             CmdState& cs = ms->cmdState();
             ms->deletePostponed();
             if (cs.layoutRange()) {
-                  for (Score* s : ms->scoreList())
-                        s->doLayoutRange(cs.startTick(), cs.endTick());
+                  for (Score* s : ms->scoreList()) {
+                        // in the GUI, parts which are not shown are laid out when
+                        // their view is shown or when they are printed or exported;
+                        // the master score and layout which goes through the undo
+                        // stack have to be part of this command
+                        if (MScore::noGui || s->isMaster() || s == this || s->isShown() || s->layoutUsesUndo()) {
+                              s->setLayoutPending(cs.startTick(), cs.endTick(), cs.layoutFlags);
+                              s->doPendingLayout();
+                              }
+                        else
+                              s->deferLayout(cs.layoutFlags);
+                        }
                   updateAll = true;
                   }
             }
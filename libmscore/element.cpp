@@ -1258,6 +1258,7 @@ bool Element::setProperty(Pid propertyId, const QVariant& v)
                   qDebug("%s unknown <%s>(%d), data <%s>", name(), propertyName(propertyId), int(propertyId), qPrintable(v.toString()));
                   return false;
             }
+      setMeasureLayoutDirty();
       triggerLayout();
       return true;
       }
@@ -1275,6 +1276,7 @@ void Element::undoChangeProperty(Pid pid, const QVariant& val, PropertyFlags ps)
             undoPushProperty(Pid::OFFSET);
             }
       ScoreElement::undoChangeProperty(pid, val, ps);
+      setMeasureLayoutDirty();
       }
 
 //---------------------------------------------------------
@@ -1406,6 +1408,18 @@ const Measure* Element::findMeasure() const
       return e->findMeasure();
       }
 
+//---------------------------------------------------------
+//   setMeasureLayoutDirty
+//    the measure containing this element is laid out
+//    again by the next layout, even outside of its range
+//---------------------------------------------------------
+
+void Element::setMeasureLayoutDirty() const
+      {
+      if (Measure* m = const_cast<Element*>(this)->findMeasure())
+            m->setLayoutDirty(true);
+      }
+
 //---------------------------------------------------------
 //   findMeasureBase
 //---------------------------------------------------------
@@ -1808,8 +1822,10 @@ bool Element::isUserModified() const
 
 void Element::triggerLayout() const
       {
-      if (parent())
+      if (parent()) {
+            setMeasureLayoutDirty();
             score()->setLayout(tick(), staffIdx(), this);
+            }
       }
 
 //---------------------------------------------------------
@@ -16,6 +16,7 @@
 #include "spatium.h"
 #include "fraction.h"
 #include "scoreElement.h"
+#include "elementpool.h"
 #include "shape.h"
 
 namespace Ms {
@@ -195,6 +196,7 @@ class Element : public ScoreElement {
       const Measure* findMeasure() const;
       MeasureBase* findMeasureBase();
       const MeasureBase* findMeasureBase() const;
+      void setMeasureLayoutDirty() const;
 
       virtual bool isElement() const override { return true;        }
 
@@ -0,0 +1,321 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+
+#include "elementpool.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   registry
+//    all pools; pools are never deleted, as elements may
+//    still be freed during static destruction
+//---------------------------------------------------------
+
+static QMutex& registryMutex()
+      {
+      static QMutex mutex;
+      return mutex;
+      }
+
+static std::vector<ElementPool*>& registry()
+      {
+      static std::vector<ElementPool*>* pools = new std::vector<ElementPool*>;
+      return *pools;
+      }
+
+//---------------------------------------------------------
+//   ThreadCache
+//    the free slots a thread keeps for every pool; they
+//    go back to the pools when the thread ends
+//---------------------------------------------------------
+
+struct ThreadCache {
+      std::vector<ElementPool::ThreadList> lists;     // by pool index
+
+      ElementPool::ThreadList& list(size_t index) {
+            if (index >= lists.size())
+                  lists.resize(index + 1);
+            return lists[index];
+            }
+      ~ThreadCache();
+      };
+
+static thread_local ThreadCache threadCache;
+// set once threadCache is destroyed; elements freed after that,
+// e.g. during static destruction, go to their pool directly
+static thread_local bool threadCacheGone = false;
+
+ThreadCache::~ThreadCache()
+      {
+      std::vector<ElementPool*> pools;
+      {
+      QMutexLocker locker(&registryMutex());
+      pools = registry();
+      }
+      for (size_t i = 0; i < lists.size(); ++i) {
+            if (lists[i].count)
+                  pools[i]->release(lists[i], lists[i].count);
+            }
+      threadCacheGone = true;
+      }
+
+//---------------------------------------------------------
+//   ElementPool
+//---------------------------------------------------------
+
+ElementPool::ElementPool(const char* name, size_t objectSize)
+   : _name(name), _objectSize(objectSize),
+     _slotSize((objectSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t)),
+     _slotsPerSlab(SLAB_SIZE / _slotSize)
+      {
+      Q_ASSERT(_slotsPerSlab > 0);
+      QMutexLocker locker(&registryMutex());
+      _index = registry().size();
+      registry().push_back(this);
+      }
+
+//---------------------------------------------------------
+//   addSlab
+//    the slots go to the free list in address order
+//---------------------------------------------------------
+
+void ElementPool::addSlab()
+      {
+      char* memory = static_cast<char*>(::operator new(_slotsPerSlab * _slotSize));
+      _slabs.insert(std::lower_bound(_slabs.begin(), _slabs.end(), memory, std::less<char*>()), memory);
+      for (size_t n = _slotsPerSlab; n > 0; --n) {
+            void* slot = memory + (n - 1) * _slotSize;
+            *static_cast<void**>(slot) = _freeList;
+            _freeList = slot;
+            }
+      _freeSlots += _slotsPerSlab;
+      }
+
+//---------------------------------------------------------
+//   slabIndex
+//    the slab p was allocated from
+//---------------------------------------------------------
+
+size_t ElementPool::slabIndex(void* p) const
+      {
+      auto i = std::upper_bound(_slabs.begin(), _slabs.end(), static_cast<char*>(p), std::less<char*>());
+      Q_ASSERT(i != _slabs.begin());
+      return i - _slabs.begin() - 1;
+      }
+
+//---------------------------------------------------------
+//   fill
+//    move BATCH free slots to the list of a thread
+//---------------------------------------------------------
+
+void ElementPool::fill(ThreadList& l)
+      {
+      QMutexLocker locker(&_mutex);
+      for (size_t n = 0; n < BATCH; ++n) {
+            if (!_freeList)
+                  addSlab();
+            void* p   = _freeList;
+            _freeList = *static_cast<void**>(p);
+            *static_cast<void**>(p) = l.head;
+            l.head = p;
+            }
+      l.count    += BATCH;
+      _freeSlots -= BATCH;
+      _live      += BATCH;
+      }
+
+//---------------------------------------------------------
+//   release
+//    move n slots from the list of a thread to the pool
+//---------------------------------------------------------
+
+void ElementPool::release(ThreadList& l, size_t n)
+      {
+      QMutexLocker locker(&_mutex);
+      for (size_t i = 0; i < n; ++i) {
+            void* p = l.head;
+            l.head  = *static_cast<void**>(p);
+            *static_cast<void**>(p) = _freeList;
+            _freeList = p;
+            }
+      l.count    -= n;
+      _freeSlots += n;
+      _live      -= n;
+      }
+
+//---------------------------------------------------------
+//   flushThreadList
+//    give the free slots of the calling thread back
+//---------------------------------------------------------
+
+void ElementPool::flushThreadList()
+      {
+      if (threadCacheGone)
+            return;
+      ThreadList& l = threadCache.list(_index);
+      if (l.count)
+            release(l, l.count);
+      }
+
+//---------------------------------------------------------
+//   alloc
+//---------------------------------------------------------
+
+void* ElementPool::alloc(size_t size)
+      {
+      if (size != _objectSize)
+            return ::operator new(size);
+      if (threadCacheGone) {
+            QMutexLocker locker(&_mutex);
+            if (!_freeList)
+                  addSlab();
+            void* p   = _freeList;
+            _freeList = *static_cast<void**>(p);
+            --_freeSlots;
+            ++_live;
+            return p;
+            }
+      ThreadList& l = threadCache.list(_index);
+      if (!l.head)
+            fill(l);
+      void* p = l.head;
+      l.head  = *static_cast<void**>(p);
+      --l.count;
+      return p;
+      }
+
+//---------------------------------------------------------
+//   free
+//---------------------------------------------------------
+
+void ElementPool::free(void* p, size_t size)
+      {
+      if (!p)
+            return;
+      if (size != _objectSize) {
+            ::operator delete(p);
+            return;
+            }
+      if (threadCacheGone) {
+            QMutexLocker locker(&_mutex);
+            *static_cast<void**>(p) = _freeList;
+            _freeList = p;
+            ++_freeSlots;
+            --_live;
+            return;
+            }
+      ThreadList& l = threadCache.list(_index);
+      *static_cast<void**>(p) = l.head;
+      l.head = p;
+      if (++l.count >= 2 * BATCH)
+            release(l, BATCH);
+      }
+
+//---------------------------------------------------------
+//   trim
+//    release slabs without live objects, return the number
+//    of bytes released; free slots kept by other threads
+//    keep their slabs alive
+//---------------------------------------------------------
+
+size_t ElementPool::trim()
+      {
+      flushThreadList();
+      QMutexLocker locker(&_mutex);
+      std::vector<size_t> freeInSlab(_slabs.size(), 0);
+      for (void* p = _freeList; p; p = *static_cast<void**>(p))
+            ++freeInSlab[slabIndex(p)];
+      std::vector<char*> released;
+      for (size_t i = 0; i < _slabs.size(); ++i) {
+            if (freeInSlab[i] == _slotsPerSlab)
+                  released.push_back(_slabs[i]);
+            }
+      if (released.empty())
+            return 0;
+
+      // drop the slots of released slabs from the free list
+      void* freeList = 0;
+      void** tail    = &freeList;
+      for (void* p = _freeList; p; p = *static_cast<void**>(p)) {
+            if (freeInSlab[slabIndex(p)] == _slotsPerSlab)
+                  continue;
+            *tail = p;
+            tail  = static_cast<void**>(p);
+            }
+      *tail      = 0;
+      _freeList  = freeList;
+      _freeSlots -= released.size() * _slotsPerSlab;
+
+      std::vector<char*> slabs;
+      for (size_t i = 0; i < _slabs.size(); ++i) {
+            if (freeInSlab[i] != _slotsPerSlab)
+                  slabs.push_back(_slabs[i]);
+            }
+      _slabs.swap(slabs);
+      for (char* m : released)
+            ::operator delete(m);
+      return released.size() * _slotsPerSlab * _slotSize;
+      }
+
+//---------------------------------------------------------
+//   statistics
+//    the free slots of the calling thread are given back
+//    first, so they are not counted as live
+//---------------------------------------------------------
+
+ElementPool::Statistics ElementPool::statistics()
+      {
+      flushThreadList();
+      QMutexLocker locker(&_mutex);
+      return Statistics { _name, _objectSize, _live, _freeSlots, _slabs.size(), _slabs.size() * _slotsPerSlab * _slotSize };
+      }
+
+//---------------------------------------------------------
+//   allStatistics
+//    of all pools, sorted by name
+//---------------------------------------------------------
+
+std::vector<ElementPool::Statistics> ElementPool::allStatistics()
+      {
+      std::vector<Statistics> sl;
+      {
+      QMutexLocker locker(&registryMutex());
+      for (ElementPool* pool : registry())
+            sl.push_back(pool->statistics());
+      }
+      std::sort(sl.begin(), sl.end(), [](const Statistics& a, const Statistics& b) {
+            return strcmp(a.name, b.name) < 0;
+            });
+      return sl;
+      }
+
+//---------------------------------------------------------
+//   trimAll
+//    release unused slabs of all pools, e.g. after a score
+//    was closed; return the number of bytes released
+//---------------------------------------------------------
+
+size_t ElementPool::trimAll()
+      {
+      QMutexLocker locker(&registryMutex());
+      size_t bytes = 0;
+      for (ElementPool* pool : registry())
+            bytes += pool->trim();
+      return bytes;
+      }
+
+}
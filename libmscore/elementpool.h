@@ -0,0 +1,108 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __ELEMENTPOOL_H__
+#define __ELEMENTPOOL_H__
+
+#include <vector>
+#include <QMutex>
+
+#include "config.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   ElementPool
+//    Fixed size slots for one element type, cut from slabs
+//    of SLAB_SIZE bytes. Freed slots are reused for the same
+//    type; trim() returns slabs without live objects to the
+//    heap. Objects of derived types with a different size
+//    are allocated from the heap.
+//    Pools are process-wide and thread safe, as elements
+//    move between scores and are created on worker threads.
+//    Every thread keeps a list of free slots per pool, so
+//    most allocations take no lock; slots move between the
+//    thread and the pool BATCH at a time.
+//---------------------------------------------------------
+
+class ElementPool {
+   public:
+      struct Statistics {
+            const char* name;
+            size_t objectSize;      // sizeof the pooled type
+            size_t live;            // slots in use, including elements held by undo
+                                    // and free slots kept by other threads
+            size_t free;            // slots ready for reuse
+            size_t slabs;
+            size_t bytes;           // memory held in slabs
+            };
+
+   private:
+      friend struct ThreadCache;
+
+      // free slots kept by one thread
+      struct ThreadList {
+            void* head   { 0 };
+            size_t count { 0 };
+            };
+
+      static const size_t SLAB_SIZE = 64 * 1024;
+      static const size_t BATCH     = 32;
+
+      const char* _name;
+      const size_t _objectSize;
+      const size_t _slotSize;
+      const size_t _slotsPerSlab;
+      size_t _index;                // of this pool's ThreadList in every thread
+      std::vector<char*> _slabs;    // sorted by address
+      void* _freeList       { 0 };
+      size_t _freeSlots     { 0 };
+      size_t _live          { 0 };  // slots handed to threads
+      mutable QMutex _mutex;
+
+      void addSlab();
+      size_t slabIndex(void* p) const;
+      void fill(ThreadList&);
+      void release(ThreadList&, size_t n);
+      void flushThreadList();
+
+   public:
+      ElementPool(const char* name, size_t objectSize);
+      ElementPool(const ElementPool&) = delete;
+      ElementPool& operator=(const ElementPool&) = delete;
+
+      void* alloc(size_t size);
+      void free(void* p, size_t size);
+      size_t trim();
+      Statistics statistics();
+
+      static std::vector<Statistics> allStatistics();
+      static size_t trimAll();
+      };
+
+//---------------------------------------------------------
+//   ELEMENT_POOL
+//    allocate objects of class T from an ElementPool; use
+//    in the public section of T
+//---------------------------------------------------------
+
+#ifdef ELEMENT_POOLS
+#define ELEMENT_POOL(T) \
+      static ElementPool& elementPool() { static ElementPool* p = new ElementPool(#T, sizeof(T)); return *p; } \
+      static void* operator new(size_t size)            { return elementPool().alloc(size); } \
+      static void operator delete(void* p, size_t size) { elementPool().free(p, size);      }
+#else
+#define ELEMENT_POOL(T)
+#endif
+
+}     // namespace Ms
+#endif
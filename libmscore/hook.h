@@ -27,6 +27,7 @@ class Hook final : public Symbol {
       int _hookType;
 
    public:
+      ELEMENT_POOL(Hook)
       Hook(Score* = 0);
       virtual Hook* clone() const override        { return new Hook(*this); }
       virtual qreal mag() const override          { return parent()->mag(); }
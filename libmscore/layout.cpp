@@ -2537,6 +2537,29 @@ void layoutDrumsetChord(Chord* c, const Drumset* drumset, const StaffType* st, q
             }
       }
 
+//---------------------------------------------------------
+//   isReusableMeasure
+//    true if the measure was not changed since the previous
+//    layout; its chords, beams and segment shapes are still
+//    valid and only system layout has to be redone.
+//    Neighbours of the layout range and measures at a system
+//    boundary (cross measure beams) are always laid out.
+//---------------------------------------------------------
+
+static bool isReusableMeasure(const Measure* m, const LayoutContext& lc)
+      {
+      if (m->layoutDirty() || m->isMMRest() || m->hasMMRest())
+            return false;
+      const System* system = m->system();
+      if (!system || system->firstMeasure() == m || system->lastMeasure() == m)
+            return false;
+      const Measure* pm = m->prevMeasure();
+      const Measure* nm = m->nextMeasure();
+      bool beforeRange = nm && nm->endTick() <= lc.startTick;
+      bool afterRange  = pm && pm->tick() > lc.endTick;
+      return beforeRange || afterRange;
+      }
+
 //---------------------------------------------------------
 //   getNextMeasure
 //---------------------------------------------------------
@@ -2611,6 +2634,12 @@ void Score::getNextMeasure(LayoutContext& lc)
             lc.tick += measure->ticks();
             return;
             }
+      if (!lineMode() && isReusableMeasure(measure, lc)) {
+            ++_layoutStatistics.reusedMeasures;
+            lc.tick += measure->ticks();
+            return;
+            }
+      ++_layoutStatistics.measures;
 
       measure->connectTremolo();
 
@@ -2760,6 +2789,7 @@ void Score::getNextMeasure(LayoutContext& lc)
                   continue;
             s.createShapes();
             }
+      measure->setLayoutDirty(false);
 
       lc.tick += measure->ticks();
       }
@@ -3261,6 +3291,7 @@ System* Score::collectSystem(LayoutContext& lc)
       {
       if (!lc.curMeasure)
             return 0;
+      ++_layoutStatistics.systems;
       Measure* measure  = _systems.empty() ? 0 : _systems.back()->lastMeasure();
       if (measure) {
             lc.firstSystem        = measure->sectionBreak() && _layoutMode != LayoutMode::FLOAT;
@@ -4097,6 +4128,7 @@ void Score::layoutSystemElements(System* system, LayoutContext& lc)
 
 void LayoutContext::collectPage()
       {
+      ++score->layoutStatistics().pages;
       const qreal slb = score->styleP(Sid::staffLowerBorder);
       bool breakPages = score->layoutMode() != LayoutMode::SYSTEM;
       //qreal y         = prevSystem ? prevSystem->y() + prevSystem->height() : page->tm();
@@ -4352,6 +4384,36 @@ class CmdStateLocker {
       ~CmdStateLocker() { score->cmdState().unlock(); }
       };
 
+//---------------------------------------------------------
+//   removeSystems
+//    delete all systems and pages of the score
+//---------------------------------------------------------
+
+void Score::removeSystems()
+      {
+      for (System* s : _systems) {
+            for (Bracket* b : s->brackets()) {
+                  if (b->selected()) {
+                        _selection.remove(b);
+                        setSelectionChanged(true);
+                        }
+                  }
+//            for (SpannerSegment* ss : s->spannerSegments())
+//                  ss->setParent(0);
+            s->setParent(nullptr);
+            }
+      for (MeasureBase* mb = first(); mb; mb = mb->next()) {
+            mb->setSystem(0);
+            if (mb->isMeasure() && toMeasure(mb)->mmRest())
+                  toMeasure(mb)->mmRest()->setSystem(0);
+            }
+      qDeleteAll(_systems);
+      _systems.clear();
+
+      qDeleteAll(pages());
+      pages().clear();
+      }
+
 //---------------------------------------------------------
 //   doLayoutRange
 //---------------------------------------------------------
@@ -4381,6 +4443,7 @@ void Score::doLayoutRange(const Fraction& st, const Fraction& et)
       if (etick < Fraction(0,1))
             etick = last()->endTick();
 
+      lc.startTick   = stick;
       lc.endTick     = etick;
       _scoreFont     = ScoreFont::fontFactory(style().value(Sid::MusicalSymbolFont).toString());
       _noteHeadWidth = _scoreFont->width(SymId::noteheadBlack, spatium() / SPATIUM20);
@@ -4466,27 +4529,7 @@ void Score::doLayoutRange(const Fraction& st, const Fraction& et)
                   // lc.systemList  = _systems;
                   // _systems.clear();
 
-            for (System* s : _systems) {
-                  for (Bracket* b : s->brackets()) {
-                        if (b->selected()) {
-                              _selection.remove(b);
-                              setSelectionChanged(true);
-                              }
-                        }
-//                  for (SpannerSegment* ss : s->spannerSegments())
-//                        ss->setParent(0);
-                  s->setParent(nullptr);
-                  }
-            for (MeasureBase* mb = first(); mb; mb = mb->next()) {
-                  mb->setSystem(0);
-                  if (mb->isMeasure() && toMeasure(mb)->mmRest())
-                        toMeasure(mb)->mmRest()->setSystem(0);
-                  }
-            qDeleteAll(_systems);
-            _systems.clear();
-
-            qDeleteAll(pages());
-            pages().clear();
+            removeSystems();
 
             lc.nextMeasure = _showVBox ? first() : firstMeasure();
             }
@@ -4499,6 +4542,157 @@ void Score::doLayoutRange(const Fraction& st, const Fraction& et)
       lc.layout();
       }
 
+//---------------------------------------------------------
+//   setLayoutPending
+//    extend the range to be laid out by doPendingLayout()
+//---------------------------------------------------------
+
+void Score::setLayoutPending(const Fraction& stick, const Fraction& etick, LayoutFlags flags)
+      {
+      if (!_layoutPending) {
+            _layoutPendingStart = stick;
+            _layoutPendingEnd   = etick;
+            _layoutPendingFlags = flags;
+            _layoutPending      = true;
+            return;
+            }
+      _layoutPendingStart = qMin(_layoutPendingStart, stick);
+      if (_layoutPendingEnd < Fraction(0,1) || etick < Fraction(0,1))
+            _layoutPendingEnd = Fraction(-1,1);
+      else
+            _layoutPendingEnd = qMax(_layoutPendingEnd, etick);
+      _layoutPendingFlags |= flags;
+      }
+
+//---------------------------------------------------------
+//   doPendingLayout
+//---------------------------------------------------------
+
+void Score::doPendingLayout()
+      {
+      if (!_layoutPending)
+            return;
+      _layoutPending = false;
+      // doLayoutRange() fixes velocities itself if the current command asks for it
+      if ((_layoutPendingFlags & LayoutFlag::FIX_PITCH_VELO) && !(cmdState().layoutFlags & LayoutFlag::FIX_PITCH_VELO))
+            updateVelo();
+      doLayoutRange(qMax(_layoutPendingStart, Fraction(0,1)), _layoutPendingEnd);
+      }
+
+//---------------------------------------------------------
+//   deferLayout
+//    The systems of a score laid out later still refer to
+//    measures which later commands may delete, so they are
+//    removed now and the whole score is laid out again.
+//---------------------------------------------------------
+
+void Score::deferLayout(LayoutFlags flags)
+      {
+      setLayoutPending(Fraction(0,1), Fraction(-1,1), flags);
+      if (!_systems.empty() || !pages().empty())
+            removeSystems();
+      }
+
+//---------------------------------------------------------
+//   layoutUsesUndo
+//    Layout of multimeasure rests, drumset chords, system
+//    dividers and removed start repeats changes the score
+//    and linked scores through the undo stack, so it has
+//    to run inside a command.
+//    Lyrics layout also uses the undo stack, but only for
+//    lyrics dragged in this score, which is laid out by
+//    the command itself.
+//---------------------------------------------------------
+
+bool Score::layoutUsesUndo() const
+      {
+      if (styleB(Sid::createMultiMeasureRests))
+            return true;
+      if (styleB(Sid::dividerLeft) || styleB(Sid::dividerRight))
+            return true;
+      for (const Part* p : _parts) {
+            for (const auto& i : *p->instruments()) {
+                  if (i.second->useDrumset())
+                        return true;
+                  }
+            }
+      for (const Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
+            if (m->mmRest())
+                  return true;
+            if (!m->repeatStart() && m->findSegmentR(SegmentType::StartRepeatBarLine, Fraction(0,1)))
+                  return true;
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   canLayoutConcurrently
+//    A part score whose layout does not use the undo stack
+//    only changes itself and can be laid out on a worker
+//    thread, as long as no other score of the same master
+//    is laid out on the calling thread at the same time.
+//---------------------------------------------------------
+
+bool Score::canLayoutConcurrently() const
+      {
+      return !isMaster() && !layoutUsesUndo();
+      }
+
+//---------------------------------------------------------
+//   doPendingLayouts
+//    Lay out the pending ranges of scores. With threads > 1
+//    the scores which canLayoutConcurrently() are laid out
+//    on that many worker threads, after the others.
+//---------------------------------------------------------
+
+void Score::doPendingLayouts(const QList<Score*>& scores, int threads)
+      {
+      QList<Score*> concurrent;
+      for (Score* s : scores) {
+            if (!s->layoutPending())
+                  continue;
+            if (threads > 1 && s->canLayoutConcurrently())
+                  concurrent.append(s);
+            else
+                  s->doPendingLayout();
+            }
+      if (concurrent.size() < 2) {
+            for (Score* s : concurrent)
+                  s->doPendingLayout();
+            return;
+            }
+
+      // views are told about the new layout here, on the calling thread;
+      // the CmdState shared with the master score stays locked until all
+      // workers are done
+      std::vector<QList<MuseScoreView*>> views;
+      for (Score* s : concurrent) {
+            views.push_back(s->getViewer());
+            for (MuseScoreView* v : views.back())
+                  s->removeViewer(v);
+            s->cmdState().lock();
+            }
+
+      QThreadPool pool;
+      pool.setMaxThreadCount(threads);
+      const double pixelRatio = MScore::pixelRatio;
+      for (Score* s : concurrent) {
+            QtConcurrent::run(&pool, [s, pixelRatio]() {
+                  MScore::pixelRatio = pixelRatio;
+                  s->doPendingLayout();
+                  });
+            }
+      pool.waitForDone();
+
+      for (int i = 0; i < concurrent.size(); ++i) {
+            concurrent[i]->cmdState().unlock();
+            for (MuseScoreView* v : views[i]) {
+                  concurrent[i]->addViewer(v);
+                  v->layoutChanged();
+                  }
+            }
+      }
+
 //---------------------------------------------------------
 //   layout
 //---------------------------------------------------------
@@ -35,6 +35,7 @@ class LedgerLine final : public Element {
       bool vertical { false };
 
    public:
+      ELEMENT_POOL(LedgerLine)
       LedgerLine(Score*);
       LedgerLine &operator=(const LedgerLine&) = delete;
       virtual LedgerLine* clone() const override { return new LedgerLine(*this); }
@@ -815,6 +815,7 @@ Segment* Measure::getSegmentR(SegmentType st, const Fraction& t)
 void Measure::add(Element* e)
       {
       e->setParent(this);
+      _layoutDirty = true;
       ElementType type = e->type();
 
       switch (type) {
@@ -883,7 +884,7 @@ void Measure::add(Element* e)
                   break;
 
             case ElementType::MEASURE:
-                  _mmRest = toMeasure(e);
+                  setMMRest(toMeasure(e));
                   break;
 
             case ElementType::STAFFTYPE_CHANGE:
@@ -930,6 +931,7 @@ void Measure::remove(Element* e)
       Q_ASSERT(e->parent() == this);
       Q_ASSERT(e->score() == score());
 
+      _layoutDirty = true;
       switch (e->type()) {
             case ElementType::SEGMENT:
                   {
@@ -991,7 +993,7 @@ void Measure::remove(Element* e)
                   break;
 
             case ElementType::MEASURE:
-                  _mmRest = 0;
+                  setMMRest(0);
                   break;
 
             case ElementType::STAFFTYPE_CHANGE:
@@ -1041,6 +1043,18 @@ void Measure::spatiumChanged(qreal /*oldValue*/, qreal /*newValue*/)
       {
       }
 
+//---------------------------------------------------------
+//   setMMRest
+//---------------------------------------------------------
+
+void Measure::setMMRest(Measure* m)
+      {
+      if (_mmRest != m) {
+            _mmRest = m;
+            invalidateTickIndex();
+            }
+      }
+
 //-------------------------------------------------------------------
 //   moveTicks
 //    Also adjust endBarLine if measure len has changed. For this
@@ -1050,6 +1064,8 @@ void Measure::spatiumChanged(qreal /*oldValue*/, qreal /*newValue*/)
 void Measure::moveTicks(const Fraction& diff)
       {
       std::set<Tuplet*> tuplets;
+      if (diff.isNotZero())
+            _layoutDirty = true;
       setTick(tick() + diff);
       for (Segment* segment = last(); segment; segment = segment->prev()) {
             if (segment->segmentType() & (SegmentType::EndBarLine | SegmentType::TimeSigAnnounce))
@@ -2247,7 +2263,7 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                               score()->sigmap()->add((tick() + ticks()).ticks(), SigEvent(_timesig));
                               }
                         else {
-                              _len = _timesig;
+                              setTicks(_timesig);
                               score()->sigmap()->add(tick().ticks(), SigEvent(_timesig));
                               }
                         }
@@ -3078,7 +3094,7 @@ bool Measure::setProperty(Pid propertyId, const QVariant& value)
                   _timesig = value.value<Fraction>();
                   break;
             case Pid::TIMESIG_ACTUAL:
-                  _len = value.value<Fraction>();
+                  setTicks(value.value<Fraction>());
                   break;
             case Pid::MEASURE_NUMBER_MODE:
                   setMeasureNumberMode(MeasureNumberMode(value.toInt()));
@@ -3489,6 +3505,7 @@ bool Measure::endBarLineVisible() const
 
 void Measure::triggerLayout() const
       {
+      _layoutDirty = true;
       if (prev() || next()) // avoid triggering layout before getting added to a score
             score()->setLayout(tick(), endTick(), 0, score()->nstaves() - 1, this);
       }
@@ -82,6 +82,7 @@ class Measure final : public MeasureBase {
 
       MeasureNumberMode _noMode;
       bool _breakMultiMeasureRest;
+      mutable bool _layoutDirty { true };   // content changed since last getNextMeasure() pass
 
       void push_back(Segment* e);
       void push_front(Segment* e);
@@ -239,9 +240,11 @@ class Measure final : public MeasureBase {
       bool isMMRest() const         { return _mmRestCount > 0; }
       Measure* mmRest() const       { return _mmRest;      }
       const Measure* mmRest1() const;
-      void setMMRest(Measure* m)    { _mmRest = m;         }
+      void setMMRest(Measure* m);
       int mmRestCount() const       { return _mmRestCount; }    // number of measures _mmRest spans
       void setMMRestCount(int n)    { _mmRestCount = n;    }
+      bool layoutDirty() const      { return _layoutDirty; }
+      void setLayoutDirty(bool v)   { _layoutDirty = v;    }
       Measure* mmRestFirst() const;
       Measure* mmRestLast() const;
 
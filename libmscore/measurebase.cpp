@@ -49,6 +49,66 @@ MeasureBase::MeasureBase(const MeasureBase& m)
             add(e->clone());
       }
 
+//---------------------------------------------------------
+//   invalidateTickIndex
+//    measure ticks or list links changed; the tick index
+//    of the score has to be rebuilt on next lookup
+//---------------------------------------------------------
+
+void MeasureBase::invalidateTickIndex()
+      {
+      if (score())
+            score()->measures()->invalidateTickIndex();
+      }
+
+//---------------------------------------------------------
+//   setNext
+//---------------------------------------------------------
+
+void MeasureBase::setNext(MeasureBase* e)
+      {
+      if (_next != e) {
+            _next = e;
+            invalidateTickIndex();
+            }
+      }
+
+//---------------------------------------------------------
+//   setPrev
+//---------------------------------------------------------
+
+void MeasureBase::setPrev(MeasureBase* e)
+      {
+      if (_prev != e) {
+            _prev = e;
+            invalidateTickIndex();
+            }
+      }
+
+//---------------------------------------------------------
+//   setTick
+//---------------------------------------------------------
+
+void MeasureBase::setTick(const Fraction& f)
+      {
+      if (_tick != f) {
+            _tick = f;
+            invalidateTickIndex();
+            }
+      }
+
+//---------------------------------------------------------
+//   setTicks
+//---------------------------------------------------------
+
+void MeasureBase::setTicks(const Fraction& f)
+      {
+      if (_len != f) {
+            _len = f;
+            invalidateTickIndex();
+            }
+      }
+
 //---------------------------------------------------------
 //   clearElements
 //---------------------------------------------------------
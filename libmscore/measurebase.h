@@ -71,6 +71,7 @@ class MeasureBase : public Element {
    protected:
       Fraction _len  { Fraction(0, 1) };  ///< actual length of measure
       void cleanupLayoutBreaks(bool undo);
+      void invalidateTickIndex();
 
    public:
       MeasureBase(Score* score = 0);
@@ -84,9 +85,9 @@ class MeasureBase : public Element {
 
       MeasureBase* next() const              { return _next;   }
       MeasureBase* nextMM() const;
-      void setNext(MeasureBase* e)           { _next = e;      }
+      void setNext(MeasureBase* e);
       MeasureBase* prev() const              { return _prev;   }
-      void setPrev(MeasureBase* e)           { _prev = e;      }
+      void setPrev(MeasureBase* e);
 
       Ms::Measure* nextMeasure() const;
       Ms::Measure* prevMeasure() const;
@@ -120,10 +121,10 @@ class MeasureBase : public Element {
       virtual bool readProperties(XmlReader&) override;
 
       Fraction tick() const                { return _tick; }
-      void setTick(const Fraction& f)      { _tick = f;    }
+      void setTick(const Fraction& f);
 
       Fraction ticks() const               { return _len;         }
-      void setTicks(const Fraction& f)     { _len = f;            }
+      void setTicks(const Fraction& f);
 
       Fraction endTick() const             { return _tick + _len; }
 
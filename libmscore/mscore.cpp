@@ -61,6 +61,7 @@ namespace Ms {
 
 bool MScore::debugMode = false;
 bool MScore::testMode = false;
+bool MScore::checkTickIndex = false;
 
 // #ifndef NDEBUG
 bool MScore::showSegmentShapes   = false;
@@ -102,17 +103,17 @@ qreal   MScore::nudgeStep10;
 qreal   MScore::nudgeStep50;
 int     MScore::defaultPlayDuration;
 
-QString MScore::lastError;
+thread_local QString MScore::lastError;
 int     MScore::division    = 480; // 3840;   // pulses per quarter note (PPQ) // ticks per beat
 int     MScore::sampleRate  = 44100;
 int     MScore::mtcType;
 
 bool    MScore::noExcerpts = false;
 bool    MScore::noImages = false;
-bool    MScore::pdfPrinting = false;
-bool    MScore::svgPrinting = false;
+thread_local bool MScore::pdfPrinting = false;
+thread_local bool MScore::svgPrinting = false;
 
-double  MScore::pixelRatio  = 0.8;        // DPI / logicalDPI
+thread_local double MScore::pixelRatio = 0.8;        // DPI / logicalDPI
 
 MPaintDevice* MScore::_paintDevice;
 
@@ -338,7 +338,7 @@ class MScore {
       static qreal nudgeStep10;
       static qreal nudgeStep50;
       static int defaultPlayDuration;
-      static QString lastError;
+      static thread_local QString lastError;      // per thread, see pdfPrinting
 
 // #ifndef NDEBUG
       static bool noHorizontalStretch;
@@ -353,6 +353,7 @@ class MScore {
 // #endif
       static bool debugMode;
       static bool testMode;
+      static bool checkTickIndex;   // cross check measure tick index against linear search
 
       static int division;
       static int sampleRate;
@@ -365,9 +366,12 @@ class MScore {
       static bool noExcerpts;
       static bool noImages;
 
-      static bool pdfPrinting;
-      static bool svgPrinting;
-      static double pixelRatio;
+      // Export state of the painting thread, so that conversion
+      // jobs can export on worker threads; a worker takes
+      // pixelRatio from the main thread when it starts a job.
+      static thread_local bool pdfPrinting;
+      static thread_local bool svgPrinting;
+      static thread_local double pixelRatio;
 
       static qreal verticalPageGap;
       static qreal horizontalPageGapEven;
@@ -44,6 +44,7 @@ class MuseScoreView {
       virtual void layoutChanged() {}
       virtual void dataChanged(const QRectF&) = 0;
       virtual void updateAll() = 0;
+      virtual bool isShown() const { return true; }   // false: layout may wait until shown
 
       virtual void moveCursor()          {}
       virtual void showLoopCursors(bool) {}
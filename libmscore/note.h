@@ -287,6 +287,7 @@ class Note final : public Element {
       void normalizeLeftDragDelta(Segment* seg, EditData &ed, NoteEditData* ned);
 
 public:
+      ELEMENT_POOL(Note)
       Note(Score* s = 0);
       Note(const Note&, bool link = false);
       ~Note();
@@ -27,6 +27,7 @@ class Rest;
 class NoteDot final : public Element {
 
    public:
+      ELEMENT_POOL(NoteDot)
       NoteDot(Score* = 0);
       virtual NoteDot* clone() const override     { return new NoteDot(*this); }
       virtual ElementType type() const override   { return ElementType::NOTEDOT; }
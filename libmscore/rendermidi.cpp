@@ -15,6 +15,7 @@
  render score into event list
 */
 
+#include <queue>
 #include <set>
 
 #include "rendermidi.h"
@@ -224,7 +225,7 @@ void Score::updateChannel()
 //   playNote
 //---------------------------------------------------------
 
-static void playNote(EventMap* events, const Note* note, int channel, int pitch,
+static void playNote(EventBuffer* events, const Note* note, int channel, int pitch,
    int velo, int onTime, int offTime, int staffIdx)
       {
       if (!note->play())
@@ -245,7 +246,7 @@ static void playNote(EventMap* events, const Note* note, int channel, int pitch,
 //   collectNote
 //---------------------------------------------------------
 
-static void collectNote(EventMap* events, int channel, const Note* note, qreal velocityMultiplier, int tickOffset, Staff* staff, SndConfig config)
+static void collectNote(EventBuffer* events, int channel, const Note* note, qreal velocityMultiplier, int tickOffset, Staff* staff, SndConfig config)
       {
       if (!note->play() || note->hidden())      // do not play overlapping notes
             return;
@@ -424,7 +425,7 @@ static void collectNote(EventMap* events, int channel, const Note* note, qreal v
 //   aeolusSetStop
 //---------------------------------------------------------
 
-static void aeolusSetStop(int tick, int channel, int i, int k, bool val, EventMap* events)
+static void aeolusSetStop(int tick, int channel, int i, int k, bool val, EventBuffer* events)
       {
       NPlayEvent event;
       event.setType(ME_CONTROLLER);
@@ -447,7 +448,7 @@ static void aeolusSetStop(int tick, int channel, int i, int k, bool val, EventMa
 //   collectProgramChanges
 //---------------------------------------------------------
 
-static void collectProgramChanges(EventMap* events, Measure* m, Staff* staff, int tickOffset)
+static void collectProgramChanges(EventBuffer* events, Measure* m, Staff* staff, int tickOffset)
       {
       int firstStaffIdx = staff->idx();
       int nextStaffIdx  = firstStaffIdx + 1;
@@ -528,7 +529,7 @@ static int getControllerFromCC(int cc)
 //    the original, velocity-only method of collecting events.
 //---------------------------------------------------------
 
-static void collectMeasureEventsSimple(EventMap* events, Measure* m, Staff* staff, int tickOffset)
+static void collectMeasureEventsSimple(EventBuffer* events, Measure* m, Staff* staff, int tickOffset)
       {
       int firstStaffIdx = staff->idx();
       int nextStaffIdx  = firstStaffIdx + 1;
@@ -590,7 +591,7 @@ static void collectMeasureEventsSimple(EventMap* events, Measure* m, Staff* staf
 //          SEG_START - note-on velocity is the same as the start velocity of the seg
 //---------------------------------------------------------
 
-static void collectMeasureEventsDefault(EventMap* events, Measure* m, Staff* staff, int tickOffset, DynamicsRenderMethod method, int cc)
+static void collectMeasureEventsDefault(EventBuffer* events, Measure* m, Staff* staff, int tickOffset, DynamicsRenderMethod method, int cc)
       {
       int controller = getControllerFromCC(cc);
 
@@ -666,7 +667,7 @@ static void collectMeasureEventsDefault(EventMap* events, Measure* m, Staff* sta
 //    redirects to the correct function based on the passed method
 //---------------------------------------------------------
 
-static void collectMeasureEvents(EventMap* events, Measure* m, Staff* staff, int tickOffset, DynamicsRenderMethod method, int cc)
+static void collectMeasureEvents(EventBuffer* events, Measure* m, Staff* staff, int tickOffset, DynamicsRenderMethod method, int cc)
       {
       switch (method) {
             case DynamicsRenderMethod::SIMPLE:
@@ -833,7 +834,7 @@ void Score::updateVelo()
 //   renderStaffSegment
 //---------------------------------------------------------
 
-void MidiRenderer::renderStaffChunk(const Chunk& chunk, EventMap* events, Staff* staff, DynamicsRenderMethod method, int cc)
+void MidiRenderer::renderStaffChunk(const Chunk& chunk, EventBuffer* events, Staff* staff, DynamicsRenderMethod method, int cc)
       {
       Measure* start = chunk.startMeasure();
       Measure* end = chunk.endMeasure();
@@ -857,7 +858,7 @@ void MidiRenderer::renderStaffChunk(const Chunk& chunk, EventMap* events, Staff*
 //   renderSpanners
 //---------------------------------------------------------
 
-void MidiRenderer::renderSpanners(const Chunk& chunk, EventMap* events)
+void MidiRenderer::renderSpanners(const Chunk& chunk, EventBuffer* events)
       {
       const int tickOffset = chunk.tickOffset();
       const int tick1 = chunk.tick1();
@@ -2027,7 +2028,7 @@ void Score::createPlayEvents(Measure* start, Measure* end)
 ///   add metronome tick events
 //---------------------------------------------------------
 
-void MidiRenderer::renderMetronome(const Chunk& chunk, EventMap* events)
+void MidiRenderer::renderMetronome(const Chunk& chunk, EventBuffer* events)
       {
       const int tickOffset = chunk.tickOffset();
       Measure* start = chunk.startMeasure();
@@ -2042,7 +2043,7 @@ void MidiRenderer::renderMetronome(const Chunk& chunk, EventMap* events)
 ///   add metronome tick events
 //---------------------------------------------------------
 
-void MidiRenderer::renderMetronome(EventMap* events, Measure* m, const Fraction& tickOffset)
+void MidiRenderer::renderMetronome(EventBuffer* events, Measure* m, const Fraction& tickOffset)
       {
       int msrTick         = m->tick().ticks();
       qreal tempo         = score->tempomap()->tempo(msrTick);
@@ -2065,20 +2066,67 @@ void MidiRenderer::renderMetronome(EventMap* events, Measure* m, const Fraction&
             events->insert(std::pair<int,NPlayEvent>(tick + tickOffset.ticks(), NPlayEvent(timeSig.rtick2beatType(rtick))));
       }
 
+//---------------------------------------------------------
+//   ChunkPart
+//    events of one staff for a single chunk, or the
+//    staff-independent events if staff is null
+//---------------------------------------------------------
+
+struct ChunkPart {
+      Staff* staff;
+      EventBuffer events;
+      explicit ChunkPart(Staff* st) : staff(st) {}
+      };
+
+//---------------------------------------------------------
+//   mergeChunkParts
+//    k-way merge of the tick sorted part buffers. Equal ticks
+//    are taken in part order, giving the same order as inserting
+//    the parts into one EventMap one after the other.
+//---------------------------------------------------------
+
+static void mergeChunkParts(const std::vector<ChunkPart>& parts, EventMap* events)
+      {
+      typedef std::pair<int, size_t> Head;      // next tick, part index
+      std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+      std::vector<size_t> pos(parts.size(), 0);
+
+      for (size_t i = 0; i < parts.size(); ++i) {
+            const EventBuffer& buffer = parts[i].events;
+            events->registerChannel(buffer.highestChannel());
+            if (!buffer.empty())
+                  heads.push(Head(buffer.front().first, i));
+            }
+      while (!heads.empty()) {
+            const size_t i = heads.top().second;
+            heads.pop();
+            const EventBuffer& buffer = parts[i].events;
+            const int tick = buffer[pos[i]].first;
+            // copy all events of this tick before looking at the next part
+            do {
+                  events->insert(events->end(), buffer[pos[i]]);
+                  } while (++pos[i] < buffer.size() && buffer[pos[i]].first == tick);
+            if (pos[i] < buffer.size())
+                  heads.push(Head(buffer[pos[i]].first, i));
+            }
+      }
+
 //---------------------------------------------------------
 //   renderMidi
 //    export score to event list
 //---------------------------------------------------------
 
-void Score::renderMidi(EventMap* events, const SynthesizerState& synthState)
+void Score::renderMidi(EventMap* events, const SynthesizerState& synthState, int threads)
       {
-      renderMidi(events, true, MScore::playRepeats, synthState);
+      renderMidi(events, true, MScore::playRepeats, synthState, threads);
       }
 
-void Score::renderMidi(EventMap* events, bool metronome, bool expandRepeats, const SynthesizerState& synthState)
+void Score::renderMidi(EventMap* events, bool metronome, bool expandRepeats, const SynthesizerState& synthState, int threads)
       {
       masterScore()->setExpandRepeats(expandRepeats);
-      MidiRenderer(this).renderScore(events, synthState, metronome);
+      MidiRenderer renderer(this);
+      renderer.setThreads(threads);
+      renderer.renderScore(events, synthState, metronome);
       }
 
 void MidiRenderer::renderScore(EventMap* events, const SynthesizerState& synthState, bool metronome)
@@ -2091,12 +2139,11 @@ void MidiRenderer::renderScore(EventMap* events, const SynthesizerState& synthSt
 
 void MidiRenderer::renderChunk(const Chunk& chunk, EventMap* events, const SynthesizerState& synthState, bool metronome)
       {
+      updateState();
+
       // TODO: avoid doing it multiple times for the same measures
       score->createPlayEvents(chunk.startMeasure(), chunk.endMeasure());
 
-      score->updateChannel();
-      score->updateVelo();
-
       SynthesizerState s = score->synthesizerState();
       int method = s.method();
       int cc = s.ccToUse();
@@ -2132,41 +2179,43 @@ void MidiRenderer::renderChunk(const Chunk& chunk, EventMap* events, const Synth
                   break;
             }
 
-      // create note & other events
+      // Every staff is rendered into its own buffer, on a thread
+      // pool if more than one thread is allowed; the last buffer gets
+      // the staff-independent spanner and metronome events.
+      std::vector<ChunkPart> parts;
+      parts.reserve(score->nstaves() + 1);
       for (Staff* st : score->staves())
-            renderStaffChunk(chunk, events, st, renderMethod, cc);
-      events->fixupMIDI();
-
-      // create sustain pedal events
-      renderSpanners(chunk, events);
-
-      if (metronome)
-            renderMetronome(chunk, events);
-
-      // NOTE:JT this is a temporary fix for duplicate events until polyphonic aftertouch support
-      // can be implemented. This removes duplicate SND events.
-      int lastChannel = -1;
-      int lastController = -1;
-      int lastValue = -1;
-      for (auto i = events->begin(); i != events->end();) {
-            if (i->second.type() == ME_CONTROLLER) {
-                  auto& event = i->second;
-                  if (event.channel() == lastChannel &&
-                      event.controller() == lastController &&
-                      event.value() == lastValue) {
-                        i = events->erase(i);
-                        }
-                  else {
-                        lastChannel = event.channel();
-                        lastController = event.controller();
-                        lastValue = event.value();
-                        i++;
-                        }
-                  }
+            parts.push_back(ChunkPart(st));
+      parts.push_back(ChunkPart(nullptr));
+
+      auto renderPart = [&](ChunkPart& part) {
+            if (part.staff)
+                  renderStaffChunk(chunk, &part.events, part.staff, renderMethod, cc);
             else {
-                  i++;
+                  // create sustain pedal events
+                  renderSpanners(chunk, &part.events);
+                  if (metronome)
+                        renderMetronome(chunk, &part.events);
                   }
+            part.events.sortByTick();
+            };
+      if (threads > 1 && parts.size() > 1) {
+            QThreadPool pool;
+            pool.setMaxThreadCount(threads);
+            for (ChunkPart& part : parts)
+                  QtConcurrent::run(&pool, [&renderPart, &part]() { renderPart(part); });
+            pool.waitForDone();
             }
+      else {
+            for (ChunkPart& part : parts)
+                  renderPart(part);
+            }
+
+      // render into a chunk-local map first, so that fixing up the
+      // target map only has to look at the part this chunk touches
+      EventMap chunkEvents;
+      mergeChunkParts(parts, &chunkEvents);
+      events->insertChunk(chunkEvents);
       }
 
 //---------------------------------------------------------
@@ -2180,6 +2229,8 @@ void MidiRenderer::updateState()
             // to avoid doing it multiple times on chunks rendering
             score->updateSwing();
             score->updateCapo();
+            score->updateChannel();
+            score->updateVelo();
 
             updateChunksPartition();
 
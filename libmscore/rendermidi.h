@@ -25,6 +25,7 @@
 
 namespace Ms {
 
+class EventBuffer;
 class EventMap;
 class MasterScore;
 class Staff;
@@ -64,6 +65,7 @@ class MidiRenderer {
       Score* score;
       bool needUpdate = true;
       int minChunkSize = 0;
+      int threads = 1;              // staves of a chunk are rendered on up to this many threads
 
    public:
       class Chunk {
@@ -96,10 +98,10 @@ class MidiRenderer {
       static bool canBreakChunk(const Measure* last);
       void updateState();
 
-      void renderStaffChunk(const Chunk&, EventMap* events, Staff*, DynamicsRenderMethod method, int cc);
-      void renderSpanners(const Chunk&, EventMap* events);
-      void renderMetronome(const Chunk&, EventMap* events);
-      void renderMetronome(EventMap* events, Measure* m, const Fraction& tickOffset);
+      void renderStaffChunk(const Chunk&, EventBuffer* events, Staff*, DynamicsRenderMethod method, int cc);
+      void renderSpanners(const Chunk&, EventBuffer* events);
+      void renderMetronome(const Chunk&, EventBuffer* events);
+      void renderMetronome(EventBuffer* events, Measure* m, const Fraction& tickOffset);
 
    public:
       explicit MidiRenderer(Score* s) : score(s) {}
@@ -109,6 +111,7 @@ class MidiRenderer {
 
       void setScoreChanged() { needUpdate = true; }
       void setMinChunkSize(int sizeMeasures) { minChunkSize = sizeMeasures; needUpdate = true; }
+      void setThreads(int n) { threads = n; }
 
       Chunk getChunkAt(int utick);
       };
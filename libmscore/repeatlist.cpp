@@ -150,8 +150,6 @@ int RepeatSegment::playbackCount(Measure * const m) const
 RepeatList::RepeatList(Score* s)
       {
       _score = s;
-      idx1  = 0;
-      idx2  = 0;
       }
 
 //---------------------------------------------------------
@@ -189,6 +187,7 @@ void RepeatList::update(bool expand)
             unwind();
       else
             flatten();
+      updateSpans();
 
       _scoreChanged = false;
       }
@@ -212,6 +211,49 @@ void RepeatList::updateTempo()
             utick        += s->len();
             t            += tl->tick2time(s->tick + s->len()) - ct;
             }
+      updateSpans();
+      }
+
+//---------------------------------------------------------
+//   updateSpans
+//    rebuild the lookup tables from the segments
+//---------------------------------------------------------
+
+void RepeatList::updateSpans()
+      {
+      _spans.clear();
+      _spans.reserve(size());
+      _tickBounds.clear();
+      for (const RepeatSegment* s : *this) {
+            int len = s->len();
+            _spans.push_back({ s->utick, s->tick, len, s->utime, s->timeOffset });
+            _tickBounds.push_back(s->tick);
+            _tickBounds.push_back(s->tick + len);
+            }
+      std::sort(_tickBounds.begin(), _tickBounds.end());
+      _tickBounds.erase(std::unique(_tickBounds.begin(), _tickBounds.end()), _tickBounds.end());
+
+      // tick2utick() maps a tick to the first segment in playback
+      // order containing it: fill the intervals back to front
+      _tickSpans.assign(_tickBounds.empty() ? 0 : _tickBounds.size() - 1, -1);
+      for (int i = int(_spans.size()) - 1; i >= 0; --i) {
+            const RepeatSpan& s = _spans[i];
+            size_t k = std::lower_bound(_tickBounds.begin(), _tickBounds.end(), s.tick) - _tickBounds.begin();
+            for (; k < _tickSpans.size() && _tickBounds[k] < s.tick + s.len; ++k)
+                  _tickSpans[k] = i;
+            }
+      }
+
+//---------------------------------------------------------
+//   spanIndex
+//    last span starting at or before utick, -1 if none
+//---------------------------------------------------------
+
+int RepeatList::spanIndex(int utick) const
+      {
+      auto s = std::upper_bound(_spans.begin(), _spans.end(), utick,
+         [](int t, const RepeatSpan& rs) { return t < rs.utick; });
+      return int(s - _spans.begin()) - 1;
       }
 
 //---------------------------------------------------------
@@ -220,18 +262,13 @@ void RepeatList::updateTempo()
 
 int RepeatList::utick2tick(int tick) const
       {
-      unsigned n = size();
-      if (n == 0)
+      if (_spans.empty())
             return tick;
       if (tick < 0)
             return 0;
-      unsigned ii = (idx1 < n) && (tick >= at(idx1)->utick) ? idx1 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((tick >= at(i)->utick) && ((i + 1 == n) || (tick < at(i+1)->utick))) {
-                  idx1 = i;
-                  return tick - (at(i)->utick - at(i)->tick);
-                  }
-            }
+      int i = spanIndex(tick);
+      if (i >= 0)
+            return tick - (_spans[i].utick - _spans[i].tick);
       if (MScore::debugMode) {
             qFatal("tick %d not found in RepeatList", tick);
             }
@@ -244,13 +281,16 @@ int RepeatList::utick2tick(int tick) const
 
 int RepeatList::tick2utick(int tick) const
       {
-      if (empty())
+      if (_spans.empty())
             return 0;
-      for (const RepeatSegment* s : *this) {
-            if (tick >= s->tick && tick < (s->tick + s->len() ))
-                  return s->utick + (tick - s->tick);
+      auto b = std::upper_bound(_tickBounds.begin(), _tickBounds.end(), tick);
+      if (b != _tickBounds.begin() && b != _tickBounds.end()) {
+            int i = _tickSpans[b - _tickBounds.begin() - 1];
+            if (i >= 0)
+                  return _spans[i].utick + (tick - _spans[i].tick);
             }
-      return last()->utick + (tick - last()->tick);
+      const RepeatSpan& s = _spans.back();
+      return s.utick + (tick - s.tick);
       }
 
 //---------------------------------------------------------
@@ -259,16 +299,39 @@ int RepeatList::tick2utick(int tick) const
 
 qreal RepeatList::utick2utime(int tick) const
       {
-      unsigned n = size();
-      unsigned ii = (idx1 < n) && (tick >= at(idx1)->utick) ? idx1 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((tick >= at(i)->utick) && ((i + 1 == n) || (tick < at(i+1)->utick))) {
-                  int t     = tick - (at(i)->utick - at(i)->tick);
-                  qreal tt = _score->tempomap()->tick2time(t) + at(i)->timeOffset;
-                  return tt;
+      int i = spanIndex(tick);
+      if (i < 0)
+            return 0.0;
+      const RepeatSpan& s = _spans[i];
+      return _score->tempomap()->tick2time(tick - (s.utick - s.tick)) + s.timeOffset;
+      }
+
+//---------------------------------------------------------
+//   utick2utime
+//    convert all uticks in one pass; uticks should be
+//    sorted
+//---------------------------------------------------------
+
+void RepeatList::utick2utime(const std::vector<int>& uticks, std::vector<qreal>& utimes) const
+      {
+      const size_t n = uticks.size();
+      std::vector<int> ticks(n);
+      std::vector<int> spans(n);
+      int i = -1;
+      for (size_t k = 0; k < n; ++k) {
+            int utick = uticks[k];
+            if (i >= 0 && utick < _spans[i].utick)
+                  i = spanIndex(utick);
+            else {
+                  while (i + 1 < int(_spans.size()) && _spans[i + 1].utick <= utick)
+                        ++i;
                   }
+            spans[k] = i;
+            ticks[k] = i < 0 ? 0 : utick - (_spans[i].utick - _spans[i].tick);
             }
-      return 0.0;
+      _score->tempomap()->tick2time(ticks, utimes);
+      for (size_t k = 0; k < n; ++k)
+            utimes[k] = spans[k] < 0 ? 0.0 : utimes[k] + _spans[spans[k]].timeOffset;
       }
 
 //---------------------------------------------------------
@@ -277,13 +340,12 @@ qreal RepeatList::utick2utime(int tick) const
 
 int RepeatList::utime2utick(qreal t) const
       {
-      unsigned n = size();
-      unsigned ii = (idx2 < n) && (t >= at(idx2)->utime) ? idx2 : 0;
-      for (unsigned i = ii; i < n; ++i) {
-            if ((t >= at(i)->utime) && ((i + 1 == n) || (t < at(i+1)->utime))) {
-                  idx2 = i;
-                  return _score->tempomap()->time2tick(t - at(i)->timeOffset) + (at(i)->utick - at(i)->tick);
-                  }
+      // last span starting at or before t
+      auto s = std::upper_bound(_spans.begin(), _spans.end(), t,
+         [](qreal time, const RepeatSpan& rs) { return time < rs.utime; });
+      if (s != _spans.begin()) {
+            --s;
+            return _score->tempomap()->time2tick(t - s->timeOffset) + (s->utick - s->tick);
             }
       if (MScore::debugMode) {
             qFatal("time %f not found in RepeatList", t);
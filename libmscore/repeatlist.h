@@ -46,14 +46,32 @@ class RepeatSegment {
       friend class RepeatList;
       };
 
+//---------------------------------------------------------
+//   RepeatSpan
+//    flat copy of a RepeatSegment for lookups
+//---------------------------------------------------------
+
+struct RepeatSpan {
+      int utick;
+      int tick;
+      int len;
+      qreal utime;
+      qreal timeOffset;
+      };
+
 //---------------------------------------------------------
 //   RepeatList
+//    The segments are mirrored in a vector sorted by utick
+//    and utime; lookups are binary searches and do not
+//    modify the list, so they may run on several threads.
 //---------------------------------------------------------
 
 class RepeatList: public QList<RepeatSegment*>
       {
       Score* _score;
-      mutable unsigned idx1, idx2;   // cached values
+      std::vector<RepeatSpan> _spans;
+      std::vector<int> _tickBounds;    // sorted start and end ticks of all segments
+      std::vector<int> _tickSpans;     // first span containing [_tickBounds[i], _tickBounds[i+1]), -1 if none
 
       bool _expanded = false;
       bool _scoreChanged = true;
@@ -70,6 +88,8 @@ class RepeatList: public QList<RepeatSegment*>
 
       void unwind();
       void flatten();
+      void updateSpans();
+      int spanIndex(int utick) const;
 
    public:
       RepeatList(Score* s);
@@ -84,6 +104,7 @@ class RepeatList: public QList<RepeatSegment*>
       void dump() const;
       int utime2utick(qreal) const;
       qreal utick2utime(int) const;
+      void utick2utime(const std::vector<int>& uticks, std::vector<qreal>& utimes) const;
       void updateTempo();
       int ticks() const;
       };
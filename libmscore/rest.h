@@ -41,6 +41,7 @@ class Rest : public ChordRest {
 
 
    public:
+      ELEMENT_POOL(Rest)
       Rest(Score* s = 0);
       Rest(Score*, const TDuration&);
       Rest(const Rest&, bool link = false);
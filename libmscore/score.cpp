@@ -142,6 +142,7 @@ void MeasureBaseList::push_front(MeasureBase* e)
 
 void MeasureBaseList::add(MeasureBase* e)
       {
+      invalidateTickIndex();
       MeasureBase* el = e->next();
       if (el == 0) {
             push_back(e);
@@ -163,6 +164,7 @@ void MeasureBaseList::add(MeasureBase* e)
 
 void MeasureBaseList::remove(MeasureBase* el)
       {
+      invalidateTickIndex();
       --_size;
       if (el->prev())
             el->prev()->setNext(el->next());
@@ -180,6 +182,7 @@ void MeasureBaseList::remove(MeasureBase* el)
 
 void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
       {
+      invalidateTickIndex();
       ++_size;
       for (MeasureBase* m = fm; m != lm; m = m->next())
             ++_size;
@@ -201,6 +204,7 @@ void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
 
 void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
       {
+      invalidateTickIndex();
       --_size;
       for (MeasureBase* m = fm; m != lm; m = m->next())
             --_size;
@@ -222,6 +226,7 @@ void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
 
 void MeasureBaseList::change(MeasureBase* ob, MeasureBase* nb)
       {
+      invalidateTickIndex();
       nb->setPrev(ob->prev());
       nb->setNext(ob->next());
       if (ob->prev())
@@ -239,6 +244,90 @@ void MeasureBaseList::change(MeasureBase* ob, MeasureBase* nb)
             e->setParent(nb);
       }
 
+//---------------------------------------------------------
+//   tickIndex
+//---------------------------------------------------------
+
+const MeasureTickIndex<Measure>& MeasureBaseList::tickIndex() const
+      {
+      if (_tickIndex.valid.load(std::memory_order_acquire))
+            return _tickIndex;
+      QMutexLocker locker(&_tickIndexMutex);
+      if (_tickIndex.valid.load(std::memory_order_relaxed))
+            return _tickIndex;
+      _tickIndex.measures.clear();
+      _tickIndex.sorted = true;
+      for (MeasureBase* mb = _first; mb; mb = mb->next()) {
+            if (!mb->isMeasure())
+                  continue;
+            if (!_tickIndex.measures.empty() && mb->tick() < _tickIndex.measures.back()->tick())
+                  _tickIndex.sorted = false;
+            _tickIndex.measures.push_back(toMeasure(mb));
+            }
+      _tickIndex.valid.store(true, std::memory_order_release);
+      return _tickIndex;
+      }
+
+//---------------------------------------------------------
+//   tickIndexMM
+//    same as tickIndex() but measure ranges replaced by
+//    their multi measure rest if mmRests is set
+//---------------------------------------------------------
+
+const MeasureTickIndex<Measure>& MeasureBaseList::tickIndexMM(bool mmRests) const
+      {
+      MeasureTickIndex<Measure>& index = _tickIndexMM[mmRests];
+      if (index.valid.load(std::memory_order_acquire))
+            return index;
+      QMutexLocker locker(&_tickIndexMutex);
+      if (index.valid.load(std::memory_order_relaxed))
+            return index;
+      index.measures.clear();
+      index.sorted = true;
+      MeasureBase* mb = _first;
+      while (mb && !mb->isMeasure())
+            mb = mb->next();
+      Measure* m = toMeasure(mb);
+      if (m && mmRests && m->hasMMRest())
+            m = m->mmRest();
+      while (m) {
+            if (!index.measures.empty() && m->tick() < index.measures.back()->tick())
+                  index.sorted = false;
+            index.measures.push_back(m);
+            m = m->nextMeasure();
+            if (m && mmRests && m->hasMMRest())
+                  m = m->mmRest();
+            }
+      index.valid.store(true, std::memory_order_release);
+      return index;
+      }
+
+//---------------------------------------------------------
+//   tickIndexBase
+//    all measure bases which cover a tick range; sorted
+//    only if the ranges do not overlap
+//---------------------------------------------------------
+
+const MeasureTickIndex<MeasureBase>& MeasureBaseList::tickIndexBase() const
+      {
+      if (_tickIndexBase.valid.load(std::memory_order_acquire))
+            return _tickIndexBase;
+      QMutexLocker locker(&_tickIndexMutex);
+      if (_tickIndexBase.valid.load(std::memory_order_relaxed))
+            return _tickIndexBase;
+      _tickIndexBase.measures.clear();
+      _tickIndexBase.sorted = true;
+      for (MeasureBase* mb = _first; mb; mb = mb->next()) {
+            if (mb->ticks() <= Fraction(0,1))
+                  continue;
+            if (!_tickIndexBase.measures.empty() && mb->tick() < _tickIndexBase.measures.back()->endTick())
+                  _tickIndexBase.sorted = false;
+            _tickIndexBase.measures.push_back(mb);
+            }
+      _tickIndexBase.valid.store(true, std::memory_order_release);
+      return _tickIndexBase;
+      }
+
 //---------------------------------------------------------
 //   Score
 //---------------------------------------------------------
@@ -448,6 +537,7 @@ void Score::fixTicks()
 
             tick += measureTicks;
             }
+      _measures.invalidateTickIndex();
       // Now done in getNextMeasure(), do we keep?
       if (tempomap()->empty())
             tempomap()->setTempo(0, _defaultTempo);
@@ -1335,6 +1425,9 @@ void Score::styleChanged()
             headerText()->styleChanged();
       if (footerText())
             footerText()->styleChanged();
+      // style changes are not tracked by measure, lay out all of them
+      for (Measure* m = firstMeasure(); m; m = m->nextMeasure())
+            m->setLayoutDirty(true);
       setLayoutAll();
       }
 
@@ -1821,6 +1914,11 @@ qreal Score::utick2utime(int tick) const
       return repeatList().utick2utime(tick);
       }
 
+void Score::utick2utime(const std::vector<int>& uticks, std::vector<qreal>& utimes) const
+      {
+      repeatList().utick2utime(uticks, utimes);
+      }
+
 //---------------------------------------------------------
 //   utime2utick
 //---------------------------------------------------------
@@ -4630,6 +4728,57 @@ int Score::staffIdx(const Part* part) const
       return idx;
       }
 
+//---------------------------------------------------------
+//   isShown
+//    true if one of the views of the score is visible
+//---------------------------------------------------------
+
+bool Score::isShown() const
+      {
+      for (const MuseScoreView* v : viewer) {
+            if (v->isShown())
+                  return true;
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   countElement
+//---------------------------------------------------------
+
+static void countElement(void* data, Element* e)
+      {
+      ++(*static_cast<std::map<ElementType, size_t>*>(data))[e->type()];
+      }
+
+//---------------------------------------------------------
+//   memoryReport
+//    elements of the score and its parts by type, and the
+//    element pools, which are shared by all scores
+//---------------------------------------------------------
+
+QString MasterScore::memoryReport()
+      {
+      std::map<ElementType, size_t> counts;
+      for (Score* s : scoreList()) {
+            s->scanElements(&counts, countElement, true);
+            for (MeasureBase* mb = s->first(); mb; mb = mb->next()) {
+                  ++counts[mb->type()];
+                  if (mb->isMeasure())
+                        counts[ElementType::SEGMENT] += toMeasure(mb)->segments().size();
+                  }
+            }
+      QString report = QString("elements of <%1> and its parts:\n").arg(title());
+      for (const auto& c : counts)
+            report += QString("  %1 %2\n").arg(QString(ScoreElement::name(c.first)), -20).arg(c.second, 9);
+      report += "element pools (object size, live, free, slabs, KiB):\n";
+      for (const ElementPool::Statistics& st : ElementPool::allStatistics()) {
+            report += QString("  %1 %2 %3 %4 %5 %6\n").arg(QString(st.name), -20).arg(st.objectSize, 5)
+               .arg(st.live, 9).arg(st.free, 9).arg(st.slabs, 6).arg(st.bytes / 1024, 8);
+            }
+      return report;
+      }
+
 //---------------------------------------------------------
 //   setUpdateAll
 //---------------------------------------------------------
@@ -4826,9 +4975,11 @@ Movements::~Movements()
 //    Usually pushes and pops to the undo stack are only
 //    valid inside a startCmd() - endCmd(). Exceptions
 //    occurred during score loading.
+//    Counted per thread, scores may be loaded on
+//    worker threads.
 //---------------------------------------------------------
 
-int ScoreLoad::_loading = 0;
+thread_local int ScoreLoad::_loading = 0;
 
 }
 
@@ -18,6 +18,8 @@
  Definition of Score class.
 */
 
+#include <atomic>
+
 #include "config.h"
 #include "input.h"
 #include "instrument.h"
@@ -130,6 +132,33 @@ enum class LayoutMode : char {
       PAGE, FLOAT, LINE, SYSTEM
       };
 
+//---------------------------------------------------------
+//   LayoutStatistics
+//    work done by Score::doLayoutRange(), accumulated
+//    until reset; used by mtest to check incremental layout
+//---------------------------------------------------------
+
+struct LayoutStatistics {
+      int measures       { 0 };     // measures laid out by getNextMeasure()
+      int reusedMeasures { 0 };     // clean measures kept from previous layout
+      int systems        { 0 };     // systems collected
+      int pages          { 0 };     // pages collected
+      };
+
+//---------------------------------------------------------
+//   MeasureTickIndex
+//    measures in list order for binary search by tick;
+//    only usable if "sorted", as ticks are not monotonic
+//    while the list is being edited
+//---------------------------------------------------------
+
+template <class T>
+struct MeasureTickIndex {
+      std::vector<T*> measures;
+      std::atomic<bool> valid { false };  // set once measures is complete
+      bool sorted { false };
+      };
+
 //---------------------------------------------------------
 //   MeasureBaseList
 //---------------------------------------------------------
@@ -139,6 +168,14 @@ class MeasureBaseList {
       MeasureBase* _first;
       MeasureBase* _last;
 
+      // Rebuilt on first use after a change. Layout and midi rendering
+      // read a score from several threads, so the rebuild is locked;
+      // a valid index is not changed until the list is edited again.
+      mutable MeasureTickIndex<Measure> _tickIndex;
+      mutable MeasureTickIndex<Measure> _tickIndexMM[2];       // without, with multi measure rests
+      mutable MeasureTickIndex<MeasureBase> _tickIndexBase;    // measure bases with ticks() > 0
+      mutable QMutex _tickIndexMutex;
+
       void push_back(MeasureBase* e);
       void push_front(MeasureBase* e);
 
@@ -146,13 +183,18 @@ class MeasureBaseList {
       MeasureBaseList();
       MeasureBase* first() const { return _first; }
       MeasureBase* last()  const { return _last; }
-      void clear()               { _first = _last = 0; _size = 0; }
+      void clear()               { _first = _last = 0; _size = 0; invalidateTickIndex(); }
       void add(MeasureBase*);
       void remove(MeasureBase*);
       void insert(MeasureBase*, MeasureBase*);
       void remove(MeasureBase*, MeasureBase*);
       void change(MeasureBase* o, MeasureBase* n);
       int size() const { return _size; }
+
+      void invalidateTickIndex()  { _tickIndex.valid = false; _tickIndexMM[0].valid = false; _tickIndexMM[1].valid = false; _tickIndexBase.valid = false; }
+      const MeasureTickIndex<Measure>& tickIndex() const;
+      const MeasureTickIndex<Measure>& tickIndexMM(bool mmRests) const;
+      const MeasureTickIndex<MeasureBase>& tickIndexBase() const;
       };
 
 //---------------------------------------------------------
@@ -213,6 +255,14 @@ enum class LayoutFlag : char {
 
 typedef QFlags<LayoutFlag> LayoutFlags;
 
+//---------------------------------------------------------
+//   MsczContents
+//    uncompressed files of a .mscz container in archive
+//    order; implicitly shared, can be handed to a thread
+//---------------------------------------------------------
+
+typedef QList<QPair<QString, QByteArray>> MsczContents;
+
 //---------------------------------------------------------
 //   PlayMode
 //---------------------------------------------------------
@@ -264,7 +314,7 @@ class CmdState {
       bool _oneElement = true;
       bool _oneMeasureBase = true;
 
-      bool _locked = false;
+      std::atomic<int> _locked { 0 };     // lock depth, scores may be laid out concurrently
 
       void setMeasureBase(const MeasureBase* mb);
 
@@ -291,8 +341,8 @@ class CmdState {
       int endStaff() const { return _endStaff; }
       const Element* element() const;
 
-      void lock() { _locked = true; }
-      void unlock() { _locked = false; }
+      void lock() { ++_locked; }
+      void unlock() { --_locked; }
 #ifndef NDEBUG
       void dump();
 #endif
@@ -547,6 +597,11 @@ class Score : public QObject, public ScoreElement {
    protected:
       int _fileDivision; ///< division of current loading *.msc file
       LayoutMode _layoutMode { LayoutMode::PAGE };
+      LayoutStatistics _layoutStatistics;
+      Fraction _layoutPendingStart { -1, 1 };   // range edited while the score was not shown
+      Fraction _layoutPendingEnd   { -1, 1 };   // -1: to the end of the score
+      LayoutFlags _layoutPendingFlags;
+      bool _layoutPending          { false };
       SynthesizerState _synthesizerState;
 
       void createPlayEvents(Chord*);
@@ -791,6 +846,8 @@ class Score : public QObject, public ScoreElement {
       bool saveFile(QIODevice* f, bool msczFormat, bool onlySelection = false);
       bool saveCompressedFile(QFileInfo&, bool onlySelection);
       bool saveCompressedFile(QFileDevice*, QFileInfo&, bool onlySelection, bool createThumbnail = true);
+      bool msczContents(MsczContents&, const QFileInfo&, bool onlySelection, bool createThumbnail = true);
+      static bool writeMscz(QFileDevice*, const MsczContents&);
 
       void print(QPainter* printer, int page);
       ChordRest* getSelectedChordRest() const;
@@ -908,8 +965,8 @@ class Score : public QObject, public ScoreElement {
       bool pasteStaff(XmlReader&, Segment* dst, int staffIdx, Fraction scale = Fraction(1, 1));
       void readAddConnector(ConnectorInfoReader* info, bool pasteMode) override;
       void pasteSymbols(XmlReader& e, ChordRest* dst);
-      void renderMidi(EventMap* events, const SynthesizerState& synthState);
-      void renderMidi(EventMap* events, bool metronome, bool expandRepeats, const SynthesizerState& synthState);
+      void renderMidi(EventMap* events, const SynthesizerState& synthState, int threads = 1);
+      void renderMidi(EventMap* events, bool metronome, bool expandRepeats, const SynthesizerState& synthState, int threads = 1);
 
       BeatType tick2beatType(const Fraction& tick);
 
@@ -965,6 +1022,7 @@ class Score : public QObject, public ScoreElement {
       Measure* searchLabelWithinSectionFirst(const QString& s, Measure* sectionStartMeasure, Measure* sectionEndMeasure);
       virtual inline const RepeatList& repeatList() const;
       qreal utick2utime(int tick) const;
+      void utick2utime(const std::vector<int>& uticks, std::vector<qreal>& utimes) const;
       int utime2utick(qreal utime) const;
 
       void nextInputPos(ChordRest* cr, bool);
@@ -1024,6 +1082,15 @@ class Score : public QObject, public ScoreElement {
 
       void doLayout();
       void doLayoutRange(const Fraction&, const Fraction&);
+      void setLayoutPending(const Fraction& stick, const Fraction& etick, LayoutFlags flags = LayoutFlag::NO_FLAGS);
+      bool layoutPending() const            { return _layoutPending; }
+      void doPendingLayout();
+      void deferLayout(LayoutFlags flags = LayoutFlag::NO_FLAGS);
+      void removeSystems();
+      bool layoutUsesUndo() const;
+      bool canLayoutConcurrently() const;
+      static void doPendingLayouts(const QList<Score*>& scores, int threads = 1);
+      bool isShown() const;
       void layoutLinear(bool layoutAll, LayoutContext& lc);
 
       void layoutChords1(Segment* segment, int staffIdx);
@@ -1075,6 +1142,9 @@ class Score : public QObject, public ScoreElement {
 
       LayoutMode layoutMode() const         { return _layoutMode; }
       void setLayoutMode(LayoutMode lm)     { _layoutMode = lm;   }
+      LayoutStatistics& layoutStatistics()  { return _layoutStatistics; }
+      const LayoutStatistics& layoutStatistics() const { return _layoutStatistics; }
+      void resetLayoutStatistics()          { _layoutStatistics = LayoutStatistics(); }
 
       bool floatMode() const                { return layoutMode() == LayoutMode::FLOAT; }
       bool pageMode() const                 { return layoutMode() == LayoutMode::PAGE; }
@@ -1306,6 +1376,7 @@ class MasterScore : public Score {
 
       void setLayoutAll(int staff = -1, const Element* e = nullptr);
       void setLayout(const Fraction& tick, int staff, const Element* e = nullptr);
+      QString memoryReport();
       void setLayout(const Fraction& tick1, const Fraction& tick2, int staff1, int staff2, const Element* e = nullptr);
 
       virtual CmdState& cmdState() override                           { return _cmdState;                     }
@@ -1396,7 +1467,7 @@ class MasterScore : public Score {
 //---------------------------------------------------------
 
 class ScoreLoad {
-      static int _loading;
+      static thread_local int _loading;
 
    public:
       ScoreLoad()  { ++_loading;  }
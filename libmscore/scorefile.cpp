@@ -547,8 +547,20 @@ QImage Score::createThumbnail()
 
 bool Score::saveCompressedFile(QFileDevice* f, QFileInfo& info, bool onlySelection, bool doCreateThumbnail)
       {
-      MQZipWriter uz(f);
+      MsczContents contents;
+      if (!msczContents(contents, info, onlySelection, doCreateThumbnail))
+            return false;
+      return writeMscz(f, contents);
+      }
 
+//---------------------------------------------------------
+//   msczContents
+//    serialize the score and collect all files of the
+//    .mscz container without compressing them
+//---------------------------------------------------------
+
+bool Score::msczContents(MsczContents& contents, const QFileInfo& info, bool onlySelection, bool doCreateThumbnail)
+      {
       QString fn = info.completeBaseName() + ".mscx";
       QBuffer cbuf;
       cbuf.open(QIODevice::ReadWrite);
@@ -569,15 +581,13 @@ bool Score::saveCompressedFile(QFileDevice* f, QFileInfo& info, bool onlySelecti
       xml.etag();
       cbuf.seek(0);
       //uz.addDirectory("META-INF");
-      uz.addFile("META-INF/container.xml", cbuf.data());
+      contents.append(qMakePair(QString("META-INF/container.xml"), cbuf.data()));
 
       QBuffer dbuf;
       dbuf.open(QIODevice::ReadWrite);
       saveFile(&dbuf, true, onlySelection);
       dbuf.seek(0);
-      uz.addFile(fn, dbuf.data());
-      f->flush(); // flush to preserve score data in case of
-                  // any failures on the further operations.
+      contents.append(qMakePair(fn, dbuf.data()));
 
       // save images
       //uz.addDirectory("Pictures");
@@ -585,7 +595,7 @@ bool Score::saveCompressedFile(QFileDevice* f, QFileInfo& info, bool onlySelecti
             if (!ip->isUsed(this))
                   continue;
             QString path = QString("Pictures/") + ip->hashName();
-            uz.addFile(path, ip->buffer());
+            contents.append(qMakePair(path, ip->buffer()));
             }
 
       // create thumbnail
@@ -598,7 +608,7 @@ bool Score::saveCompressedFile(QFileDevice* f, QFileInfo& info, bool onlySelecti
                   qDebug("open buffer failed");
             if (!pm.save(&b, "PNG"))
                   qDebug("save failed");
-            uz.addFile("Thumbnails/thumbnail.png", ba);
+            contents.append(qMakePair(QString("Thumbnails/thumbnail.png"), ba));
             }
 
 #ifdef OMR
@@ -616,7 +626,7 @@ bool Score::saveCompressedFile(QFileDevice* f, QFileInfo& info, bool onlySelecti
                         MScore::lastError = tr("Save file: cannot save image (%1x%2)").arg(image.width(), image.height());
                         return false;
                         }
-                  uz.addFile(path, cbuf1.data());
+                  contents.append(qMakePair(path, cbuf1.data()));
                   cbuf1.close();
                   }
             }
@@ -625,10 +635,29 @@ bool Score::saveCompressedFile(QFileDevice* f, QFileInfo& info, bool onlySelecti
       // save audio
       //
       if (_audio)
-            uz.addFile("audio.ogg", _audio->data());
+            contents.append(qMakePair(QString("audio.ogg"), _audio->data()));
+      return true;
+      }
 
+//---------------------------------------------------------
+//   writeMscz
+//    compress contents into the already opened file;
+//    does not touch any score and may run in any thread
+//---------------------------------------------------------
+
+bool Score::writeMscz(QFileDevice* f, const MsczContents& contents)
+      {
+      MQZipWriter uz(f);
+      int n = contents.size();
+      for (int i = 0; i < n; ++i) {
+            uz.addFile(contents[i].first, contents[i].second);
+            if (i == 1) {
+                  f->flush(); // flush to preserve score data in case of
+                              // any failures on the further operations.
+                  }
+            }
       uz.close();
-      return true;
+      return uz.status() == MQZipWriter::NoError;
       }
 
 //---------------------------------------------------------
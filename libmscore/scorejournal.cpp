@@ -0,0 +1,365 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "scorejournal.h"
+#include "thirdparty/qzip/qzipreader_p.h"
+#include "dtl/dtl.hpp"
+
+namespace Ms {
+
+//    journal file layout (QDataStream):
+//      header:  quint32 magic, QByteArray md5 of the base .mscx
+//      records: quint32 length, quint16 checksum, payload
+//      payload: quint32 hunks, per hunk: quint32 line, quint32 deleted lines,
+//               quint32 inserted lines, inserted lines as QByteArray
+
+static const quint32 JOURNAL_MAGIC = 0x4d534a31;      // "MSJ1"
+
+//---------------------------------------------------------
+//   mscxIndex
+//    index of the score file in the container
+//---------------------------------------------------------
+
+static int mscxIndex(const MsczContents& contents)
+      {
+      for (int i = 0; i < contents.size(); ++i) {
+            const QString& name = contents[i].first;
+            if (name.endsWith(".mscx") && !name.contains('/'))
+                  return i;
+            }
+      return -1;
+      }
+
+//---------------------------------------------------------
+//   otherFiles
+//    name and md5 of all files but the score .mscx; a
+//    picture replaced under the same name is a change
+//---------------------------------------------------------
+
+static QStringList otherFiles(const MsczContents& contents, int mscxIdx)
+      {
+      QStringList files;
+      for (int i = 0; i < contents.size(); ++i) {
+            if (i != mscxIdx)
+                  files.append(contents[i].first + " " + QCryptographicHash::hash(contents[i].second, QCryptographicHash::Md5).toHex());
+            }
+      return files;
+      }
+
+//---------------------------------------------------------
+//   splitLines
+//---------------------------------------------------------
+
+static QVector<QByteArray> splitLines(const QByteArray& text)
+      {
+      return text.split('\n').toVector();
+      }
+
+//---------------------------------------------------------
+//   joinLines
+//---------------------------------------------------------
+
+static QByteArray joinLines(const QVector<QByteArray>& lines)
+      {
+      int size = 0;
+      for (const QByteArray& l : lines)
+            size += l.size() + 1;
+      QByteArray text;
+      text.reserve(size);
+      for (int i = 0; i < lines.size(); ++i) {
+            if (i)
+                  text.append('\n');
+            text.append(lines[i]);
+            }
+      return text;
+      }
+
+//---------------------------------------------------------
+//   Hunk
+//---------------------------------------------------------
+
+struct Hunk {
+      int line;                     // first replaced line in old text
+      int deleted;
+      QVector<QByteArray> inserted;
+      };
+
+//---------------------------------------------------------
+//   diffLines
+//    common prefix and suffix are skipped by a linear
+//    compare, so the line diff only runs on the edited part
+//---------------------------------------------------------
+
+static QVector<Hunk> diffLines(const QVector<QByteArray>& a, const QVector<QByteArray>& b)
+      {
+      int n = a.size();
+      int m = b.size();
+      int prefix = 0;
+      while (prefix < n && prefix < m && a[prefix] == b[prefix])
+            ++prefix;
+      int suffix = 0;
+      while (suffix < n - prefix && suffix < m - prefix && a[n - 1 - suffix] == b[m - 1 - suffix])
+            ++suffix;
+
+      QVector<Hunk> hunks;
+      if (prefix + suffix == n || prefix + suffix == m) {
+            if (prefix + suffix != n || prefix + suffix != m)
+                  hunks.append({ prefix, n - prefix - suffix, b.mid(prefix, m - prefix - suffix) });
+            return hunks;
+            }
+
+      std::vector<QByteArray> sa(a.begin() + prefix, a.end() - suffix);
+      std::vector<QByteArray> sb(b.begin() + prefix, b.end() - suffix);
+      dtl::Diff<QByteArray, std::vector<QByteArray>> diff(sa, sb);
+      diff.compose();
+
+      const auto changes = diff.getSes().getSequence();
+      int line    = prefix;
+      bool inHunk = false;
+      for (const auto& e : changes) {
+            switch (e.second.type) {
+                  case dtl::SES_COMMON:
+                        ++line;
+                        inHunk = false;
+                        break;
+                  case dtl::SES_DELETE:
+                        if (!inHunk)
+                              hunks.append({ line, 0, QVector<QByteArray>() });
+                        inHunk = true;
+                        ++hunks.last().deleted;
+                        ++line;
+                        break;
+                  case dtl::SES_ADD:
+                        if (!inHunk)
+                              hunks.append({ line, 0, QVector<QByteArray>() });
+                        inHunk = true;
+                        hunks.last().inserted.append(e.first);
+                        break;
+                  }
+            }
+      return hunks;
+      }
+
+//---------------------------------------------------------
+//   applyHunks
+//---------------------------------------------------------
+
+static bool applyHunks(QVector<QByteArray>& lines, QDataStream& ds)
+      {
+      quint32 n;
+      ds >> n;
+      QVector<QByteArray> out;
+      out.reserve(lines.size());
+      int pos = 0;
+      for (quint32 i = 0; i < n; ++i) {
+            quint32 line, deleted, inserted;
+            ds >> line >> deleted >> inserted;
+            if (ds.status() != QDataStream::Ok || int(line) < pos || int(line + deleted) > lines.size())
+                  return false;
+            out += lines.mid(pos, line - pos);
+            for (quint32 k = 0; k < inserted; ++k) {
+                  QByteArray l;
+                  ds >> l;
+                  out.append(l);
+                  }
+            pos = line + deleted;
+            }
+      if (ds.status() != QDataStream::Ok)
+            return false;
+      out += lines.mid(pos);
+      lines.swap(out);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   writeBase
+//    write the complete .mscz and start a new journal
+//---------------------------------------------------------
+
+bool ScoreJournal::writeBase(const MsczContents& contents, int mscxIdx)
+      {
+      _hasBase = false;
+
+      QSaveFile f(_msczPath);
+      if (!f.open(QIODevice::WriteOnly) || !Score::writeMscz(&f, contents) || !f.commit()) {
+            qDebug("ScoreJournal: cannot write <%s>", qPrintable(_msczPath));
+            return false;
+            }
+
+      const QByteArray& mscx = contents[mscxIdx].second;
+      QByteArray header;
+      QDataStream hs(&header, QIODevice::WriteOnly);
+      hs << JOURNAL_MAGIC << QCryptographicHash::hash(mscx, QCryptographicHash::Md5);
+
+      QSaveFile jf(path());
+      if (!jf.open(QIODevice::WriteOnly) || jf.write(header) != header.size() || !jf.commit()) {
+            qDebug("ScoreJournal: cannot write <%s>", qPrintable(path()));
+            return false;
+            }
+
+      _lines    = splitLines(mscx);
+      _baseSize = mscx.size();
+      _size     = header.size();
+      _baseFiles = otherFiles(contents, mscxIdx);
+      _hasBase   = true;
+      return true;
+      }
+
+//---------------------------------------------------------
+//   appendRecord
+//---------------------------------------------------------
+
+bool ScoreJournal::appendRecord(const QVector<QByteArray>& lines)
+      {
+      QVector<Hunk> hunks = diffLines(_lines, lines);
+      if (hunks.isEmpty())
+            return true;
+
+      QByteArray payload;
+      QDataStream ps(&payload, QIODevice::WriteOnly);
+      ps << quint32(hunks.size());
+      for (const Hunk& h : hunks) {
+            ps << quint32(h.line) << quint32(h.deleted) << quint32(h.inserted.size());
+            for (const QByteArray& l : h.inserted)
+                  ps << l;
+            }
+      QByteArray record;
+      QDataStream rs(&record, QIODevice::WriteOnly);
+      rs << quint32(payload.size()) << quint16(qChecksum(payload.constData(), payload.size()));
+      record.append(payload);
+
+      QFile f(path());
+      if (!f.open(QIODevice::WriteOnly | QIODevice::Append) || f.write(record) != record.size() || !f.flush()) {
+            qDebug("ScoreJournal: cannot append to <%s>", qPrintable(path()));
+            _hasBase = false;       // rewrite everything next time
+            return false;
+            }
+      _lines = lines;
+      _size += record.size();
+      return true;
+      }
+
+//---------------------------------------------------------
+//   write
+//    append the changes of contents to the journal; the
+//    .mscz is rewritten on the first call, when pictures
+//    or audio changed, and when the journal needs compaction
+//---------------------------------------------------------
+
+bool ScoreJournal::write(const MsczContents& contents)
+      {
+      int idx = mscxIndex(contents);
+      if (idx == -1)
+            return false;
+      if (!_hasBase || otherFiles(contents, idx) != _baseFiles || needsCompaction())
+            return writeBase(contents, idx);
+      return appendRecord(splitLines(contents[idx].second));
+      }
+
+//---------------------------------------------------------
+//   discard
+//    remove the journal file; the .mscz stays
+//---------------------------------------------------------
+
+void ScoreJournal::discard()
+      {
+      QFile::remove(path());
+      _lines.clear();
+      _baseFiles.clear();
+      _size    = 0;
+      _hasBase = false;
+      }
+
+//---------------------------------------------------------
+//   replay
+//    apply all complete records of journal to mscx;
+//    returns false if the journal does not belong to mscx
+//    or has no records
+//---------------------------------------------------------
+
+bool ScoreJournal::replay(const QString& journalPath, QByteArray& mscx)
+      {
+      QFile f(journalPath);
+      if (!f.open(QIODevice::ReadOnly))
+            return false;
+      QDataStream ds(&f);
+      quint32 magic;
+      QByteArray md5;
+      ds >> magic >> md5;
+      if (ds.status() != QDataStream::Ok || magic != JOURNAL_MAGIC
+         || md5 != QCryptographicHash::hash(mscx, QCryptographicHash::Md5)) {
+            qDebug("ScoreJournal: <%s> does not match its score", qPrintable(journalPath));
+            return false;
+            }
+
+      QVector<QByteArray> lines = splitLines(mscx);
+      int records = 0;
+      for (;;) {
+            quint32 size;
+            quint16 checksum;
+            ds >> size >> checksum;
+            if (ds.status() != QDataStream::Ok || size > f.bytesAvailable())
+                  break;
+            QByteArray payload(size, Qt::Uninitialized);
+            if (ds.readRawData(payload.data(), size) != int(size)
+               || qChecksum(payload.constData(), size) != checksum)
+                  break;
+            QDataStream ps(payload);
+            if (!applyHunks(lines, ps))
+                  break;
+            ++records;
+            }
+      if (!f.atEnd())
+            qDebug("ScoreJournal: <%s>: incomplete record after %d records", qPrintable(journalPath), records);
+      if (records == 0)
+            return false;
+      mscx = joinLines(lines);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   recover
+//    fold the journal of msczPath into the .mscz file and
+//    remove the journal; returns true if the .mscz changed
+//---------------------------------------------------------
+
+bool ScoreJournal::recover(const QString& msczPath)
+      {
+      QString jp = journalPath(msczPath);
+      if (!QFileInfo::exists(jp))
+            return false;
+
+      MsczContents contents;
+      {
+      MQZipReader uz(msczPath);
+      for (const MQZipReader::FileInfo& fi : uz.fileInfoList()) {
+            if (fi.isFile)
+                  contents.append(qMakePair(fi.filePath, uz.fileData(fi.filePath)));
+            }
+      }
+      int idx = mscxIndex(contents);
+      if (idx == -1)
+            return false;
+
+      bool changed = replay(jp, contents[idx].second);
+      if (changed) {
+            QSaveFile f(msczPath);
+            if (!f.open(QIODevice::WriteOnly) || !Score::writeMscz(&f, contents) || !f.commit()) {
+                  qDebug("ScoreJournal: cannot write <%s>", qPrintable(msczPath));
+                  return false;
+                  }
+            }
+      QFile::remove(jp);
+      return changed;
+      }
+
+} // namespace Ms
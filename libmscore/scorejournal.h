@@ -0,0 +1,63 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __SCOREJOURNAL_H__
+#define __SCOREJOURNAL_H__
+
+#include "score.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   ScoreJournal
+//    Append-only sidecar "<file>.mscz.journal" for a .mscz
+//    file. The .mscz is the base snapshot; each record
+//    holds the line changes of the score .mscx since the
+//    previous record. A record which was cut off by a crash
+//    is ignored on replay.
+//    The journal saves compressing and writing the file,
+//    not serializing the score: write() takes the complete
+//    .mscx and compares it with the previous one.
+//    Not thread safe; one thread may use a journal at a time.
+//---------------------------------------------------------
+
+class ScoreJournal {
+      QString _msczPath;
+      QVector<QByteArray> _lines;         // .mscx after the last record
+      QStringList _baseFiles;             // name and md5 of the other files in the base .mscz
+      qint64 _size     { 0 };             // bytes in the journal
+      qint64 _baseSize { 0 };             // bytes of the base .mscx
+      bool _hasBase    { false };
+
+      bool writeBase(const MsczContents&, int mscxIdx);
+      bool appendRecord(const QVector<QByteArray>& lines);
+
+   public:
+      static const qint64 MIN_COMPACT_SIZE = 256 * 1024;
+
+      ScoreJournal(const QString& msczPath) : _msczPath(msczPath) {}
+
+      static QString journalPath(const QString& msczPath) { return msczPath + ".journal"; }
+      QString path() const         { return journalPath(_msczPath); }
+      qint64 size() const          { return _size;   }
+      bool needsCompaction() const { return _size > qMax(MIN_COMPACT_SIZE, _baseSize / 2); }
+
+      bool write(const MsczContents&);
+      void discard();
+
+      static bool replay(const QString& journalPath, QByteArray& mscx);
+      static bool recover(const QString& msczPath);
+      };
+
+} // namespace Ms
+
+#endif
@@ -72,6 +72,7 @@ class Segment final : public Element {
       Element* getElement(int staff);     //??
 
    public:
+      ELEMENT_POOL(Segment)
       Segment(Measure* m = 0);
       Segment(Measure*, SegmentType, const Fraction&);
       Segment(const Segment&);
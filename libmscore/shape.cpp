@@ -13,8 +13,118 @@
 #include "shape.h"
 #include "segment.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SHAPE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace Ms {
 
+//---------------------------------------------------------
+//   SortedShape
+//    The rectangles of a shape with nonzero width as
+//    separate coordinate arrays, sorted by top, for
+//    distance queries. Zero width rectangles collide with
+//    everything, only their minimum left is kept.
+//---------------------------------------------------------
+
+static constexpr qreal NO_LEFT = 1000000.0;    // no candidate rectangle
+
+struct SortedShape {
+      std::vector<qreal> top;
+      std::vector<qreal> bottom;
+      std::vector<qreal> height;
+      std::vector<qreal> left;
+      qreal minLeft          { NO_LEFT };  // of all rectangles
+      qreal minLeftZeroWidth { NO_LEFT };
+      bool hasZeroWidth      { false };
+
+      void build(const Shape&);
+      qreal minLeftOverlapping(size_t n, qreal y1) const;
+      qreal minLeftFlat(qreal y) const;
+      };
+
+//---------------------------------------------------------
+//   build
+//---------------------------------------------------------
+
+void SortedShape::build(const Shape& shape)
+      {
+      static thread_local std::vector<const QRectF*> rects;
+      rects.clear();
+      minLeft          = NO_LEFT;
+      minLeftZeroWidth = NO_LEFT;
+      hasZeroWidth     = false;
+      for (const QRectF& r : shape) {
+            minLeft = qMin(minLeft, r.left());
+            if (r.width() == 0.0) {
+                  minLeftZeroWidth = qMin(minLeftZeroWidth, r.left());
+                  hasZeroWidth     = true;
+                  }
+            else
+                  rects.push_back(&r);
+            }
+      std::sort(rects.begin(), rects.end(), [](const QRectF* a, const QRectF* b) { return a->top() < b->top(); });
+      const size_t n = rects.size();
+      top.resize(n);
+      bottom.resize(n);
+      height.resize(n);
+      left.resize(n);
+      for (size_t i = 0; i < n; ++i) {
+            top[i]    = rects[i]->top();
+            bottom[i] = rects[i]->bottom();
+            height[i] = rects[i]->height();
+            left[i]   = rects[i]->left();
+            }
+      }
+
+//---------------------------------------------------------
+//   minLeftOverlapping
+//    minimum left of the first n rectangles (those with
+//    top < y2) that overlap a band from y1 to y2 with
+//    nonzero height, see Ms::intersects()
+//---------------------------------------------------------
+
+qreal SortedShape::minLeftOverlapping(size_t n, qreal y1) const
+      {
+      qreal m = NO_LEFT;
+      size_t i = 0;
+#ifdef SHAPE_SSE2
+      const __m128d vy1   = _mm_set1_pd(y1);
+      const __m128d vnone = _mm_set1_pd(NO_LEFT);
+      __m128d vm = vnone;
+      for (; i + 2 <= n; i += 2) {
+            const __m128d t    = _mm_loadu_pd(&top[i]);
+            const __m128d b    = _mm_loadu_pd(&bottom[i]);
+            const __m128d mask = _mm_and_pd(_mm_cmpgt_pd(b, vy1), _mm_cmpneq_pd(t, b));
+            const __m128d l    = _mm_or_pd(_mm_and_pd(mask, _mm_loadu_pd(&left[i])), _mm_andnot_pd(mask, vnone));
+            vm = _mm_min_pd(vm, l);
+            }
+      m = qMin(_mm_cvtsd_f64(vm), _mm_cvtsd_f64(_mm_unpackhi_pd(vm, vm)));
+#endif
+      for (; i < n; ++i) {
+            if (bottom[i] > y1 && top[i] != bottom[i])
+                  m = qMin(m, left[i]);
+            }
+      return m;
+      }
+
+//---------------------------------------------------------
+//   minLeftFlat
+//    minimum left of the zero height rectangles at y
+//---------------------------------------------------------
+
+qreal SortedShape::minLeftFlat(qreal y) const
+      {
+      qreal m = NO_LEFT;
+      for (auto i = std::lower_bound(top.begin(), top.end(), y); i != top.end() && *i == y; ++i) {
+            const size_t k = i - top.begin();
+            if (height[k] == 0.0)
+                  m = qMin(m, left[k]);
+            }
+      return m;
+      }
+
 //---------------------------------------------------------
 //   addHorizontalSpacing
 //    Currently implemented by adding rectangles of zero
@@ -82,18 +192,52 @@ Shape Shape::translated(const QPointF& pt) const
 qreal Shape::minHorizontalDistance(const Shape& a) const
       {
       qreal dist = -1000000.0;      // min real
-      for (const QRectF& r2 : a) {
-            qreal by1 = r2.top();
-            qreal by2 = r2.bottom();
-            for (const QRectF& r1 : *this) {
-                  qreal ay1 = r1.top();
-                  qreal ay2 = r1.bottom();
-                  if (Ms::intersects(ay1, ay2, by1, by2)
-                     || ((r1.height() == 0.0) && (r2.height() == 0.0) && (ay1 == by1))
-                     || ((r1.width() == 0.0) || (r2.width() == 0.0)))
-                        dist = qMax(dist, r1.right() - r2.left());
+      if (size() * a.size() <= 64) {
+            for (const QRectF& r2 : a) {
+                  qreal by1 = r2.top();
+                  qreal by2 = r2.bottom();
+                  for (const QRectF& r1 : *this) {
+                        qreal ay1 = r1.top();
+                        qreal ay2 = r1.bottom();
+                        if (Ms::intersects(ay1, ay2, by1, by2)
+                           || ((r1.height() == 0.0) && (r2.height() == 0.0) && (ay1 == by1))
+                           || ((r1.width() == 0.0) || (r2.width() == 0.0)))
+                              dist = qMax(dist, r1.right() - r2.left());
+                        }
+                  }
+            return dist;
+            }
+
+      // Same result as above for larger shapes: with the rectangles
+      // of a sorted by top, only those above the bottom of r1 are
+      // candidates, and per r1 only their minimum left is needed.
+      static thread_local SortedShape sa;
+      sa.build(a);
+      qreal maxRight = 0.0;         // of the rectangles with nonzero width
+      bool wide = false;
+      for (const QRectF& r1 : *this) {
+            const qreal ay1 = r1.top();
+            const qreal ay2 = r1.bottom();
+            qreal l;
+            if (r1.width() == 0.0)
+                  l = sa.minLeft;
+            else {
+                  maxRight = wide ? qMax(maxRight, r1.right()) : r1.right();
+                  wide = true;
+                  if (r1.height() == 0.0)
+                        l = sa.minLeftFlat(ay1);
+                  else if (ay1 != ay2) {
+                        const size_t n = std::lower_bound(sa.top.begin(), sa.top.end(), ay2) - sa.top.begin();
+                        l = sa.minLeftOverlapping(n, ay1);
+                        }
+                  else
+                        continue;
                   }
+            if (l != NO_LEFT)
+                  dist = qMax(dist, r1.right() - l);
             }
+      if (sa.hasZeroWidth && wide)
+            dist = qMax(dist, maxRight - sa.minLeftZeroWidth);
       return dist;
       }
 
@@ -31,6 +31,7 @@ class Stem final : public Element {
       qreal _len       { 0.0 };     // always positive
 
    public:
+      ELEMENT_POOL(Stem)
       Stem(Score* = 0);
       Stem &operator=(const Stem&) = delete;
 
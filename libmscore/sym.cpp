@@ -23,6 +23,12 @@
 
 static FT_Library ftlib;
 
+// Fonts are loaded on first use and a face, its glyph cache and
+// the pdf font are not thread safe; scores may be painted on
+// worker threads by the converter.
+static QMutex fontLoadMutex;
+static QMutex glyphMutex;
+
 namespace Ms {
 
 
@@ -5655,7 +5661,42 @@ SymId Sym::userName2id(const QString& s)
 bool GlyphKey::operator==(const GlyphKey& k) const
       {
       return (face == k.face) && (id == k.id)
-         && (magX == k.magX) && (magY == k.magY) && (worldScale == k.worldScale) && (color == k.color);
+         && (magX == k.magX) && (magY == k.magY) && (worldScale == k.worldScale);
+      }
+
+//---------------------------------------------------------
+//   tinted
+//    the mask colored with c; the alpha of the color is
+//    replaced by the glyph coverage. A new tint replaces
+//    the least recently used one.
+//---------------------------------------------------------
+
+const QPixmap& GlyphPixmap::tinted(const QColor& c, qreal devicePixelRatio)
+      {
+      auto t = std::find_if(tints.begin(), tints.end(), [&c](const Tint& tint) { return tint.color == c; });
+      if (t != tints.end()) {
+            std::rotate(tints.begin(), t, t + 1);
+            return tints.front().pm;
+            }
+
+      QRgb table[256];
+      QColor tc(c);
+      for (int i = 0; i < 256; ++i) {
+            tc.setAlpha(i);
+            table[i] = tc.rgba();
+            }
+      QImage img(mask.size(), QImage::Format_ARGB32);
+      for (int y = 0; y < mask.height(); ++y) {
+            QRgb* dst              = reinterpret_cast<QRgb*>(img.scanLine(y));
+            const uchar* src       = mask.constScanLine(y);
+            for (int x = 0; x < mask.width(); ++x)
+                  *dst++ = table[*src++];
+            }
+      if (int(tints.size()) == MAX_TINTS)
+            tints.pop_back();
+      tints.insert(tints.begin(), Tint { c, QPixmap::fromImage(img, Qt::NoFormatConversion) });
+      tints.front().pm.setDevicePixelRatio(devicePixelRatio);
+      return tints.front().pm;
       }
 
 //---------------------------------------------------------
@@ -5692,13 +5733,8 @@ void ScoreFont::draw(SymId id, QPainter* painter, const QSizeF& mag, const QPoin
                   qDebug("ScoreFont::draw: invalid sym %d", int(id));
             return;
             }
-      int rv = FT_Load_Glyph(face, sym(id).index(), FT_LOAD_DEFAULT);
-      if (rv) {
-            qDebug("load glyph id %d, failed: 0x%x", int(id), rv);
-            return;
-            }
-
       if (MScore::pdfPrinting) {
+            QMutexLocker locker(&glyphMutex);
             if (font == 0) {
                   QString s(_fontPath+_filename);
                   if (-1 == QFontDatabase::addApplicationFont(s)) {
@@ -5732,10 +5768,19 @@ void ScoreFont::draw(SymId id, QPainter* painter, const QSizeF& mag, const QPoin
       int scale16X      = lrint(worldScale * 6553.6 * mag.width() * DPI_F);
       int scale16Y      = lrint(worldScale * 6553.6 * mag.height() * DPI_F);
 
-      GlyphKey gk(face, id, mag.width(), mag.height(), worldScale, color);
+      QMutexLocker locker(&glyphMutex);
+      GlyphKey gk(face, id, mag.width(), mag.height(), worldScale);
       GlyphPixmap* pm = cache->object(gk);
 
-      if (!pm) {
+      if (pm)
+            ++_cacheHits;
+      else {
+            ++_cacheMisses;
+            int rv = FT_Load_Glyph(face, sym(id).index(), FT_LOAD_DEFAULT);
+            if (rv) {
+                  qDebug("load glyph id %d, failed: 0x%x", int(id), rv);
+                  return;
+                  }
             FT_Matrix matrix {
                   scale16X, 0,
                   0,       scale16Y
@@ -5755,29 +5800,36 @@ void ScoreFont::draw(SymId id, QPainter* painter, const QSizeF& mag, const QPoin
 
             if (bm->width == 0 || bm->rows == 0) {
                   qDebug("zero glyph, id %d", int(id));
+                  FT_Done_Glyph(glyph);
                   return;
                   }
-            QImage img(QSize(bm->width, bm->rows), QImage::Format_ARGB32);
-            img.fill(Qt::transparent);
-
-            for (int y = 0; y < int(bm->rows); ++y) {
-                  unsigned* dst      = (unsigned*)img.scanLine(y);
-                  unsigned char* src = (unsigned char*)(bm->buffer) + bm->pitch * y;
-                  for (int x = 0; x < int(bm->width); ++x) {
-                        unsigned val = *src++;
-                        color.setAlpha(val);
-                        *dst++ = color.rgba();
-                        }
-                  }
             pm = new GlyphPixmap;
-            pm->pm = QPixmap::fromImage(img, Qt::NoFormatConversion);
-            pm->pm.setDevicePixelRatio(worldScale);
+            pm->mask = QImage(QSize(bm->width, bm->rows), QImage::Format_Alpha8);
+            for (int y = 0; y < int(bm->rows); ++y)
+                  memcpy(pm->mask.scanLine(y), bm->buffer + bm->pitch * y, bm->width);
             pm->offset = QPointF(qreal(gb->left), -qreal(gb->top)) / worldScale;
-            if (!cache->insert(gk, pm))
-                  qDebug("cannot cache glyph");
             FT_Done_Glyph(glyph);
+            const QPixmap& tinted = pm->tinted(color, worldScale);
+            if (pm->cost() > cache->maxCost()) {
+                  qDebug("cannot cache glyph");
+                  painter->drawPixmap(pos + pm->offset, tinted);
+                  delete pm;
+                  return;
+                  }
+            cache->insert(gk, pm, pm->cost());
+            painter->drawPixmap(pos + pm->offset, tinted);
+            return;
+            }
+      const int cost = pm->cost();
+      painter->drawPixmap(pos + pm->offset, pm->tinted(color, worldScale));
+      if (pm->cost() != cost) {
+            // account for the new tint; a glyph too large for more
+            // than one tint keeps the current one only
+            while (pm->cost() > cache->maxCost() && pm->tints.size() > 1)
+                  pm->tints.pop_back();
+            cache->take(gk);
+            cache->insert(gk, pm, pm->cost());
             }
-      painter->drawPixmap(pos + pm->offset, pm->pm);
       }
 
 void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos, int n) const
@@ -5931,7 +5983,7 @@ void ScoreFont::load()
             qDebug("freetype: cannot create face <%s>: %d", qPrintable(facePath), rval);
             return;
             }
-      cache = new QCache<GlyphKey, GlyphPixmap>(100);
+      cache = new QCache<GlyphKey, GlyphPixmap>(GLYPH_CACHE_BUDGET);
 
       qreal pixelSize = 200.0;
       FT_Set_Pixel_Sizes(face, 0, int(pixelSize+.5));
@@ -6245,6 +6297,7 @@ ScoreFont* ScoreFont::fontFactory(QString s)
             return fallbackFont();
             }
 
+      QMutexLocker locker(&fontLoadMutex);
       if (!f->face)
             f->load();
       return f;
@@ -6257,6 +6310,7 @@ ScoreFont* ScoreFont::fontFactory(QString s)
 ScoreFont* ScoreFont::fallbackFont()
       {
       ScoreFont* f = &_scoreFonts[FALLBACK_FONT];
+      QMutexLocker locker(&fontLoadMutex);
       if (!f->face)
             f->load();
       return f;
@@ -2735,6 +2735,8 @@ class Sym {
 
 //---------------------------------------------------------
 //   GlyphKey
+//    the color is not part of the key: the cache holds the
+//    alpha mask of a glyph, which is tinted at draw time
 //---------------------------------------------------------
 
 struct GlyphKey {
@@ -2743,17 +2745,32 @@ struct GlyphKey {
       qreal magX;
       qreal magY;
       qreal worldScale;
-      QColor color;
 
    public:
-      GlyphKey(FT_Face _f, SymId _id, float mx, float my, float s, QColor c)
-         : face(_f), id(_id), magX(mx), magY(my), worldScale(s), color(c) {}
+      GlyphKey(FT_Face _f, SymId _id, float mx, float my, float s)
+         : face(_f), id(_id), magX(mx), magY(my), worldScale(s) {}
       bool operator==(const GlyphKey&) const;
       };
 
+//---------------------------------------------------------
+//   GlyphPixmap
+//    rasterized glyph and its most recently used tints;
+//    a score typically draws a glyph in a few colors only
+//    (black, selection, voice colors, invisible)
+//---------------------------------------------------------
+
 struct GlyphPixmap {
-      QPixmap pm;
+      static const int MAX_TINTS = 4;
+      struct Tint {
+            QColor color;
+            QPixmap pm;             // mask tinted with color
+            };
+      QImage mask;                  // Format_Alpha8
+      std::vector<Tint> tints;      // most recently used first
       QPointF offset;
+
+      const QPixmap& tinted(const QColor&, qreal devicePixelRatio);
+      int cost() const { return mask.width() * mask.height() * (1 + 4 * int(tints.size())); }    // mask + ARGB pixmaps
       };
 
 inline uint qHash(const GlyphKey& k)
@@ -2774,6 +2791,8 @@ class ScoreFont {
       QString _filename;
       QByteArray fontImage;
       QCache<GlyphKey, GlyphPixmap>* cache { 0 };
+      mutable quint64 _cacheHits   { 0 };
+      mutable quint64 _cacheMisses { 0 };
       std::list<std::pair<Sid, QVariant>> _engravingDefaults;
       double _textEnclosureThickness = 0;
       mutable QFont* font { 0 };
@@ -2783,6 +2802,8 @@ class ScoreFont {
       void load();
       void computeMetrics(Sym* sym, int code);
 
+      static const int GLYPH_CACHE_BUDGET = 16 * 1024 * 1024;   // bytes
+
    public:
       ScoreFont() {}
       ScoreFont(const ScoreFont&);
@@ -2808,6 +2829,10 @@ class ScoreFont {
       QString toString(SymId) const;
       QPixmap sym2pixmap(SymId, qreal) { return QPixmap(); }      // TODOxxxx
 
+      quint64 cacheHits() const   { return _cacheHits;   }
+      quint64 cacheMisses() const { return _cacheMisses; }
+      void resetCacheStatistics() const { _cacheHits = 0; _cacheMisses = 0; }
+
       void draw(SymId id,                  QPainter*, const QSizeF& mag, const QPointF& pos, qreal scale) const;
       void draw(SymId id,                  QPainter*, qreal mag,         const QPointF& pos, qreal scale) const;
       void draw(SymId id,                  QPainter*, qreal mag,         const QPointF& pos) const;
@@ -113,9 +113,22 @@ void TempoMap::normalize()
             tick  = e->first;
             tempo = e->second.tempo;
             }
+      updateSegments();
       ++_tempoSN;
       }
 
+//---------------------------------------------------------
+//   updateSegments
+//---------------------------------------------------------
+
+void TempoMap::updateSegments()
+      {
+      _segments.clear();
+      _segments.reserve(size());
+      for (auto e = begin(); e != end(); ++e)
+            _segments.push_back({ e->first, e->second.tempo, e->second.pause, e->second.time });
+      }
+
 //---------------------------------------------------------
 //   TempoMap::dump
 //---------------------------------------------------------
@@ -135,6 +148,7 @@ void TempoMap::dump() const
 void TempoMap::clear()
       {
       std::map<int,TEvent>::clear();
+      _segments.clear();
       ++_tempoSN;
       }
 
@@ -151,6 +165,7 @@ void TempoMap::clearRange(int tick1, int tick2)
       if (first == last)
             return;
       erase(first, last);
+      updateSegments();
       ++_tempoSN;
       }
 
@@ -244,27 +259,16 @@ qreal TempoMap::tick2time(int tick, int* sn) const
       qreal delta = qreal(tick);
       qreal tempo = 2.0;
 
-      if (!empty()) {
+      if (!_segments.empty()) {
             int ptick  = 0;
-            auto e = lower_bound(tick);
-            if (e == end()) {
-                  auto pe = e;
-                  --pe;
-                  ptick = pe->first;
-                  tempo = pe->second.tempo;
-                  time  = pe->second.time;
-                  }
-            else if (e->first == tick) {
-                  ptick = tick;
-                  tempo = e->second.tempo;
-                  time  = e->second.time;
-                  }
-            else if (e != begin()) {
-                  auto pe = e;
-                  --pe;
-                  ptick = pe->first;
-                  tempo = pe->second.tempo;
-                  time  = pe->second.time;
+            // last segment at or before tick
+            auto s = std::upper_bound(_segments.begin(), _segments.end(), tick,
+               [](int t, const TempoSegment& ts) { return t < ts.tick; });
+            if (s != _segments.begin()) {
+                  --s;
+                  ptick = s->tick;
+                  tempo = s->tempo;
+                  time  = s->time;
                   }
             delta = qreal(tick - ptick);
             }
@@ -276,30 +280,66 @@ qreal TempoMap::tick2time(int tick, int* sn) const
       return time;
       }
 
+//---------------------------------------------------------
+//   tick2time
+//    convert all ticks in one pass; ticks should be sorted,
+//    unsorted ticks cost a binary search each
+//---------------------------------------------------------
+
+void TempoMap::tick2time(const std::vector<int>& ticks, std::vector<qreal>& times) const
+      {
+      times.resize(ticks.size());
+      if (_segments.empty()) {
+            qDebug("TempoMap: empty");
+            for (size_t i = 0; i < ticks.size(); ++i)
+                  times[i] = qreal(ticks[i]) / (MScore::division * 2.0 * _relTempo);
+            return;
+            }
+      const size_t n = _segments.size();
+      size_t k = 0;                             // next segment after tick
+      for (size_t i = 0; i < ticks.size(); ++i) {
+            int tick = ticks[i];
+            if (k > 0 && tick < _segments[k - 1].tick) {
+                  k = std::upper_bound(_segments.begin(), _segments.end(), tick,
+                     [](int t, const TempoSegment& ts) { return t < ts.tick; }) - _segments.begin();
+                  }
+            while (k < n && _segments[k].tick <= tick)
+                  ++k;
+            int ptick   = 0;
+            qreal tempo = 2.0;
+            qreal time  = 0.0;
+            if (k > 0) {
+                  const TempoSegment& s = _segments[k - 1];
+                  ptick = s.tick;
+                  tempo = s.tempo;
+                  time  = s.time;
+                  }
+            times[i] = time + qreal(tick - ptick) / (MScore::division * tempo * _relTempo);
+            }
+      }
+
 //---------------------------------------------------------
 //   time2tick
 //---------------------------------------------------------
 
 int TempoMap::time2tick(qreal time, int* sn) const
       {
-      int tick     = 0;
-      qreal delta = time;
-      qreal tempo = _tempo;
+      int tick    = 0;
+      qreal delta = 0.0;
+      qreal tempo = 2.0;
 
-      delta = 0.0;
-      tempo = 2.0;
-      for (auto e = begin(); e != end(); ++e) {
-            // if in a pause period, wait on previous tick
-            if ((time <= e->second.time) && (time > e->second.time - e->second.pause)) {
-                  delta = (time - (e->second.time - e->second.pause) + delta);
-                  break;
-                  }
-            if (e->second.time >= time)
-                  break;
-            delta = e->second.time;
-            tick  = e->first;
-            tempo = e->second.tempo;
+      // first segment at or after time
+      auto s = std::lower_bound(_segments.begin(), _segments.end(), time,
+         [](const TempoSegment& ts, qreal t) { return ts.time < t; });
+      if (s != _segments.begin()) {
+            auto ps = s - 1;
+            delta = ps->time;
+            tick  = ps->tick;
+            tempo = ps->tempo;
             }
+      // if in a pause period, wait on previous tick
+      if (s != _segments.end() && time > s->time - s->pause)
+            delta = (time - (s->time - s->pause) + delta);
       delta = time - delta;
       tick += lrint(delta * _relTempo * MScore::division * tempo);
       if (sn)
@@ -308,4 +348,3 @@ int TempoMap::time2tick(qreal time, int* sn) const
       }
 
 }
-
@@ -38,16 +38,33 @@ struct TEvent {
       bool valid() const;
       };
 
+//---------------------------------------------------------
+//   TempoSegment
+//    flat copy of a tempo event for lookups
+//---------------------------------------------------------
+
+struct TempoSegment {
+      int tick;
+      qreal tempo;      // beats per second
+      qreal pause;      // pause in seconds
+      qreal time;       // time for tick in sec, including pause
+      };
+
 //---------------------------------------------------------
 //   Tempomap
+//    The events are mirrored in a vector sorted by tick
+//    and time, so that tick2time() and time2tick() are
+//    binary searches over contiguous memory.
 //---------------------------------------------------------
 
 class TempoMap : public std::map<int, TEvent> {
       int _tempoSN;           // serial no to track tempo changes
       qreal _tempo;           // tempo if not using tempo list (beats per second)
       qreal _relTempo;        // rel. tempo
+      std::vector<TempoSegment> _segments;
 
       void normalize();
+      void updateSegments();
       void del(int tick);
 
    public:
@@ -64,6 +81,7 @@ class TempoMap : public std::map<int, TEvent> {
       qreal tick2time(int tick, qreal time, int* sn) const;
       int time2tick(qreal time, int* sn = 0) const;
       int time2tick(qreal time, int tick, int* sn) const;
+      void tick2time(const std::vector<int>& ticks, std::vector<qreal>& times) const;
       int tempoSN() const { return _tempoSN; }
 
       void setTempo(int t, qreal);
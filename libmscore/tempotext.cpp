@@ -255,19 +255,27 @@ void TempoText::undoChangeProperty(Pid id, const QVariant& v, PropertyFlags ps)
 
 void TempoText::updateTempo()
       {
-      // cache regexp, they are costly to create
-      static QHash<QString, QRegExp> regexps;
-      static QHash<QString, QRegExp> regexps2;
+      // cache regexp, they are costly to create; built once and
+      // only read, as scores are laid out on several threads
+      static const QHash<QString, QRegExp> regexps = [] {
+            QHash<QString, QRegExp> h;
+            for (const TempoPattern& pa : tp)
+                  h[pa.pattern] = QRegExp(QString("%1\\s*=\\s*(\\d+[.]{0,1}\\d*)\\s*").arg(pa.pattern));
+            return h;
+            }();
+      static const QHash<QString, QRegExp> regexps2 = [] {
+            QHash<QString, QRegExp> h;
+            for (const TempoPattern& pa : tp) {
+                  for (const TempoPattern& pa2 : tp)
+                        h[QString("%1_%2").arg(pa.pattern).arg(pa2.pattern)] = QRegExp(QString("%1\\s*=\\s*%2\\s*").arg(pa.pattern).arg(pa2.pattern));
+                  }
+            return h;
+            }();
       QString s = plainText();
       s.replace(",", ".");
       s.replace("<sym>space</sym>"," ");
       for (const TempoPattern& pa : tp) {
-            QRegExp re;
-            if (!regexps.contains(pa.pattern)) {
-                  re = QRegExp(QString("%1\\s*=\\s*(\\d+[.]{0,1}\\d*)\\s*").arg(pa.pattern));
-                  regexps[pa.pattern] = re;
-                  }
-            re = regexps.value(pa.pattern);
+            QRegExp re = regexps.value(pa.pattern);
             if (re.indexIn(s) != -1) {
                   QStringList sl = re.capturedTexts();
                   if (sl.size() == 2) {
@@ -284,12 +292,7 @@ void TempoText::updateTempo()
             else {
                  for (const TempoPattern& pa2 : tp) {
                        QString key = QString("%1_%2").arg(pa.pattern).arg(pa2.pattern);
-                       QRegExp re2;
-                       if (!regexps2.contains(key)) {
-                             re2 = QRegExp(QString("%1\\s*=\\s*%2\\s*").arg(pa.pattern).arg(pa2.pattern));
-                             regexps2[key] = re2;
-                             }
-                       re2 = regexps2.value(key);
+                       QRegExp re2 = regexps2.value(key);
                        if (re2.indexIn(s) != -1) {
                              _relative = pa2.f / pa.f;
                              _isRelative = true;
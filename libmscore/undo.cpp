@@ -148,6 +148,7 @@ void UndoCommand::undo(EditData* ed)
             childList[i]->undo(ed);
             }
       flip(ed);
+      setLayoutDirty();
       }
 
 //---------------------------------------------------------
@@ -162,6 +163,18 @@ void UndoCommand::redo(EditData* ed)
             childList[i]->redo(ed);
             }
       flip(ed);
+      setLayoutDirty();
+      }
+
+//---------------------------------------------------------
+//   setLayoutDirty
+//    the measure changed by this command is laid out again
+//---------------------------------------------------------
+
+void UndoCommand::setLayoutDirty() const
+      {
+      if (const Element* e = layoutElement())
+            e->setMeasureLayoutDirty();
       }
 
 //---------------------------------------------------------
@@ -652,6 +665,7 @@ void AddElement::endUndoRedo(bool isUndo) const
 
 void AddElement::undo(EditData*)
       {
+      element->setMeasureLayoutDirty();
       if (!element->isTuplet())
             element->score()->removeElement(element);
       endUndoRedo(true);
@@ -665,6 +679,7 @@ void AddElement::redo(EditData*)
       {
       if (!element->isTuplet())
             element->score()->addElement(element);
+      element->setMeasureLayoutDirty();
       endUndoRedo(false);
       }
 
@@ -758,6 +773,7 @@ void RemoveElement::undo(EditData*)
       {
       if (!element->isTuplet())
             element->score()->addElement(element);
+      element->setMeasureLayoutDirty();
       if (element->isChordRest()) {
             if (element->isChord()) {
                   Chord* chord = toChord(element);
@@ -779,6 +795,7 @@ void RemoveElement::undo(EditData*)
 
 void RemoveElement::redo(EditData*)
       {
+      element->setMeasureLayoutDirty();
       if (!element->isTuplet())
             element->score()->removeElement(element);
       if (element->isChordRest()) {
@@ -2067,6 +2084,15 @@ void ChangeProperty::flip(EditData*)
       flags = ps;
       }
 
+//---------------------------------------------------------
+//   ChangeProperty::layoutElement
+//---------------------------------------------------------
+
+const Element* ChangeProperty::layoutElement() const
+      {
+      return element && element->isElement() ? toElement(element) : nullptr;
+      }
+
 //---------------------------------------------------------
 //   ChangeBracketProperty::flip
 //---------------------------------------------------------
@@ -2177,6 +2203,7 @@ void ChangeParent::flip(EditData*)
       {
       Element* p = element->parent();
       int si = element->staffIdx();
+      element->setMeasureLayoutDirty();
       p->remove(element);
       element->setParent(parent);
       element->setTrack(staffIdx * VOICES);
@@ -98,6 +98,8 @@ class UndoCommand {
 
    protected:
       virtual void flip(EditData*) {}
+      virtual const Element* layoutElement() const { return nullptr; }
+      void setLayoutDirty() const;
 
    public:
       virtual ~UndoCommand();
@@ -989,6 +991,7 @@ class ChangeProperty : public UndoCommand {
       PropertyFlags flags;
 
       void flip(EditData*) override;
+      const Element* layoutElement() const override;
 
    public:
       ChangeProperty(ScoreElement* e, Pid i, const QVariant& v, PropertyFlags ps = PropertyFlags::NOSTYLE)
@@ -1109,6 +1112,7 @@ class ChangeParent : public UndoCommand {
       int staffIdx;
 
       void flip(EditData*) override;
+      const Element* layoutElement() const override { return element; }
 
    public:
       ChangeParent(Element* e, Element* p, int si) : element(e), parent(p), staffIdx(si) {}
@@ -41,18 +41,34 @@ QRectF handleRect(const QPointF& pos)
       }
 
 //---------------------------------------------------------
-//   tick2measure
+//   findMeasure
+//    binary search in a sorted tick index; returns the
+//    last measure starting at or before tick
 //---------------------------------------------------------
 
-Measure* Score::tick2measure(const Fraction& tick) const
+static Measure* findMeasure(const std::vector<Measure*>& index, const Fraction& tick)
       {
-      if (tick == Fraction(-1,1))   // special number
-            return lastMeasure();
-      if (tick <= Fraction(0,1))
-            return firstMeasure();
+      auto i = std::upper_bound(index.begin(), index.end(), tick,
+         [](const Fraction& t, const Measure* m) { return t < m->tick(); });
+      if (i == index.begin())
+            return 0;
+      Measure* m = *(i - 1);
+      // check last measure
+      if (i == index.end() && tick > m->endTick())
+            return 0;
+      return m;
+      }
+
+//---------------------------------------------------------
+//   walkMeasures
+//    linear search; used if the tick index is not sorted
+//    and to cross check the index
+//---------------------------------------------------------
 
+static Measure* walkMeasures(Measure* fm, bool mm, const Fraction& tick)
+      {
       Measure* lm = 0;
-      for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
+      for (Measure* m = fm; m; m = mm ? m->nextMeasureMM() : m->nextMeasure()) {
             if (tick < m->tick()) {
                   Q_ASSERT(lm);
                   return lm;
@@ -62,10 +78,47 @@ Measure* Score::tick2measure(const Fraction& tick) const
       // check last measure
       if (lm && (tick >= lm->tick()) && (tick <= lm->endTick()))
             return lm;
-      qDebug("tick2measure %d (max %d) not found", tick.ticks(), lm ? lm->tick().ticks() : -1);
       return 0;
       }
 
+//---------------------------------------------------------
+//   checkTickIndex
+//    compare a tick index lookup against the linear
+//    search if MScore::checkTickIndex is set
+//---------------------------------------------------------
+
+template <class T>
+static T* checkTickIndex(const char* name, T* found, T* expected, const Fraction& tick)
+      {
+      if (found != expected) {
+            qFatal("%s %d: tick index returned measure at %d, expected %d", name, tick.ticks(),
+               found ? found->tick().ticks() : -1, expected ? expected->tick().ticks() : -1);
+            }
+      return expected;
+      }
+
+//---------------------------------------------------------
+//   tick2measure
+//---------------------------------------------------------
+
+Measure* Score::tick2measure(const Fraction& tick) const
+      {
+      if (tick == Fraction(-1,1))   // special number
+            return lastMeasure();
+      if (tick <= Fraction(0,1))
+            return firstMeasure();
+
+      const MeasureTickIndex<Measure>& index = _measures.tickIndex();
+      Measure* m = index.sorted ? findMeasure(index.measures, tick) : walkMeasures(firstMeasure(), false, tick);
+      if (MScore::checkTickIndex)
+            m = checkTickIndex("tick2measure", m, walkMeasures(firstMeasure(), false, tick), tick);
+      if (!m) {
+            Measure* lm = lastMeasure();
+            qDebug("tick2measure %d (max %d) not found", tick.ticks(), lm ? lm->tick().ticks() : -1);
+            }
+      return m;
+      }
+
 //---------------------------------------------------------
 //   tick2measureMM
 //---------------------------------------------------------
@@ -78,20 +131,15 @@ Measure* Score::tick2measureMM(const Fraction& t) const
       if (tick < Fraction(0,1))
             tick = Fraction(0,1);
 
-      Measure* lm = 0;
-
-      for (Measure* m = firstMeasureMM(); m; m = m->nextMeasureMM()) {
-            if (tick < m->tick()) {
-                  Q_ASSERT(lm);
-                  return lm;
-                  }
-            lm = m;
+      const MeasureTickIndex<Measure>& index = _measures.tickIndexMM(styleB(Sid::createMultiMeasureRests));
+      Measure* m = index.sorted ? findMeasure(index.measures, tick) : walkMeasures(firstMeasureMM(), true, tick);
+      if (MScore::checkTickIndex)
+            m = checkTickIndex("tick2measureMM", m, walkMeasures(firstMeasureMM(), true, tick), tick);
+      if (!m) {
+            Measure* lm = lastMeasureMM();
+            qDebug("tick2measureMM %d (max %d) not found", tick.ticks(), lm ? lm->tick().ticks() : -1);
             }
-      // check last measure
-      if (lm && (tick >= lm->tick()) && (tick <= lm->endTick()))
-            return lm;
-      qDebug("tick2measureMM %d (max %d) not found", tick.ticks(), lm ? lm->tick().ticks() : -1);
-      return 0;
+      return m;
       }
 
 //---------------------------------------------------------
@@ -100,14 +148,28 @@ Measure* Score::tick2measureMM(const Fraction& t) const
 
 MeasureBase* Score::tick2measureBase(const Fraction& tick) const
       {
-      for (MeasureBase* mb = first(); mb; mb = mb->next()) {
-            Fraction st = mb->tick();
-            Fraction l  = mb->ticks();
-            if (tick >= st && tick < (st+l))
-                  return mb;
+      const MeasureTickIndex<MeasureBase>& index = _measures.tickIndexBase();
+      MeasureBase* mb = 0;
+      if (index.sorted) {
+            auto i = std::upper_bound(index.measures.begin(), index.measures.end(), tick,
+               [](const Fraction& t, const MeasureBase* m) { return t < m->tick(); });
+            if (i != index.measures.begin() && tick < (*(i - 1))->endTick())
+                  mb = *(i - 1);
+            }
+      if (!index.sorted || MScore::checkTickIndex) {
+            MeasureBase* lmb = 0;
+            for (MeasureBase* m = first(); m; m = m->next()) {
+                  Fraction st = m->tick();
+                  Fraction l  = m->ticks();
+                  if (tick >= st && tick < (st+l)) {
+                        lmb = m;
+                        break;
+                        }
+                  }
+            mb = index.sorted ? checkTickIndex("tick2measureBase", mb, lmb, tick) : lmb;
             }
 //      qDebug("tick2measureBase %d not found", tick);
-      return 0;
+      return mb;
       }
 
 //---------------------------------------------------------
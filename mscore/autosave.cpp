@@ -0,0 +1,164 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//=============================================================================
+
+#include "autosave.h"
+#include "preferences.h"
+#include "libmscore/score.h"
+#include "libmscore/scorejournal.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   writeAutosave
+//    runs in the autosave thread; QSaveFile writes to a
+//    temporary file, syncs it and renames it over path,
+//    so a crash never leaves a truncated autosave behind
+//---------------------------------------------------------
+
+static bool writeAutosave(const QString& path, const MsczContents& contents)
+      {
+      QSaveFile f(path);
+      if (!f.open(QIODevice::WriteOnly)) {
+            qDebug("autosave: cannot open <%s>: %s", qPrintable(path), qPrintable(f.errorString()));
+            return false;
+            }
+      if (!Score::writeMscz(&f, contents)) {
+            qDebug("autosave: writing <%s> failed", qPrintable(path));
+            f.cancelWriting();
+            return false;
+            }
+      if (!f.commit()) {
+            qDebug("autosave: commit <%s> failed: %s", qPrintable(path), qPrintable(f.errorString()));
+            return false;
+            }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   AutoSaver
+//---------------------------------------------------------
+
+AutoSaver::AutoSaver()
+      {
+      _pool.setMaxThreadCount(1);
+      _stallHistogram.fill(0, HISTOGRAM_BUCKETS);
+      }
+
+AutoSaver::~AutoSaver()
+      {
+      waitForFinished();
+      qDeleteAll(_journals);
+      }
+
+//---------------------------------------------------------
+//   save
+//    capture score on the calling (GUI) thread and queue
+//    the compressed write; returns false if the score
+//    could not be serialized
+//---------------------------------------------------------
+
+bool AutoSaver::save(MasterScore* score, const QString& path)
+      {
+      QElapsedTimer timer;
+      timer.start();
+
+      MsczContents contents;
+      if (!score->msczContents(contents, QFileInfo(path), false, false))     // no thumbnail
+            return false;
+      if (preferences.getBool(PREF_APP_AUTOSAVE_USEJOURNAL)) {
+            ScoreJournal* journal = _journals.value(path);
+            if (!journal) {
+                  journal = new ScoreJournal(path);
+                  _journals.insert(path, journal);
+                  }
+            _jobs[path] = QtConcurrent::run(&_pool, [journal, contents]() { return journal->write(contents); });
+            }
+      else {
+            ScoreJournal* journal = _journals.take(path);
+            _jobs[path] = QtConcurrent::run(&_pool, [journal, path, contents]() {
+                  bool ok = writeAutosave(path, contents);
+                  if (journal) {
+                        if (ok)
+                              journal->discard();
+                        delete journal;
+                        }
+                  return ok;
+                  });
+            }
+
+      qint64 us = timer.nsecsElapsed() / 1000;
+      int bucket = 0;
+      for (qint64 limit = 1000; bucket < HISTOGRAM_BUCKETS - 1 && us >= limit; limit *= 2)
+            ++bucket;
+      ++_stallHistogram[bucket];
+      return true;
+      }
+
+//---------------------------------------------------------
+//   busy
+//    a previous autosave of path is still being written
+//---------------------------------------------------------
+
+bool AutoSaver::busy(const QString& path) const
+      {
+      return _jobs.value(path).isRunning();
+      }
+
+//---------------------------------------------------------
+//   waitForFinished
+//    must be called before an autosave file is removed
+//---------------------------------------------------------
+
+void AutoSaver::waitForFinished()
+      {
+      _pool.waitForDone();
+      _jobs.clear();
+      }
+
+//---------------------------------------------------------
+//   remove
+//    remove autosave file and its journal
+//---------------------------------------------------------
+
+void AutoSaver::remove(const QString& path)
+      {
+      waitForFinished();
+      delete _journals.take(path);
+      if (!QFile::remove(path))
+            qDebug("cannot remove temporary file <%s>", qPrintable(path));
+      QFile::remove(ScoreJournal::journalPath(path));
+      }
+
+//---------------------------------------------------------
+//   stallHistogramText
+//---------------------------------------------------------
+
+QString AutoSaver::stallHistogramText() const
+      {
+      QString s("autosave GUI stall:");
+      for (int i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+            if (i == HISTOGRAM_BUCKETS - 1)
+                  s += QString(" >=%1ms:%2").arg(1 << (i - 1)).arg(_stallHistogram[i]);
+            else
+                  s += QString(" <%1ms:%2").arg(1 << i).arg(_stallHistogram[i]);
+            }
+      return s;
+      }
+
+} // namespace Ms
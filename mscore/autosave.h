@@ -0,0 +1,67 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//=============================================================================
+
+#ifndef __AUTOSAVE_H__
+#define __AUTOSAVE_H__
+
+namespace Ms {
+
+class MasterScore;
+class ScoreJournal;
+
+//---------------------------------------------------------
+//   AutoSaver
+//    Autosave in two steps: the score is serialized to
+//    memory on the GUI thread, compression and the atomic
+//    file replacement run on a background thread.
+//    The time spent on the GUI thread is recorded in a
+//    histogram with power of two millisecond buckets.
+//    With PREF_APP_AUTOSAVE_USEJOURNAL, the background
+//    thread appends the line changes of the serialized
+//    score to a journal next to the autosave file instead
+//    of compressing and rewriting it (see ScoreJournal).
+//    The GUI thread still serializes the whole score.
+//---------------------------------------------------------
+
+class AutoSaver {
+   public:
+      static const int HISTOGRAM_BUCKETS = 12;  // < 1ms, < 2ms, ... < 1024ms, >= 1024ms
+
+   private:
+      QThreadPool _pool;                        // one thread, jobs run in order
+      QHash<QString, QFuture<bool>> _jobs;      // last job for each autosave file
+      QHash<QString, ScoreJournal*> _journals;  // journals are written by the autosave thread only
+      QVector<int> _stallHistogram;
+
+   public:
+      AutoSaver();
+      ~AutoSaver();
+
+      bool save(MasterScore* score, const QString& path);
+      bool busy(const QString& path) const;
+      void waitForFinished();
+      void remove(const QString& path);
+
+      const QVector<int>& stallHistogram() const { return _stallHistogram; }
+      QString stallHistogramText() const;
+      };
+
+} // namespace Ms
+
+#endif
@@ -458,6 +458,13 @@ void Debugger::updateList(Score* s)
                   }
             }
 
+      QTreeWidgetItem* memItem = new QTreeWidgetItem(list, int(ElementType::INVALID));
+      memItem->setText(0, "Memory");
+      for (const QString& line : s->masterScore()->memoryReport().split('\n', QString::SkipEmptyParts)) {
+            QTreeWidgetItem* i = new QTreeWidgetItem(memItem, int(ElementType::INVALID));
+            i->setText(0, line);
+            }
+
 
       QTreeWidgetItem* li = new QTreeWidgetItem(list, int(ElementType::INVALID));
       li->setText(0, "Global");
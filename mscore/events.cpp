@@ -226,6 +226,20 @@ void ScoreView::resizeEvent(QResizeEvent* /*ev*/)
       emit offsetChanged(_matrix.dx(), _matrix.dy());
       }
 
+//---------------------------------------------------------
+//   showEvent
+//    the score may have been edited while it was hidden
+//---------------------------------------------------------
+
+void ScoreView::showEvent(QShowEvent* event)
+      {
+      if (_score && _score->layoutPending()) {
+            _score->doPendingLayout();
+            update();
+            }
+      QWidget::showEvent(event);
+      }
+
 //---------------------------------------------------------
 //   focusInEvent
 //---------------------------------------------------------
@@ -26,11 +26,104 @@
 #include "libmscore/part.h"
 #include "libmscore/mscore.h"
 #include "synthesizer/msynthesizer.h"
+#include "globals.h"
 #include "musescore.h"
 #include "preferences.h"
 
 namespace Ms {
 
+static const unsigned FRAMES = 512;
+
+// recursive: saveAudio(name) renders through saveAudio(device)
+QMutex MuseScore::sampleRateMutex(QMutex::Recursive);
+
+//---------------------------------------------------------
+//   RenderLane
+//    Synthesizes the dry output of the offline export on
+//    a worker thread, one chunk of blocks ahead of the
+//    calling thread, which applies the master effects and
+//    writes the output.
+//    The lane plays the events and splits its process()
+//    calls exactly as the serial loop in saveAudio() does,
+//    and records the splits, so that the master effects
+//    run on the same sub-blocks. Synthesizers and effects
+//    see the same calls in the same order as in the serial
+//    loop and the output is identical.
+//---------------------------------------------------------
+
+class RenderLane {
+   public:
+      struct Chunk {
+            std::vector<float> buffer;
+            std::vector<std::vector<unsigned>> splits;      // process() lengths per block
+
+            const float* block(unsigned idx) const { return buffer.data() + idx * FRAMES * 2; }
+            };
+
+   private:
+      MasterSynthesizer* _synth;
+      Score* _score;
+      EventMap::const_iterator _playPos;
+      EventMap::const_iterator _endPos;
+      std::vector<int>::const_iterator _playFrame;
+      int _playTime { 0 };
+      int _endFrame;
+
+   public:
+      RenderLane(MasterSynthesizer* synth, Score* score, const EventMap& events, const std::vector<int>& frames, int endFrame)
+         : _synth(synth), _score(score), _playPos(events.cbegin()), _endPos(events.cend()),
+           _playFrame(frames.cbegin()), _endFrame(endFrame) {}
+      void render(Chunk& chunk, unsigned blocks);
+      };
+
+//---------------------------------------------------------
+//   render
+//    synthesize the next "blocks" blocks of FRAMES frames,
+//    same as the serial loop in saveAudio()
+//---------------------------------------------------------
+
+void RenderLane::render(Chunk& chunk, unsigned blocks)
+      {
+      chunk.buffer.assign(blocks * FRAMES * 2, 0.0f);
+      chunk.splits.resize(blocks);
+      float* p = chunk.buffer.data();
+      for (unsigned b = 0; b < blocks; ++b) {
+            std::vector<unsigned>& splits = chunk.splits[b];
+            splits.clear();
+            unsigned frames = FRAMES;
+            const int endTime = _playTime + FRAMES;
+            for (; _playPos != _endPos; ++_playPos, ++_playFrame) {
+                  int f = *_playFrame;
+                  if (f >= endTime)
+                        break;
+                  int n = f - _playTime;
+                  if (n) {
+                        _synth->processSynthesizers(n, p);
+                        splits.push_back(n);
+                        p += 2 * n;
+                        }
+
+                  _playTime += n;
+                  frames    -= n;
+                  const NPlayEvent& e = _playPos->second;
+                  if (e.isChannelEvent()) {
+                        int channelIdx = e.channel();
+                        const Channel* c = _score->masterScore()->midiMapping(channelIdx)->articulation();
+                        if (!c->mute()) {
+                              _synth->play(e, _synth->index(c->synti()));
+                              }
+                        }
+                  }
+            if (frames) {
+                  _synth->processSynthesizers(frames, p);
+                  splits.push_back(frames);
+                  p += 2 * frames;
+                  }
+            _playTime = endTime;
+            if (_playTime >= _endFrame)
+                  _synth->allNotesOff(-1);
+            }
+      }
 ///
 /// \brief Function to synthesize audio and output it into a generic QIODevice
 /// \param score The score to output
@@ -58,29 +151,24 @@ bool MuseScore::saveAudio(Score* score, QIODevice *device, std::function<bool(fl
     const bool useCurrentSynthesizerState = !MScore::noGui;
 
     if (useCurrentSynthesizerState) {
-          score->renderMidi(&events, synthesizerState());
+          score->renderMidi(&events, synthesizerState(), exportThreads);
           if (events.empty())
                 return false;
           }
 
+    // use score settings if possible in non-GUI mode, else current synth settings
+    const SynthesizerState synthState = MScore::noGui ? score->synthesizerState() : mscore->synthesizerState();
     MasterSynthesizer* synth = synthesizerFactory();
     synth->init();
     int sampleRate = preferences.getInt(PREF_EXPORT_AUDIO_SAMPLERATE);
     synth->setSampleRate(sampleRate);
-    if (MScore::noGui) { // use score settings if possible
-          bool r = synth->setState(score->synthesizerState());
-          if (!r)
-                synth->init();
-          }
-    else { // use current synth settings
-          bool r = synth->setState(mscore->synthesizerState());
-          if (!r)
-                synth->init();
-          }
+    synth->setOfflineRendering(true);
+    if (!synth->setState(synthState))
+          synth->init();
 
     if (!useCurrentSynthesizerState) {
           score->masterScore()->rebuildAndUpdateExpressive(synth->synthesizer("Fluid"));
-          score->renderMidi(&events, score->synthesizerState());
+          score->renderMidi(&events, score->synthesizerState(), exportThreads);
           if (synti)
                 score->masterScore()->rebuildAndUpdateExpressive(synti->synthesizer("Fluid"));
 
@@ -88,57 +176,125 @@ bool MuseScore::saveAudio(Score* score, QIODevice *device, std::function<bool(fl
                 return false;
           }
 
+    QMutexLocker sampleRateLocker(&sampleRateMutex);
     int oldSampleRate  = MScore::sampleRate;
     MScore::sampleRate = sampleRate;
 
+    // event times in frames, computed once instead of per
+    // processed buffer; the event ticks are sorted, so they
+    // are converted in one pass over the tempo map
+    std::vector<int> eventTicks;
+    eventTicks.reserve(events.size());
+    for (const auto& ev : events) {
+          if (eventTicks.empty() || ev.first != eventTicks.back())
+                eventTicks.push_back(ev.first);
+          }
+    std::vector<qreal> eventTimes;
+    score->utick2utime(eventTicks, eventTimes);
+    std::vector<int> eventFrames;
+    eventFrames.reserve(events.size());
+    size_t tickIdx = 0;
+    for (const auto& ev : events) {
+          if (ev.first != eventTicks[tickIdx])
+                ++tickIdx;
+          eventFrames.push_back(eventTimes[tickIdx] * MScore::sampleRate);
+          }
+
     float peak  = 0.0;
-    double gain = 1.0;
     EventMap::const_iterator endPos = events.cend();
     --endPos;
     const int et = (score->utick2utime(endPos->first) + 1) * MScore::sampleRate;
     const int maxEndTime = (score->utick2utime(endPos->first) + 3) * MScore::sampleRate;
 
-    bool cancelled = false;
-    int passes = preferences.getBool(PREF_EXPORT_AUDIO_NORMALIZE) ? 2 : 1;
-    for (int pass = 0; pass < passes; ++pass) {
-          EventMap::const_iterator playPos;
-          playPos = events.cbegin();
-          synth->allSoundsOff(-1);
+    //
+    // if normalizing, synthesize into a spill file while
+    // tracking the peak and apply the gain when copying it
+    // to the device, instead of synthesizing the score twice
+    //
+    const bool normalize = preferences.getBool(PREF_EXPORT_AUDIO_NORMALIZE);
+    QTemporaryFile spill;
+    if (normalize && !spill.open()) {
+          qDebug("could not open spill file for normalized audio export");
+          MScore::sampleRate = oldSampleRate;
+          delete synth;
+          device->close();
+          return false;
+          }
+    QIODevice* out = normalize ? static_cast<QIODevice*>(&spill) : device;
+    const float progressScale = normalize ? 0.9f : 1.0f;
 
-          //
-          // init instruments
-          //
-          for (Part* part : score->parts()) {
-                const InstrumentList* il = part->instruments();
-                for (auto i = il->begin(); i!= il->end(); i++) {
-                      for (const Channel* instrChan : i->second->channel()) {
-                            const Channel* a = score->masterScore()->playbackChannel(instrChan);
-                            for (MidiCoreEvent e : a->initList()) {
-                                  if (e.type() == ME_INVALID)
-                                        continue;
-                                  e.setChannel(a->channel());
-                                  int syntiIdx = synth->index(score->masterScore()->midiMapping(a->channel())->articulation()->synti());
-								  synth->play(e, syntiIdx);
-                                  }
+    bool cancelled = false;
+    EventMap::const_iterator playPos = events.cbegin();
+    auto playFrame = eventFrames.cbegin();
+    synth->allSoundsOff(-1);
+
+    //
+    // init instruments
+    //
+    for (Part* part : score->parts()) {
+          const InstrumentList* il = part->instruments();
+          for (auto i = il->begin(); i!= il->end(); i++) {
+                for (const Channel* instrChan : i->second->channel()) {
+                      const Channel* a = score->masterScore()->playbackChannel(instrChan);
+                      for (MidiCoreEvent e : a->initList()) {
+                            if (e.type() == ME_INVALID)
+                                  continue;
+                            e.setChannel(a->channel());
+                            int syntiIdx = synth->index(score->masterScore()->midiMapping(a->channel())->articulation()->synti());
+                            synth->play(e, syntiIdx);
                             }
                       }
                 }
+          }
 
-          static const unsigned FRAMES = 512;
-          float buffer[FRAMES * 2];
-          int playTime = 0;
+    float buffer[FRAMES * 2];
+    int playTime = 0;
+
+    //
+    // offline multi-threaded rendering: a lane synthesizes
+    // chunks of LANE_BLOCKS blocks on a worker thread while
+    // this thread applies the master effects to the previous
+    // chunk; the output is the same as the serial one
+    //
+    static const unsigned LANE_BLOCKS = 64;
+    RenderLane* lane = nullptr;
+    RenderLane::Chunk chunks[2];
+    int chunk = 1;
+    unsigned laneBlock = LANE_BLOCKS;
+    QFuture<void> nextChunk;
+    float effectBuffer[FRAMES * 2];
+    if (exportThreads > 1) {
+          lane = new RenderLane(synth, score, events, eventFrames, et);
+          nextChunk = QtConcurrent::run([lane, &chunks] { lane->render(chunks[0], LANE_BLOCKS); });
+          }
 
-          for (;;) {
-                unsigned frames = FRAMES;
-                //
-                // collect events for one segment
-                //
-                float max = 0.0;
-                memset(buffer, 0, sizeof(float) * FRAMES * 2);
-                int endTime = playTime + frames;
-                float* p = buffer;
-                for (; playPos != events.cend(); ++playPos) {
-                      int f = score->utick2utime(playPos->first) * MScore::sampleRate;
+    for (;;) {
+          unsigned frames = FRAMES;
+          //
+          // collect events for one segment
+          //
+          float max = 0.0;
+          memset(buffer, 0, sizeof(float) * FRAMES * 2);
+          int endTime = playTime + frames;
+          float* p = buffer;
+          if (lane) {
+                if (laneBlock == LANE_BLOCKS) {
+                      nextChunk.waitForFinished();
+                      chunk ^= 1;
+                      RenderLane::Chunk* next = &chunks[chunk ^ 1];
+                      nextChunk = QtConcurrent::run([lane, next] { lane->render(*next, LANE_BLOCKS); });
+                      laneBlock = 0;
+                      }
+                memcpy(buffer, chunks[chunk].block(laneBlock), sizeof(float) * FRAMES * 2);
+                for (unsigned n : chunks[chunk].splits[laneBlock]) {
+                      synth->processEffects(n, p, effectBuffer);
+                      p += 2 * n;
+                      }
+                ++laneBlock;
+                }
+          else {
+                for (; playPos != events.cend(); ++playPos, ++playFrame) {
+                      int f = *playFrame;
                       if (f >= endTime)
                             break;
                       int n = f - playTime;
@@ -162,46 +318,65 @@ bool MuseScore::saveAudio(Score* score, QIODevice *device, std::function<bool(fl
                       synth->process(frames, p);
                       playTime += frames;
                       }
-                if (pass == 1) {
-                      for (unsigned i = 0; i < FRAMES * 2; ++i) {
-                            max = qMax(max, qAbs(buffer[i]));
-                            buffer[i] *= gain;
-                            }
-                      }
-                else {
-                      for (unsigned i = 0; i < FRAMES * 2; ++i) {
-                            max = qMax(max, qAbs(buffer[i]));
-                            peak = qMax(peak, qAbs(buffer[i]));
-                            }
-                      }
-                if (pass == (passes - 1))
-                      device->write(reinterpret_cast<const char*>(buffer), 2 * FRAMES * sizeof(float));
-                playTime = endTime;
-                if (updateProgress) {
-                    // normalize to [0, 1] range
-                    if (!updateProgress(float(pass * et + playTime) / passes / et)) {
-                        cancelled = true;
-                        break;
-                    }
-                      }
-                if (playTime >= et)
-                      synth->allNotesOff(-1);
-                // create sound until the sound decays
-                if (playTime >= et && max*peak < 0.000001)
-                      break;
-                // hard limit
-                if (playTime > maxEndTime)
-                      break;
                 }
-          if (cancelled)
+          for (unsigned i = 0; i < FRAMES * 2; ++i)
+                max = qMax(max, qAbs(buffer[i]));
+          peak = qMax(peak, max);
+          out->write(reinterpret_cast<const char*>(buffer), 2 * FRAMES * sizeof(float));
+          playTime = endTime;
+          if (updateProgress) {
+              // normalize to [0, 1] range
+              if (!updateProgress(progressScale * playTime / et)) {
+                  cancelled = true;
+                  break;
+              }
+                }
+          if (!lane && playTime >= et)
+                synth->allNotesOff(-1);
+          // create sound until the sound decays
+          if (playTime >= et && max*peak < 0.000001)
                 break;
-          if (pass == 0 && peak == 0.0) {
-                qDebug("song is empty");
+          // hard limit
+          if (playTime > maxEndTime)
                 break;
+          }
+
+    if (normalize && !cancelled) {
+          if (peak == 0.0)
+                qDebug("song is empty");
+          else {
+                //
+                // stream the spill file to the device, applying
+                // the gain in blocks the compiler can vectorize
+                //
+                const float gain = 0.99 / peak;
+                const qint64 total = spill.size();
+                spill.seek(0);
+                static const unsigned SPILL_FRAMES = 16384;
+                std::vector<float> block(SPILL_FRAMES * 2);
+                char* data = reinterpret_cast<char*>(block.data());
+                for (qint64 pos = 0; pos < total;) {
+                      qint64 n = spill.read(data, SPILL_FRAMES * 2 * sizeof(float));
+                      if (n <= 0)
+                            break;
+                      float* f = block.data();
+                      const qint64 samples = n / qint64(sizeof(float));
+                      for (qint64 i = 0; i < samples; ++i)
+                            f[i] *= gain;
+                      device->write(data, n);
+                      pos += n;
+                      if (updateProgress && !updateProgress(0.9f + 0.1f * pos / total)) {
+                            cancelled = true;
+                            break;
+                            }
+                      }
                 }
-          gain = 0.99 / peak;
           }
 
+    if (lane) {
+          nextChunk.waitForFinished();
+          delete lane;
+          }
     MScore::sampleRate = oldSampleRate;
     delete synth;
 
@@ -284,7 +459,7 @@ bool MuseScore::saveAudio(Score* score, const QString& name)
             }
 
       EventMap events;
-      score->renderMidi(&events, synthesizerState());
+      score->renderMidi(&events, synthesizerState(), exportThreads);
       if(events.size() == 0)
             return false;
 
@@ -292,10 +467,12 @@ bool MuseScore::saveAudio(Score* score, const QString& name)
 	  synth->init();
       int sampleRate = preferences.getInt(PREF_EXPORT_AUDIO_SAMPLERATE);
 	  synth->setSampleRate(sampleRate);
+      synth->setOfflineRendering(true);
       bool r = synth->setState(score->synthesizerState());
       if (!r)
           synth->init();
 
+      QMutexLocker sampleRateLocker(&sampleRateMutex);
       int oldSampleRate  = MScore::sampleRate;
       MScore::sampleRate = sampleRate;
 
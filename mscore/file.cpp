@@ -19,6 +19,7 @@
 #include "musescore.h"
 #include "scoreview.h"
 #include "exportmidi.h"
+#include "autosave.h"
 #include "libmscore/xml.h"
 #include "libmscore/element.h"
 #include "libmscore/note.h"
@@ -212,6 +213,7 @@ static bool readScoreError(const QString& name, Score::FileError error, bool ask
             }
        if (converterMode || pluginMode) {
             fprintf(stderr, "%s\n", qPrintable(msg));
+            MScore::lastError = msg;      // reported per entry of a conversion job
             return false;
             }
       QMessageBox msgBox;
@@ -377,7 +379,7 @@ MasterScore* MuseScore::readScore(const QString& name)
             return 0;
             }
       allowShowMidiPanel(name);
-      if (score)
+      if (score && !MScore::noGui)
             addRecentScore(score);
 
       return score;
@@ -456,9 +458,7 @@ bool MuseScore::saveFile(MasterScore* score)
             tab2->setTabText(idx, score->fileInfo()->completeBaseName());
       QString tmp = score->tmpName();
       if (!tmp.isEmpty()) {
-            QFile f(tmp);
-            if (!f.remove())
-                  qDebug("cannot remove temporary file <%s>", qPrintable(f.fileName()));
+            autoSaver->remove(tmp);
             score->setTmpName("");
             }
       writeSessionFile(false);
@@ -1588,6 +1588,7 @@ QString MuseScore::getDrumsetFilename(bool open)
 void MuseScore::printFile()
       {
 #ifndef QT_NO_PRINTER
+      cs->doPendingLayout();
       LayoutMode layoutMode = cs->layoutMode();
       if (layoutMode != LayoutMode::PAGE) {
             cs->setLayoutMode(LayoutMode::PAGE);
@@ -1820,6 +1821,7 @@ bool MuseScore::exportParts()
             }
 
       Score* thisScore = cs->masterScore();
+      Score::doPendingLayouts(thisScore->scoreList(), exportThreads);
       bool overwrite = false;
       bool noToAll = false;
       QString confirmReplaceTitle = tr("Confirm Replace");
@@ -1898,6 +1900,7 @@ bool MuseScore::saveAs(Score* cs_, bool saveCopy, const QString& path, const QSt
       if (!fn.endsWith(suffix))
             fn += suffix;
 
+      cs_->doPendingLayout();
       LayoutMode layoutMode = cs_->layoutMode();
       if (ext == "mscx" || ext == "mscz") {
             // save as mscore *.msc[xz] file
@@ -2157,14 +2160,19 @@ bool MuseScore::savePdf(QList<Score*> cs_, const QString& saveName)
 
       double pr = MScore::pixelRatio;
 
+      // lay out all scores first; parts may be laid out concurrently
+      std::vector<LayoutMode> layoutModes;
+      for (Score* s : cs_) {
+            layoutModes.push_back(s->layoutMode());
+            s->setLayoutMode(LayoutMode::PAGE);
+            s->setLayoutPending(Fraction(0,1), Fraction(-1,1));
+            }
+      Score::doPendingLayouts(cs_, exportThreads);
+
       bool firstPage = true;
+      int scoreIdx = 0;
       for (Score* s : cs_) {
-            LayoutMode layoutMode = s->layoutMode();
-            if (layoutMode != LayoutMode::PAGE) {
-                  s->setLayoutMode(LayoutMode::PAGE);
-            //      s->doLayout();
-                  }
-            s->doLayout();
+            LayoutMode layoutMode = layoutModes[scoreIdx++];
 
             // done in Score::print() also, but do it here as well to be safe
             s->setPrinting(true);
@@ -2614,11 +2622,12 @@ bool MuseScore::savePng(Score* score, const QString& name)
       }
 
 //---------------------------------------------------------
-//   savePng with options
-//    return true on success
+//   renderPng
+//    paint a page into an image; png encoding is left to
+//    the caller so it can run on another thread
 //---------------------------------------------------------
 
-bool MuseScore::savePng(Score* score, QIODevice* device, int pageNumber, bool drawPageBackground)
+QImage MuseScore::renderPng(Score* score, int pageNumber, bool drawPageBackground)
       {
       const bool screenshot = false;
       const bool transparent = preferences.getBool(PREF_EXPORT_PNG_USETRANSPARENCY) && !drawPageBackground;
@@ -2626,7 +2635,6 @@ bool MuseScore::savePng(Score* score, QIODevice* device, int pageNumber, bool dr
       const int localTrimMargin = trimMargin;
       const QImage::Format format = QImage::Format_ARGB32_Premultiplied;
 
-      bool rv = true;
       score->setPrinting(!screenshot);    // don’t print page break symbols etc.
       double pr = MScore::pixelRatio;
 
@@ -2667,6 +2675,7 @@ bool MuseScore::savePng(Score* score, QIODevice* device, int pageNumber, bool dr
       QList< Element*> pel = page->elements();
       qStableSort(pel.begin(), pel.end(), elementLessThan);
       paintElements(p, pel);
+      p.end();
        if (format == QImage::Format_Indexed8) {
             //convert to grayscale & respect alpha
             QVector<QRgb> colorTable;
@@ -2681,10 +2690,19 @@ bool MuseScore::savePng(Score* score, QIODevice* device, int pageNumber, bool dr
                   }
             printer = printer.convertToFormat(QImage::Format_Indexed8, colorTable);
             }
-      printer.save(device, "png");
       score->setPrinting(false);
       MScore::pixelRatio = pr;
-      return rv;
+      return printer;
+      }
+
+//---------------------------------------------------------
+//   savePng with options
+//    return true on success
+//---------------------------------------------------------
+
+bool MuseScore::savePng(Score* score, QIODevice* device, int pageNumber, bool drawPageBackground)
+      {
+      return renderPng(score, pageNumber, drawPageBackground).save(device, "png");
       }
 
 //---------------------------------------------------------
@@ -3241,6 +3259,56 @@ private:
       QFile jsonFormatFile;
 };
 
+//---------------------------------------------------------
+//   OrderedJsonEncoder
+//    Runs the encoding of array values on a thread pool
+//    and writes the results in submission order, so the
+//    output does not depend on the number of threads.
+//    With one thread the values are encoded serially.
+//---------------------------------------------------------
+
+class OrderedJsonEncoder {
+      CustomJsonWriter& _writer;
+      QThreadPool _pool;
+      QList<QFuture<QByteArray>> _pending;
+      int _total;
+      int _written  { 0 };
+      bool _ok      { true };
+
+      void write(const QByteArray& data)
+            {
+            _ok &= !data.isEmpty();
+            _writer.addValue(data, ++_written == _total);
+            }
+
+   public:
+      OrderedJsonEncoder(CustomJsonWriter& writer, int total, int threads)
+         : _writer(writer), _total(total)
+            {
+            _pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+            }
+      ~OrderedJsonEncoder() { finish(); }
+
+      void add(std::function<QByteArray()> job)
+            {
+            if (_pool.maxThreadCount() <= 1) {
+                  write(job());
+                  return;
+                  }
+            // bound the number of rendered pages held in memory
+            while (_pending.size() >= 2 * _pool.maxThreadCount())
+                  write(_pending.takeFirst().result());
+            _pending.append(QtConcurrent::run(&_pool, job));
+            }
+
+      bool finish()
+            {
+            while (!_pending.isEmpty())
+                  write(_pending.takeFirst().result());
+            return _ok;
+            }
+      };
+
 //---------------------------------------------------------
 //   exportMp3AsJSON
 //---------------------------------------------------------
@@ -3306,28 +3374,43 @@ bool MuseScore::exportAllMediaFiles(const QString& inFilePath, const QString& ou
       bool res = true;
       CustomJsonWriter jsonWriter(outFilePath);
       //export score pngs and svgs
+      // Painting uses global state (MScore::pixelRatio, printing flags, font caches)
+      // and stays on this thread; png compression and base64 encoding of a page
+      // run on the thread pool while the next page is painted.
+      const int pages = score->pages().size();
       jsonWriter.addKey("pngs");
       jsonWriter.openArray();
-      for (int i = 0; i < score->pages().size(); ++i) {
-            QByteArray pngData;
-            QBuffer pngDevice(&pngData);
-            pngDevice.open(QIODevice::ReadWrite);
-            res &= mscore->savePng(score.get(), &pngDevice, i, /* drawPageBackground */ true);
-            bool lastArrayValue = ((score->pages().size() - 1) == i);
-            jsonWriter.addValue(pngData.toBase64(), lastArrayValue);
+      {
+      OrderedJsonEncoder encoder(jsonWriter, pages, exportThreads);
+      for (int i = 0; i < pages; ++i) {
+            QImage image = mscore->renderPng(score.get(), i, /* drawPageBackground */ true);
+            encoder.add([image]() {
+                  QByteArray pngData;
+                  QBuffer pngDevice(&pngData);
+                  pngDevice.open(QIODevice::WriteOnly);
+                  if (!image.save(&pngDevice, "png"))
+                        return QByteArray();
+                  return pngData.toBase64();
+                  });
             }
+      res &= encoder.finish();
+      }
       jsonWriter.closeArray();
 
       jsonWriter.addKey("svgs");
       jsonWriter.openArray();
-      for (int i = 0; i < score->pages().size(); ++i) {
+      {
+      OrderedJsonEncoder encoder(jsonWriter, pages, exportThreads);
+      for (int i = 0; i < pages; ++i) {
             QByteArray svgData;
             QBuffer svgDevice(&svgData);
             svgDevice.open(QIODevice::ReadWrite);
             res &= mscore->saveSvg(score.get(), &svgDevice, i, /* drawPageBackground */ true);
-            bool lastArrayValue = ((score->pages().size() - 1) == i);
-            jsonWriter.addValue(svgData.toBase64(), lastArrayValue);
+            svgDevice.close();
+            encoder.add([svgData]() { return svgData.toBase64(); });
             }
+      res &= encoder.finish();
+      }
       jsonWriter.closeArray();
 
       {
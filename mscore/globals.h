@@ -31,6 +31,7 @@ extern bool converterMode;
 extern bool pluginMode;
 extern double guiScaling;
 extern int trimMargin;
+extern int exportThreads;
 extern bool noWebView;
 extern bool ignoreWarnings;
 
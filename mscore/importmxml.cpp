@@ -29,6 +29,7 @@
 #include "importmxmllogger.h"
 #include "importmxmlpass1.h"
 #include "importmxmlpass2.h"
+#include "importmxmlreader.h"
 #include "preferences.h"
 
 namespace Ms {
@@ -43,17 +44,21 @@ Score::FileError importMusicXMLfromBuffer(Score* score, const QString& /*name*/,
       //logger.setLoggingLevel(MxmlLogger::Level::MXML_INFO);
       //logger.setLoggingLevel(MxmlLogger::Level::MXML_TRACE); // also include tracing
 
-      // pass 1
+      // tokenize once, both passes replay the tokens
       dev->seek(0);
+      MxmlEventStream stream;
+      if (!stream.read(dev))
+            logger.logError(QString("XML error: %1").arg(stream.errorString()));
+
+      // pass 1
       MusicXMLParserPass1 pass1(score, &logger);
-      Score::FileError res = pass1.parse(dev);
+      Score::FileError res = pass1.parse(stream);
       if (res != Score::FileError::FILE_NO_ERROR)
             return res;
 
       // pass 2
-      dev->seek(0);
       MusicXMLParserPass2 pass2(score, pass1, &logger);
-      return pass2.parse(dev);
+      return pass2.parse(stream);
       }
 
 } // namespace Ms
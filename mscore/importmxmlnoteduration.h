@@ -19,6 +19,7 @@
 namespace Ms {
 
 class MxmlLogger;
+class MxmlReader;
 
 //---------------------------------------------------------
 //   mxmlNoteDuration
@@ -36,12 +37,12 @@ public:
       Fraction dura() const { return _dura; }
       int dots() const { return _dots; }
       TDuration normalType() const { return _normalType; }
-      bool readProperties(QXmlStreamReader& e);
+      bool readProperties(MxmlReader& e);
       Fraction timeMod() const { return _timeMod; }
 
 private:
-      void duration(QXmlStreamReader& e);
-      void timeModification(QXmlStreamReader& e);
+      void duration(MxmlReader& e);
+      void timeModification(MxmlReader& e);
       const int _divs;                                // the current divisions value
       int _dots = 0;
       Fraction _dura;
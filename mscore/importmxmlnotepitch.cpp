@@ -12,6 +12,7 @@
 
 #include "importmxmllogger.h"
 #include "importmxmlnotepitch.h"
+#include "importmxmlreader.h"
 #include "musicxmlsupport.h"
 
 namespace Ms {
@@ -27,7 +28,7 @@ namespace Ms {
 
 // TODO: split in reading parameters versus creation
 
-static Accidental* accidental(QXmlStreamReader& e, Score* score)
+static Accidental* accidental(MxmlReader& e, Score* score)
       {
       Q_ASSERT(e.isStartElement() && e.name() == "accidental");
 
@@ -59,7 +60,7 @@ static Accidental* accidental(QXmlStreamReader& e, Score* score)
  Handle <display-step> and <display-octave> for <rest> and <unpitched>
  */
 
-void mxmlNotePitch::displayStepOctave(QXmlStreamReader& e)
+void mxmlNotePitch::displayStepOctave(MxmlReader& e)
       {
       Q_ASSERT(e.isStartElement()
                && (e.name() == "rest" || e.name() == "unpitched"));
@@ -97,7 +98,7 @@ void mxmlNotePitch::displayStepOctave(QXmlStreamReader& e)
  Parse the /score-partwise/part/measure/note/pitch node.
  */
 
-void mxmlNotePitch::pitch(QXmlStreamReader& e)
+void mxmlNotePitch::pitch(MxmlReader& e)
       {
       Q_ASSERT(e.isStartElement() && e.name() == "pitch");
 
@@ -155,7 +156,7 @@ void mxmlNotePitch::pitch(QXmlStreamReader& e)
  Return true if handled.
  */
 
-bool mxmlNotePitch::readProperties(QXmlStreamReader& e, Score* score)
+bool mxmlNotePitch::readProperties(MxmlReader& e, Score* score)
       {
       const QStringRef& tag(e.name());
 
@@ -755,14 +755,14 @@ static void fixupSigmap(MxmlLogger* logger, Score* score, const QVector<Fraction
 //---------------------------------------------------------
 
 /**
- Parse MusicXML in \a device and extract pass 1 data.
+ Parse the MusicXML tokens in \a stream and extract pass 1 data.
  */
 
-Score::FileError MusicXMLParserPass1::parse(QIODevice* device)
+Score::FileError MusicXMLParserPass1::parse(const MxmlEventStream& stream)
       {
-      _logger->logDebugTrace("MusicXMLParserPass1::parse device");
+      _logger->logDebugTrace("MusicXMLParserPass1::parse stream");
       _parts.clear();
-      _e.setDevice(device);
+      _e.setStream(&stream);
       auto res = parse();
       if (res != Score::FileError::FILE_NO_ERROR)
             return res;
@@ -1066,7 +1066,7 @@ static QString decodeEntities( const QString& src )
  Read the next part of a MusicXML formatted string and convert to MuseScore internal encoding.
  */
 
-static QString nextPartOfFormattedString(QXmlStreamReader& e)
+static QString nextPartOfFormattedString(MxmlReader& e)
       {
       //QString lang       = e.attribute(QString("xml:lang"), "it");
       QString fontWeight = e.attributes().value("font-weight").toString();
@@ -2208,7 +2208,7 @@ void MusicXMLParserPass1::clef(const QString& /* partId */)
 
 // TODO: share between pass 1 and pass 2
 
-static bool determineTimeSig(MxmlLogger* logger, const QXmlStreamReader* const xmlreader,
+static bool determineTimeSig(MxmlLogger* logger, const MxmlReader* const xmlreader,
                              const QString beats, const QString beatType, const QString timeSymbol,
                              TimeSigType& st, int& bts, int& btp)
       {
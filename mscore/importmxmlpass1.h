@@ -21,6 +21,7 @@
 #define __IMPORTMXMLPASS1_H__
 
 #include "libmscore/score.h"
+#include "importmxmlreader.h"
 #include "importxmlfirstpass.h"
 #include "musicxml.h" // for the creditwords and MusicXmlPartGroupList definitions
 #include "musicxmlsupport.h"
@@ -116,7 +117,7 @@ class MusicXMLParserPass1 {
 public:
       MusicXMLParserPass1(Score* score, MxmlLogger* logger);
       void initPartState(const QString& partId);
-      Score::FileError parse(QIODevice* device);
+      Score::FileError parse(const MxmlEventStream& stream);
       Score::FileError parse();
       void scorePartwise();
       void identification();
@@ -169,7 +170,7 @@ private:
       void setFirstInstr(const QString& id, const Fraction stime);
 
       // generic pass 1 data
-      QXmlStreamReader _e;
+      MxmlReader _e;
       int _divs;                                ///< Current MusicXML divisions value
       QMap<QString, MusicXmlPart> _parts;       ///< Parts data, mapped on part id
       std::set<int> _systemStartMeasureNrs;     ///< Measure numbers of measures starting a page
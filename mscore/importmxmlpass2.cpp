@@ -457,7 +457,7 @@ static Instrument createInstrument(const MusicXMLDrumInstrument& mxmlInstr)
  Set first instrument for Part \a part
  */
 
-static void setFirstInstrument(MxmlLogger* logger, const QXmlStreamReader* const xmlreader,
+static void setFirstInstrument(MxmlLogger* logger, const MxmlReader* const xmlreader,
                                Part* part, const QString& partId,
                                const QString& instrId, const MusicXMLDrumset& mxmlDrumset)
       {
@@ -507,7 +507,7 @@ static void setStaffTypePercussion(Part* part, Drumset* drumset)
 //   setPartInstruments
 //---------------------------------------------------------
 
-static void setPartInstruments(MxmlLogger* logger, const QXmlStreamReader* const xmlreader,
+static void setPartInstruments(MxmlLogger* logger, const MxmlReader* const xmlreader,
                                Part* part, const QString& partId,
                                Score* score, const MusicXmlInstrList& il, const MusicXMLDrumset& mxmlDrumset)
       {
@@ -661,7 +661,7 @@ static QString decodeEntities( const QString& src )
  Read the next part of a MusicXML formatted string and convert to MuseScore internal encoding.
  */
 
-static QString nextPartOfFormattedString(QXmlStreamReader& e)
+static QString nextPartOfFormattedString(MxmlReader& e)
       {
       //QString lang       = e.attribute(QString("xml:lang"), "it");
       QString fontWeight = e.attributes().value("font-weight").toString();
@@ -726,7 +726,7 @@ static QString nextPartOfFormattedString(QXmlStreamReader& e)
  Add a single lyric to the score or delete it (if number too high)
  */
 
-static void addLyric(MxmlLogger* logger, const QXmlStreamReader* const xmlreader,
+static void addLyric(MxmlLogger* logger, const MxmlReader* const xmlreader,
                      ChordRest* cr, Lyrics* l, int lyricNo, MusicXmlLyricsExtend& extendedLyrics)
       {
       if (lyricNo > MAX_LYRICS) {
@@ -749,7 +749,7 @@ static void addLyric(MxmlLogger* logger, const QXmlStreamReader* const xmlreader
  Add a notes lyrics to the score
  */
 
-static void addLyrics(MxmlLogger* logger, const QXmlStreamReader* const xmlreader,
+static void addLyrics(MxmlLogger* logger, const MxmlReader* const xmlreader,
                       ChordRest* cr,
                       const QMap<int, Lyrics*>& numbrdLyrics,
                       const QSet<Lyrics*>& extLyrics,
@@ -1426,13 +1426,13 @@ void MusicXMLParserPass2::skipLogCurrElem()
 //---------------------------------------------------------
 
 /**
- Parse MusicXML in \a device and extract pass 2 data.
+ Parse the MusicXML tokens in \a stream and extract pass 2 data.
  */
 
-Score::FileError MusicXMLParserPass2::parse(QIODevice* device)
+Score::FileError MusicXMLParserPass2::parse(const MxmlEventStream& stream)
       {
       //qDebug("MusicXMLParserPass2::parse()");
-      _e.setDevice(device);
+      _e.setStream(&stream);
       Score::FileError res = parse();
       //qDebug("MusicXMLParserPass2::parse() res %d", int(res));
       return res;
@@ -2259,7 +2259,7 @@ void MusicXMLParserPass2::measureStyle(Measure* measure)
 //   calcTicks
 //---------------------------------------------------------
 
-static Fraction calcTicks(const QString& text, int divs, MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+static Fraction calcTicks(const QString& text, int divs, MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       Fraction dura(0, 0);              // invalid unless set correctly
 
@@ -4050,7 +4050,7 @@ static void addFiguredBassElemens(FiguredBassList& fbl, const Fraction noteStart
 static void addTremolo(ChordRest* cr,
                        const int tremoloNr, const QString& tremoloType,
                        Chord*& tremStart,
-                       MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+                       MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       if (!cr->isChord())
             return;
@@ -5134,7 +5134,7 @@ void MusicXMLParserPass2::backup(Fraction& dura)
 //---------------------------------------------------------
 
 MusicXMLParserLyric::MusicXMLParserLyric(const LyricNumberHandler lyricNumberHandler,
-                                         QXmlStreamReader& e, Score* score, MxmlLogger* logger)
+                                         MxmlReader& e, Score* score, MxmlLogger* logger)
       : _lyricNumberHandler(lyricNumberHandler), _e(e), _score(score), _logger(logger)
       {
       // nothing
@@ -5275,7 +5275,7 @@ void MusicXMLParserNotations::slur()
 //---------------------------------------------------------
 
 static void addSlur(const Notation& notation, SlurStack& slurs, ChordRest* cr, const int tick,
-                    MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+                    MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       auto slurNo = notation.attribute("number").toInt();
       if (slurNo > 0) slurNo--;
@@ -5671,7 +5671,7 @@ void MusicXMLParserNotations::glissandoSlide()
 
 static void addGlissandoSlide(const Notation& notation, Note* note,
                               Glissando* glissandi[MAX_NUMBER_LEVEL][2], MusicXmlSpannerMap& spanners,
-                              MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+                              MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       auto glissandoNumber = notation.attribute("number").toInt();
       if (glissandoNumber > 0) glissandoNumber--;
@@ -5733,7 +5733,7 @@ static void addGlissandoSlide(const Notation& notation, Note* note,
 //---------------------------------------------------------
 
 static void addArpeggio(ChordRest* cr, const QString& arpeggioType,
-                        MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+                        MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       // no support for arpeggio on rest
       if (!arpeggioType.isEmpty() && cr->type() == ElementType::CHORD) {
@@ -5761,7 +5761,7 @@ static void addArpeggio(ChordRest* cr, const QString& arpeggioType,
 
 static void addTie(Score* score, Note* note, const int track,
                    const QString& type, const QString& orientation, const QString& lineType,
-                   Tie*& tie, MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+                   Tie*& tie, MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       Q_ASSERT(note);
 
@@ -5807,7 +5807,7 @@ static void addTie(Score* score, Note* note, const int track,
 static void addWavyLine(ChordRest* cr, const Fraction& tick,
                         const int wavyLineNo, const QString& wavyLineType,
                         MusicXmlSpannerMap& spanners, TrillStack& trills,
-                        MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+                        MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       if (!wavyLineType.isEmpty()) {
             const auto ticks = cr->ticks();
@@ -5869,7 +5869,7 @@ static void addBreath(ChordRest* cr, const Fraction& tick, SymId breath)
 //---------------------------------------------------------
 
 static void addChordLine(Note* note, const QString& chordLineType,
-                         MxmlLogger* logger, const QXmlStreamReader* const xmlreader)
+                         MxmlLogger* logger, const MxmlReader* const xmlreader)
       {
       if (chordLineType != "") {
             if (note) {
@@ -5934,7 +5934,7 @@ QString Notation::print() const
 //   MusicXMLParserNotations
 //---------------------------------------------------------
 
-MusicXMLParserNotations::MusicXMLParserNotations(QXmlStreamReader& e, Score* score, MxmlLogger* logger)
+MusicXMLParserNotations::MusicXMLParserNotations(MxmlReader& e, Score* score, MxmlLogger* logger)
       : _e(e), _score(score), _logger(logger)
       {
       // nothing
@@ -6184,7 +6184,7 @@ void MusicXMLParserNotations::tuplet()
  MusicXMLParserDirection constructor.
  */
 
-MusicXMLParserDirection::MusicXMLParserDirection(QXmlStreamReader& e,
+MusicXMLParserDirection::MusicXMLParserDirection(MxmlReader& e,
                                                  Score* score,
                                                  const MusicXMLParserPass1& pass1,
                                                  MusicXMLParserPass2& pass2,
@@ -115,14 +115,14 @@ private:
 class MusicXMLParserLyric {
 public:
       MusicXMLParserLyric(const LyricNumberHandler lyricNumberHandler,
-                          QXmlStreamReader& e, Score* score, MxmlLogger* logger);
+                          MxmlReader& e, Score* score, MxmlLogger* logger);
       QSet<Lyrics*> extendedLyrics() const { return _extendedLyrics; }
       QMap<int, Lyrics*> numberedLyrics() const { return _numberedLyrics; }
       void parse();
 private:
       void skipLogCurrElem();
       const LyricNumberHandler _lyricNumberHandler;
-      QXmlStreamReader& _e;
+      MxmlReader& _e;
       Score* const _score;                      // the score
       MxmlLogger* _logger;                      ///< Error logger
       QMap<int, Lyrics*> _numberedLyrics; // lyrics with valid number
@@ -173,7 +173,7 @@ using SpannerSet = std::set<Spanner*>;
 
 class MusicXMLParserNotations {
 public:
-      MusicXMLParserNotations(QXmlStreamReader& e, Score* score, MxmlLogger* logger);
+      MusicXMLParserNotations(MxmlReader& e, Score* score, MxmlLogger* logger);
       void parse();
       void addToScore(ChordRest* const cr, Note* const note, const int tick, SlurStack& slurs,
                       Glissando* glissandi[MAX_NUMBER_LEVEL][2], MusicXmlSpannerMap& spanners, TrillStack& trills,
@@ -195,7 +195,7 @@ private:
       void technical();
       void tied();
       void tuplet();
-      QXmlStreamReader& _e;
+      MxmlReader& _e;
       Score* const _score;                      // the score
       MxmlLogger* _logger;                            // the error logger
       MusicXmlTupletDesc _tupletDesc;
@@ -231,7 +231,7 @@ private:
 class MusicXMLParserPass2 {
 public:
       MusicXMLParserPass2(Score* score, MusicXMLParserPass1& pass1, MxmlLogger* logger);
-      Score::FileError parse(QIODevice* device);
+      Score::FileError parse(const MxmlEventStream& stream);
 
       // part specific data interface functions
       void addSpanner(const MusicXmlSpannerDesc& desc);
@@ -283,7 +283,7 @@ private:
 
       // generic pass 2 data
 
-      QXmlStreamReader _e;
+      MxmlReader _e;
       int _divs;                          // the current divisions value
       Score* const _score;                // the score
       MusicXMLParserPass1& _pass1;        // the pass1 results
@@ -326,11 +326,11 @@ private:
 
 class MusicXMLParserDirection {
 public:
-      MusicXMLParserDirection(QXmlStreamReader& e, Score* score, const MusicXMLParserPass1& pass1, MusicXMLParserPass2& pass2, MxmlLogger* logger);
+      MusicXMLParserDirection(MxmlReader& e, Score* score, const MusicXMLParserPass1& pass1, MusicXMLParserPass2& pass2, MxmlLogger* logger);
       void direction(const QString& partId, Measure* measure, const Fraction& tick, const int divisions, MusicXmlSpannerMap& spanners);
 
 private:
-      QXmlStreamReader& _e;
+      MxmlReader& _e;
       Score* const _score;                      // the score
       const MusicXMLParserPass1& _pass1;        // the pass1 results
       MusicXMLParserPass2& _pass2;              // the pass2 results
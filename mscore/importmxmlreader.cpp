@@ -0,0 +1,295 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "importmxmlreader.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   clear
+//---------------------------------------------------------
+
+void MxmlEventStream::clear()
+      {
+      _events.clear();
+      _strings.clear();
+      _strings.append(QString());
+      _attributes.clear();
+      _errorString.clear();
+      }
+
+//---------------------------------------------------------
+//   read
+//---------------------------------------------------------
+
+/**
+ Tokenize the document in \a device from its current position.
+ Return false if it is not well-formed; the tokens up to the
+ error are kept, followed by an Invalid token.
+ */
+
+bool MxmlEventStream::read(QIODevice* device)
+      {
+      clear();
+      QHash<QString, int> index;
+      auto intern = [this, &index](const QStringRef& s) {
+            if (s.isEmpty())
+                  return 0;
+            const QString str = s.toString();
+            auto i = index.constFind(str);
+            if (i != index.constEnd())
+                  return i.value();
+            const int n = _strings.size();
+            _strings.append(str);
+            index.insert(str, n);
+            return n;
+            };
+
+      QXmlStreamReader e(device);
+      while (!e.atEnd()) {
+            const QXmlStreamReader::TokenType type = e.readNext();
+            Event ev;
+            ev.type   = quint8(type);
+            ev.name   = intern(e.name());
+            ev.line   = int(e.lineNumber());
+            ev.column = int(e.columnNumber());
+            if (type == QXmlStreamReader::StartElement) {
+                  ev.data = -1;
+                  const QXmlStreamAttributes attrs = e.attributes();
+                  if (!attrs.isEmpty()) {
+                        // copy the values, the reader's refer to its internal buffer
+                        QXmlStreamAttributes a;
+                        a.reserve(attrs.size());
+                        for (const QXmlStreamAttribute& attr : attrs)
+                              a.append(attr.qualifiedName().toString(), attr.value().toString());
+                        ev.data = _attributes.size();
+                        _attributes.append(a);
+                        }
+                  }
+            else
+                  ev.data = intern(e.text());
+            _events.append(ev);
+            if (type == QXmlStreamReader::Invalid) {
+                  _errorString = e.errorString();
+                  break;
+                  }
+            }
+      _events.squeeze();
+      _strings.squeeze();
+      _attributes.squeeze();
+      return !e.hasError();
+      }
+
+//---------------------------------------------------------
+//   setStream
+//---------------------------------------------------------
+
+/**
+ Start replaying \a stream from the beginning.
+ */
+
+void MxmlReader::setStream(const MxmlEventStream* stream)
+      {
+      _stream = stream;
+      _pos    = -1;
+      _error  = false;
+      _errorString.clear();
+      }
+
+//---------------------------------------------------------
+//   current
+//---------------------------------------------------------
+
+const MxmlEventStream::Event& MxmlReader::current() const
+      {
+      static const MxmlEventStream::Event none { quint8(QXmlStreamReader::NoToken), 0, -1, 0, 0 };
+      if (!_stream || _pos < 0 || _stream->size() == 0)
+            return none;
+      return _stream->event(qMin(_pos, _stream->size() - 1));
+      }
+
+//---------------------------------------------------------
+//   tokenType
+//---------------------------------------------------------
+
+QXmlStreamReader::TokenType MxmlReader::tokenType() const
+      {
+      if (_error)
+            return QXmlStreamReader::Invalid;
+      if (!_stream || _pos < 0)
+            return QXmlStreamReader::NoToken;
+      if (_pos >= _stream->size())
+            return QXmlStreamReader::Invalid;
+      return QXmlStreamReader::TokenType(_stream->event(_pos).type);
+      }
+
+//---------------------------------------------------------
+//   readNext
+//---------------------------------------------------------
+
+/**
+ Advance to the next token. Past the end of the document or
+ after an error the token stays Invalid.
+ */
+
+QXmlStreamReader::TokenType MxmlReader::readNext()
+      {
+      if (!_stream || tokenType() == QXmlStreamReader::Invalid)
+            return QXmlStreamReader::Invalid;
+      ++_pos;
+      return tokenType();
+      }
+
+//---------------------------------------------------------
+//   readNextStartElement
+//---------------------------------------------------------
+
+/**
+ Read until the next start element within the current
+ element; return false at the end of the current element.
+ */
+
+bool MxmlReader::readNextStartElement()
+      {
+      while (readNext() != QXmlStreamReader::Invalid) {
+            if (isEndElement())
+                  return false;
+            else if (isStartElement())
+                  return true;
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   skipCurrentElement
+//---------------------------------------------------------
+
+void MxmlReader::skipCurrentElement()
+      {
+      int depth = 1;
+      while (depth && readNext() != QXmlStreamReader::Invalid) {
+            if (isEndElement())
+                  --depth;
+            else if (isStartElement())
+                  ++depth;
+            }
+      }
+
+//---------------------------------------------------------
+//   readElementText
+//---------------------------------------------------------
+
+/**
+ Read the text of a text-only element, like
+ QXmlStreamReader::readElementText(ErrorOnUnexpectedElement).
+ */
+
+QString MxmlReader::readElementText()
+      {
+      if (!isStartElement())
+            return QString();
+      QString result;
+      forever {
+            switch (readNext()) {
+                  case QXmlStreamReader::Characters:
+                  case QXmlStreamReader::EntityReference:
+                        result += _stream->string(current().data);
+                        break;
+                  case QXmlStreamReader::EndElement:
+                        return result;
+                  case QXmlStreamReader::ProcessingInstruction:
+                  case QXmlStreamReader::Comment:
+                        break;
+                  default:
+                        if (!hasError())
+                              raiseError(QObject::tr("Expected character data."));
+                        return result;
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   raiseError
+//---------------------------------------------------------
+
+void MxmlReader::raiseError(const QString& message)
+      {
+      _error       = true;
+      _errorString = message;
+      }
+
+//---------------------------------------------------------
+//   atEnd
+//---------------------------------------------------------
+
+bool MxmlReader::atEnd() const
+      {
+      const QXmlStreamReader::TokenType type = tokenType();
+      return type == QXmlStreamReader::EndDocument || type == QXmlStreamReader::Invalid;
+      }
+
+//---------------------------------------------------------
+//   hasError
+//---------------------------------------------------------
+
+bool MxmlReader::hasError() const
+      {
+      return _error || (_stream && !_stream->errorString().isEmpty() && _pos >= _stream->size() - 1);
+      }
+
+//---------------------------------------------------------
+//   errorString
+//---------------------------------------------------------
+
+QString MxmlReader::errorString() const
+      {
+      if (_error)
+            return _errorString;
+      return hasError() ? _stream->errorString() : QString();
+      }
+
+//---------------------------------------------------------
+//   name
+//---------------------------------------------------------
+
+QStringRef MxmlReader::name() const
+      {
+      if (!_stream)
+            return QStringRef();
+      return QStringRef(&_stream->string(current().name));
+      }
+
+//---------------------------------------------------------
+//   text
+//---------------------------------------------------------
+
+QStringRef MxmlReader::text() const
+      {
+      const MxmlEventStream::Event& ev = current();
+      if (!_stream || ev.type == QXmlStreamReader::StartElement || ev.type == QXmlStreamReader::NoToken)
+            return QStringRef();
+      return QStringRef(&_stream->string(ev.data));
+      }
+
+//---------------------------------------------------------
+//   attributes
+//---------------------------------------------------------
+
+QXmlStreamAttributes MxmlReader::attributes() const
+      {
+      const MxmlEventStream::Event& ev = current();
+      if (!_stream || ev.type != QXmlStreamReader::StartElement || ev.data < 0)
+            return QXmlStreamAttributes();
+      return _stream->attributes(ev.data);
+      }
+
+} // namespace Ms
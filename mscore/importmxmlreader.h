@@ -0,0 +1,99 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __IMPORTMXMLREADER_H__
+#define __IMPORTMXMLREADER_H__
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   MxmlEventStream
+//---------------------------------------------------------
+
+/**
+ The tokens of a MusicXML document, read once with a
+ QXmlStreamReader and replayed by every import pass through
+ an MxmlReader. Element names and texts are stored once.
+ */
+
+class MxmlEventStream {
+public:
+      struct Event {
+            quint8 type;                  ///< QXmlStreamReader::TokenType
+            int name;                     ///< index in _strings
+            int data;                     ///< start element: index in _attributes or -1, else text index in _strings
+            int line;
+            int column;
+            };
+
+      MxmlEventStream() { clear(); }
+      bool read(QIODevice* device);
+      void clear();
+      int size() const { return _events.size(); }
+      const Event& event(int i) const { return _events[i]; }
+      const QString& string(int i) const { return _strings[i]; }
+      const QXmlStreamAttributes& attributes(int i) const { return _attributes[i]; }
+      QString errorString() const { return _errorString; }
+
+private:
+      QVector<Event> _events;
+      QVector<QString> _strings;          ///< _strings[0] is empty
+      QVector<QXmlStreamAttributes> _attributes;
+      QString _errorString;
+      };
+
+//---------------------------------------------------------
+//   MxmlReader
+//---------------------------------------------------------
+
+/**
+ Replays an MxmlEventStream with the part of the
+ QXmlStreamReader interface the import passes use, with the
+ same semantics.
+ */
+
+class MxmlReader {
+public:
+      MxmlReader() {}
+      void setStream(const MxmlEventStream* stream);
+
+      QXmlStreamReader::TokenType readNext();
+      bool readNextStartElement();
+      void skipCurrentElement();
+      QString readElementText();
+      void raiseError(const QString& message = QString());
+
+      QXmlStreamReader::TokenType tokenType() const;
+      bool isStartElement() const { return tokenType() == QXmlStreamReader::StartElement; }
+      bool isEndElement() const   { return tokenType() == QXmlStreamReader::EndElement;   }
+      bool isCharacters() const   { return tokenType() == QXmlStreamReader::Characters;   }
+      bool atEnd() const;
+      bool hasError() const;
+      QString errorString() const;
+
+      QStringRef name() const;
+      QStringRef text() const;
+      QXmlStreamAttributes attributes() const;
+      qint64 lineNumber() const   { return current().line;   }
+      qint64 columnNumber() const { return current().column; }
+
+private:
+      const MxmlEventStream::Event& current() const;
+
+      const MxmlEventStream* _stream { nullptr };
+      int _pos { -1 };
+      bool _error { false };              ///< raised while replaying
+      QString _errorString;
+      };
+
+} // namespace Ms
+#endif
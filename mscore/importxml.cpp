@@ -23,6 +23,7 @@
 
 #include "thirdparty/qzip/qzipreader_p.h"
 #include "importmxml.h"
+#include "preferences.h"
 
 namespace Ms {
 
@@ -93,6 +94,24 @@ static bool initMusicXmlSchema(QXmlSchema& schema)
       }
 
 
+//---------------------------------------------------------
+//   musicXmlSchema
+//    return nullptr on error
+//---------------------------------------------------------
+
+/**
+ Return the MusicXML schema, compiled on first use and
+ kept for the lifetime of the process.
+ */
+
+static const QXmlSchema* musicXmlSchema()
+      {
+      static QXmlSchema schema;
+      static const bool valid = initMusicXmlSchema(schema);
+      return valid ? &schema : nullptr;
+      }
+
+
 //---------------------------------------------------------
 //   musicXMLValidationErrorDialog
 //---------------------------------------------------------
@@ -185,15 +204,20 @@ static Score::FileError doValidate(const QString& name, QIODevice* dev)
       QTime t;
       t.start();
 
-      // initialize the schema
-      ValidatorMessageHandler messageHandler;
-      QXmlSchema schema;
-      schema.setMessageHandler(&messageHandler);
-      if (!initMusicXmlSchema(schema))
-            return Score::FileError::FILE_BAD_FORMAT;  // appropriate error message has been printed by initMusicXmlSchema
+      // get the schema
+      const QXmlSchema* schema = musicXmlSchema();
+      if (!schema) {
+            MScore::lastError = QObject::tr("Internal error: MusicXML schema is invalid\n");
+            return Score::FileError::FILE_BAD_FORMAT;
+            }
 
-      // validate the data
-      QXmlSchemaValidator validator(schema);
+      // validate the data; the shared schema is used by one
+      // validator at a time, imports may run on worker threads
+      static QMutex schemaMutex;
+      QMutexLocker locker(&schemaMutex);
+      ValidatorMessageHandler messageHandler;
+      QXmlSchemaValidator validator(*schema);
+      validator.setMessageHandler(&messageHandler);
       bool valid = validator.validate(dev, QUrl::fromLocalFile(name));
       //qDebug("Validation time elapsed: %d ms", t.elapsed());
 
@@ -223,11 +247,13 @@ static Score::FileError doValidateAndImport(Score* score, const QString& name, Q
       // verify tuplet TDuration::DurationType dependencies
       tupletAssert();
 
-      // validate the file
-      Score::FileError res;
-      res = doValidate(name, dev);
-      if (res != Score::FileError::FILE_NO_ERROR)
-            return res;
+      // validate the file, unless disabled in converter mode
+      Score::FileError res = Score::FileError::FILE_NO_ERROR;
+      if (!MScore::noGui || preferences.getBool(PREF_IMPORT_MUSICXML_VALIDATE)) {
+            res = doValidate(name, dev);
+            if (res != Score::FileError::FILE_NO_ERROR)
+                  return res;
+            }
 
       // actually do the import
       importMusicXMLfromBuffer(score, name, dev);
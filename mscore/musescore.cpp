@@ -14,6 +14,8 @@
 #include "network/loginmanager.h"
 #include "uploadscoredialog.h"
 #include <QStyleFactory>
+#include <QLocalServer>
+#include <QLocalSocket>
 #include "config.h"
 #include "musescore.h"
 #include "musescoredialogs.h"
@@ -53,6 +55,7 @@
 #include "pianoroll.h"
 #include "drumroll.h"
 #include "scoretab.h"
+#include "autosave.h"
 #include "timedialog.h"
 #include "keyedit.h"
 #include "harmonyedit.h"
@@ -65,6 +68,7 @@
 #include "scorecmp/scorecmp.h"
 #include "script/recorderwidget.h"
 #include "libmscore/scorediff.h"
+#include "libmscore/scorejournal.h"
 #include "libmscore/chord.h"
 #include "libmscore/segment.h"
 #include "editraster.h"
@@ -117,6 +121,7 @@
 #include "synthesizer/msynthesizer.h"
 #include "synthesizer/event.h"
 #include "fluid/fluid.h"
+#include "zerberus/zerberus.h"
 #include "plugin/qmlplugin.h"
 #include "accessibletoolbutton.h"
 #include "toolbuttonmenu.h"
@@ -140,6 +145,9 @@
 #ifdef Q_OS_MAC
 #include "macos/cocoabridge.h"
 #endif
+#if defined(Q_OS_UNIX) && !defined(Q_OS_LINUX)
+#include <sys/resource.h>
+#endif
 
 #ifdef AEOLUS
 extern Ms::Synthesizer* createAeolus();
@@ -187,6 +195,9 @@ static bool startWithNewScore = false;
 double guiScaling = 0.0;
 static double userDPI = 0.0;
 int trimMargin = -1;
+int exportThreads = 0;        // 0: idealThreadCount() for page images, serial audio export and part layout
+static int convertJobs = 1;   // job file entries converted in parallel
+static bool memoryReport = false;   // print element counts and pools of converted scores
 bool noWebView = false;
 bool exportScoreParts = false;
 bool ignoreWarnings = false;
@@ -201,6 +212,7 @@ QString mscoreGlobalShare;
 
 static QString outFileName;
 static QString jsonFileName;
+static QString serverName;
 static QString audioDriver;
 static QString pluginName;
 static QString styleFile;
@@ -379,11 +391,12 @@ void MuseScore::closeEvent(QCloseEvent* ev)
             }
 
       writeSessionFile(true);
+      autoSaver->waitForFinished();
+      if (MScore::debugMode)
+            qDebug("%s", qPrintable(autoSaver->stallHistogramText()));
       for (MasterScore* score : scoreList) {
-            if (!score->tmpName().isEmpty()) {
-                  QFile f(score->tmpName());
-                  f.remove();
-                  }
+            if (!score->tmpName().isEmpty())
+                  autoSaver->remove(score->tmpName());
             }
 
       writeSettings();
@@ -513,6 +526,12 @@ void MuseScore::preferencesChanged(bool fromWorkspace)
       reloadInstrumentTemplates();
       updateInstrumentDialog();
 
+      // reloads the loaded instruments if the preload changed
+      if (synti) {
+            if (Zerberus* zerberus = static_cast<Zerberus*>(synti->synthesizer("Zerberus")))
+                  zerberus->setStreamPreload(preferences.getInt(PREF_IO_ZERBERUS_STREAMPRELOAD));
+            }
+
       if (seq)
             seq->preferencesChanged();
       }
@@ -1922,6 +1941,7 @@ MuseScore::MuseScore()
       connect(cb, SIGNAL(dataChanged()), SLOT(clipboardChanged()));
       connect(cb, SIGNAL(selectionChanged()), SLOT(clipboardChanged()));
 
+      autoSaver     = new AutoSaver;
       autoSaveTimer = new QTimer(this);
       autoSaveTimer->setSingleShot(true);
       connect(autoSaveTimer, SIGNAL(timeout()), this, SLOT(autoSaveTimerTimeout()));
@@ -1970,6 +1990,9 @@ MuseScore::~MuseScore()
       delete synti;
       synti = nullptr;
 
+      delete autoSaver;       // waits for a running autosave
+      autoSaver = nullptr;
+
       // A crash is possible if paletteWorkspace gets
       // deleted before paletteWidget, so force the widget
       // be deleted before paletteWorkspace.
@@ -3260,11 +3283,10 @@ void MuseScore::removeTab(int i)
       else
             setCurrentScoreView((firstTab ? tab1 : tab2)->view());
       writeSessionFile(false);
-      if (!tmpName.isEmpty()) {
-            QFile f(tmpName);
-            f.remove();
-            }
+      if (!tmpName.isEmpty())
+            autoSaver->remove(tmpName);
       delete score;
+      ElementPool::trimAll();       // return the pool slabs emptied by the closed score
       // Shouldn't be necessary... but fix #21841
       update();
       }
@@ -3678,8 +3700,12 @@ static bool convert(const QString& inFile, const QJsonArray& outFiles, const QSt
             }
       bool success = doConvert(score, outFiles, plugin);
       fprintf(stderr, success ? "... success!\n" : "... failed!\n");
-      if (plugin.isEmpty())
+      if (memoryReport)
+            fprintf(stderr, "%s", qPrintable(score->memoryReport()));
+      if (plugin.isEmpty()) {
             delete score;
+            ElementPool::trimAll();
+            }
       else
             mscore->closeScore(score);
       mscore->setCurrentScore(nullptr);
@@ -3694,8 +3720,89 @@ static bool convert(const QString& inFile, const QString& outFile)
             return convert(inFile, QJsonArray{ outFile });
       }
 
+//---------------------------------------------------------
+//   ConvertJob
+//    one entry of a conversion job
+//---------------------------------------------------------
+
+struct ConvertJob {
+      QString inFile;
+      QJsonArray outFiles;
+      QString plugin;
+      };
+
+//---------------------------------------------------------
+//   readConvertJob
+//    return an error message, empty on success
+//---------------------------------------------------------
+
+static QString readConvertJob(const QJsonValue& value, ConvertJob& job)
+      {
+      if (!value.isObject())
+            return "array value is not an object";
+      QJsonObject obj = value.toObject();
+      for (const auto& key : obj.keys()) {
+            if (key == "in")
+                  job.inFile = obj.value(key).toString();
+            else if (key == "out") {
+                  if (obj.value(key).isArray())
+                        job.outFiles = obj.value(key).toArray();
+                  else
+                        job.outFiles.push_back(obj.value(key));
+                  }
+            else if (key == "plugin")
+                  job.plugin = obj.value(key).toString();
+            else
+                  return QString("unknown key <%1>").arg(key);
+            }
+      return QString();
+      }
+
+//---------------------------------------------------------
+//   canConvertInWorker
+//    Plugins run in the QML engine of the main thread and
+//    importers other than MusicXML keep global state, so
+//    such entries are converted on the main thread.
+//---------------------------------------------------------
+
+static bool canConvertInWorker(const ConvertJob& job)
+      {
+      if (!job.plugin.isEmpty())
+            return false;
+      const QString suffix = QFileInfo(job.inFile).suffix().toLower();
+      return suffix == "mscz" || suffix == "mscx"
+         || suffix == "xml" || suffix == "musicxml" || suffix == "mxl";
+      }
+
+//---------------------------------------------------------
+//   convertInWorker
+//    convert on a worker thread, without making the score
+//    the current score of the main window
+//---------------------------------------------------------
+
+static bool convertInWorker(const ConvertJob& job, double pixelRatio)
+      {
+      MScore::pixelRatio = pixelRatio;
+      if (job.inFile.isEmpty() || job.outFiles.isEmpty()) {
+            fprintf(stderr, "cannot convert <%s>: no out given\n", qPrintable(job.inFile));
+            return false;
+            }
+      fprintf(stderr, "convert <%s>...\n", qPrintable(job.inFile));
+      std::unique_ptr<MasterScore> score(mscore->readScore(job.inFile));
+      if (!score)
+            return false;
+      bool success = doConvert(score.get(), job.outFiles, QString());
+      fprintf(stderr, success ? "... <%s> success!\n" : "... <%s> failed!\n", qPrintable(job.inFile));
+      if (memoryReport)
+            fprintf(stderr, "%s", qPrintable(score->memoryReport()));
+      return success;
+      }
+
 //---------------------------------------------------------
 //   doProcessJob
+//    Convert all entries of the job file, convertJobs of
+//    them at a time. A failed entry does not stop the
+//    others; the failures are reported at the end.
 //---------------------------------------------------------
 
 static bool doProcessJob(QString jsonFile)
@@ -3716,36 +3823,217 @@ static bool doProcessJob(QString jsonFile)
             fprintf(stderr, "json file <%s> is not an array\n", qPrintable(jsonFile));
             return false;
             }
-      QJsonArray a = doc.array();
-      for (const auto i : a) {
-            QString inFile;
-            QJsonArray outFiles;
-            QString plugin;
-            if (!i.isObject()) {
-                  fprintf(stderr, "array value is not an object\n");
+      const QJsonArray a = doc.array();
+      const int n = a.size();
+      std::vector<ConvertJob> jobs(n);
+      std::vector<QString> errors(n);
+      std::vector<char> success(n, false);      // not bool: elements are written concurrently
+
+      QThreadPool pool;
+      pool.setMaxThreadCount(qMax(convertJobs, 1));
+      const bool parallel = convertJobs > 1;
+      const double pixelRatio = MScore::pixelRatio;
+      QList<int> serial;
+      for (int i = 0; i < n; ++i) {
+            errors[i] = readConvertJob(a[i], jobs[i]);
+            if (!errors[i].isEmpty())
+                  continue;
+            if (!parallel || !canConvertInWorker(jobs[i])) {
+                  serial.append(i);
+                  continue;
+                  }
+            QtConcurrent::run(&pool, [&jobs, &errors, &success, i, pixelRatio]() {
+                  MScore::lastError.clear();
+                  success[i] = convertInWorker(jobs[i], pixelRatio);
+                  if (!success[i])
+                        errors[i] = MScore::lastError;
+                  });
+            }
+      // the remaining entries run here while the workers are busy
+      for (int i : serial) {
+            MScore::lastError.clear();
+            success[i] = convert(jobs[i].inFile, jobs[i].outFiles, jobs[i].plugin);
+            if (!success[i])
+                  errors[i] = MScore::lastError;
+            }
+      pool.waitForDone();
+      ElementPool::trimAll();
+
+      int failed = 0;
+      for (int i = 0; i < n; ++i) {
+            if (success[i])
+                  continue;
+            ++failed;
+            fprintf(stderr, "job entry %d <%s> failed", i, qPrintable(jobs[i].inFile));
+            if (!errors[i].isEmpty())
+                  fprintf(stderr, ": %s", qPrintable(errors[i].simplified()));
+            fprintf(stderr, "\n");
+            }
+      if (failed)
+            fprintf(stderr, "%d of %d job entries failed\n", failed, n);
+      return failed == 0;
+      }
+
+//---------------------------------------------------------
+//   resetPeakRss
+//---------------------------------------------------------
+
+static void resetPeakRss()
+      {
+#ifdef Q_OS_LINUX
+      // since Linux 4.0, writing 5 resets VmHWM to the current RSS
+      QFile f("/proc/self/clear_refs");
+      if (f.open(QIODevice::WriteOnly))
+            f.write("5");
+#endif
+      }
+
+//---------------------------------------------------------
+//   peakRss
+//    peak resident set size in kB since the last
+//    resetPeakRss(), or of the process where it cannot
+//    be reset; -1 if unknown
+//---------------------------------------------------------
+
+static qint64 peakRss()
+      {
+#if defined(Q_OS_LINUX)
+      QFile f("/proc/self/status");
+      if (f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            for (QByteArray line = f.readLine(); !line.isEmpty(); line = f.readLine()) {
+                  if (line.startsWith("VmHWM:"))
+                        return line.mid(6).trimmed().split(' ').first().toLongLong();
+                  }
+            }
+      return -1;
+#elif defined(Q_OS_UNIX)
+      struct rusage ru;
+      if (getrusage(RUSAGE_SELF, &ru) != 0)
+            return -1;
+#ifdef Q_OS_MAC
+      return ru.ru_maxrss / 1024;         // bytes on macOS
+#else
+      return ru.ru_maxrss;
+#endif
+#else
+      return -1;
+#endif
+      }
+
+//---------------------------------------------------------
+//   serveJob
+//    run one conversion job and return its result
+//---------------------------------------------------------
+
+static QJsonObject serveJob(const QJsonValue& value)
+      {
+      ConvertJob job;
+      QString error = readConvertJob(value, job);
+      QJsonObject result;
+      result["in"] = job.inFile;
+      if (!error.isEmpty()) {
+            result["success"] = false;
+            result["error"]   = error;
+            return result;
+            }
+
+      MScore::lastError.clear();
+      resetPeakRss();
+      QElapsedTimer timer;
+      timer.start();
+      // convert() reads the score and deletes it when done,
+      // so nothing of it is left for the next job
+      bool success = convert(job.inFile, job.outFiles, job.plugin);
+      result["success"] = success;
+      if (!success && !MScore::lastError.isEmpty())
+            result["error"] = MScore::lastError;
+      result["timeMs"] = double(timer.nsecsElapsed()) / 1e6;
+      qint64 rss = peakRss();
+      if (rss >= 0)
+            result["peakRssKb"] = rss;
+      return result;
+      }
+
+//---------------------------------------------------------
+//   serveRequest
+//    a request is one line holding a job object or an
+//    array of them as in a job file; the response has
+//    one line per job
+//---------------------------------------------------------
+
+static QByteArray serveRequest(const QByteArray& line)
+      {
+      QByteArray response;
+      QJsonParseError pe;
+      QJsonDocument doc = QJsonDocument::fromJson(line, &pe);
+      if (pe.error != QJsonParseError::NoError) {
+            QJsonObject result;
+            result["success"] = false;
+            result["error"]   = QString("error reading request at %1: %2").arg(pe.offset).arg(pe.errorString());
+            response += QJsonDocument(result).toJson(QJsonDocument::Compact) + '\n';
+            }
+      else if (doc.isArray()) {
+            for (const auto i : doc.array())
+                  response += QJsonDocument(serveJob(i)).toJson(QJsonDocument::Compact) + '\n';
+            }
+      else
+            response += QJsonDocument(serveJob(doc.object())).toJson(QJsonDocument::Compact) + '\n';
+      return response;
+      }
+
+//---------------------------------------------------------
+//   doServe
+//    Converter server: read job requests as JSON lines
+//    from stdin (name "-") or from the local socket
+//    \a name and answer each with its results.
+//    Fonts, instrument templates, styles and soundfont
+//    samples stay loaded between jobs.
+//---------------------------------------------------------
+
+static bool doServe(const QString& name)
+      {
+      if (name == "-") {
+            QFile in;
+            QFile out;
+            if (!in.open(stdin, QIODevice::ReadOnly) || !out.open(stdout, QIODevice::WriteOnly))
                   return false;
+            for (QByteArray line = in.readLine(); !line.isEmpty(); line = in.readLine()) {
+                  line = line.trimmed();
+                  if (line.isEmpty())
+                        continue;
+                  out.write(serveRequest(line));
+                  out.flush();
                   }
-            QJsonObject obj = i.toObject();
-            for (const auto& key : obj.keys()) {
-                  if (key == "in")
-                        inFile = obj.value(key).toString();
-                  else if (key == "out") {
-                        if (obj.value(key).isArray())
-                              outFiles = obj.value(key).toArray();
-                        else
-                              outFiles.push_back(obj.value(key));
-                        }
-                  else if (key == "plugin")
-                        plugin = obj.value(key).toString();
-                  else {
-                        fprintf(stderr, "unknown key <%s>\n", qPrintable(key));
-                        return false;
+            return true;
+            }
+
+      QLocalServer server;
+      QLocalServer::removeServer(name);
+      if (!server.listen(name)) {
+            fprintf(stderr, "cannot listen on <%s>: %s\n", qPrintable(name), qPrintable(server.errorString()));
+            return false;
+            }
+      fprintf(stderr, "listening on <%s>\n", qPrintable(server.fullServerName()));
+      while (server.waitForNewConnection(-1)) {
+            QLocalSocket* socket = server.nextPendingConnection();
+            if (!socket)
+                  continue;
+            for (;;) {
+                  if (!socket->canReadLine()) {
+                        if (!socket->waitForReadyRead(-1))
+                              break;
+                        continue;
                         }
+                  QByteArray line = socket->readLine().trimmed();
+                  if (line.isEmpty())
+                        continue;
+                  socket->write(serveRequest(line));
+                  socket->waitForBytesWritten(-1);
                   }
-            if (!convert(inFile, outFiles, plugin))
-                  return false;
+            delete socket;
             }
-      return true;
+      fprintf(stderr, "server <%s> stopped: %s\n", qPrintable(name), qPrintable(server.errorString()));
+      return false;
       }
 
 //---------------------------------------------------------
@@ -3792,6 +4080,8 @@ static bool processNonGui(const QStringList& argv)
             }
 
       if (converterMode) {
+            if (!serverName.isEmpty())
+                  return doServe(serverName);
             if (processJob)
                   return doProcessJob(jsonFileName);
             else
@@ -5057,12 +5347,7 @@ void MuseScore::autoSaveTimerTimeout()
             if (s->autosaveDirty()) {
                   qDebug("<%s>", qPrintable(s->fileInfo()->completeBaseName()));
                   QString tmp = s->tmpName();
-                  if (!tmp.isEmpty()) {
-                        QFileInfo fi(tmp);
-                        // TODO: cannot catch exception here:
-                        s->saveCompressedFile(fi, false);
-                        }
-                  else {
+                  if (tmp.isEmpty()) {
                         QDir dir;
                         dir.mkpath(dataPath);
                         QTemporaryFile tf(dataPath + "/scXXXXXX.mscz");
@@ -5071,13 +5356,19 @@ void MuseScore::autoSaveTimerTimeout()
                               qDebug("autoSaveTimerTimeout(): create temporary file failed");
                               return;
                               }
-                        s->setTmpName(tf.fileName());
-                        QFileInfo info(tf.fileName());
-                        s->saveCompressedFile(&tf, info, false, false);  // no thumbnail
                         tf.close();
+                        tmp = tf.fileName();
+                        s->setTmpName(tmp);
                         sessionChanged = true;
                         }
-                  s->setAutosaveDirty(false);
+                  else if (autoSaver->busy(tmp)) {
+                        // previous autosave still compressing, try again next time
+                        continue;
+                        }
+                  // serialize here, compress and write in the background
+                  // TODO: cannot catch exception here:
+                  if (autoSaver->save(s, tmp))
+                        s->setAutosaveDirty(false);
                   }
             }
       if (sessionChanged)
@@ -5165,7 +5456,9 @@ bool MuseScore::restoreSession(bool always)
                                     else if (t == "dirty")
                                           /*int dirty =*/ e.readInt();
                                     else if (t == "path") {
-                                          MasterScore* score = readScore(e.readElementText());
+                                          QString path = e.readElementText();
+                                          ScoreJournal::recover(path);
+                                          MasterScore* score = readScore(path);
                                           if (score) {
                                                 if (!name.isEmpty()) {
                                                       QFileInfo* fi = score->masterScore()->fileInfo();
@@ -6854,7 +7147,7 @@ bool MuseScore::saveMp3(Score* score, QIODevice* device, bool& wasCanceled)
       const bool useCurrentSynthesizerState = !MScore::noGui;
 
       if (useCurrentSynthesizerState) {
-            score->renderMidi(&events, synthesizerState());
+            score->renderMidi(&events, synthesizerState(), exportThreads);
             if (events.empty())
                   return false;
             }
@@ -6895,6 +7188,7 @@ bool MuseScore::saveMp3(Score* score, QIODevice* device, bool& wasCanceled)
 
       int channels = 2;
 
+      QMutexLocker sampleRateLocker(&sampleRateMutex);
       int oldSampleRate = MScore::sampleRate;
       int sampleRate = preferences.getInt(PREF_EXPORT_AUDIO_SAMPLERATE);
       exporter.setBitrate(preferences.getInt(PREF_EXPORT_MP3_BITRATE));
@@ -6916,6 +7210,7 @@ bool MuseScore::saveMp3(Score* score, QIODevice* device, bool& wasCanceled)
       MasterSynthesizer* synth = synthesizerFactory();
       synth->init();
       synth->setSampleRate(sampleRate);
+      synth->setOfflineRendering(true);
       if (MScore::noGui) { // use score settings if possible
             bool r = synth->setState(score->synthesizerState());
             if (!r)
@@ -6931,7 +7226,7 @@ bool MuseScore::saveMp3(Score* score, QIODevice* device, bool& wasCanceled)
 
       if (!useCurrentSynthesizerState) {
             score->masterScore()->rebuildAndUpdateExpressive(synth->synthesizer("Fluid"));
-            score->renderMidi(&events, score->synthesizerState());
+            score->renderMidi(&events, score->synthesizerState(), exportThreads);
             if (synti)
                   score->masterScore()->rebuildAndUpdateExpressive(synti->synthesizer("Fluid"));
 
@@ -7319,6 +7614,8 @@ MuseScoreApplication::CommandLineParseResult MuseScoreApplication::parseCommandL
       parser.addOption(QCommandLineOption({"R", "revert-settings"}, "Revert to factory settings, but keep default preferences"));
       parser.addOption(QCommandLineOption({"i", "load-icons"}, "Load icons from INSTALLPATH/icons"));
       parser.addOption(QCommandLineOption({"j", "job"}, "Process a conversion job", "file"));
+      parser.addOption(QCommandLineOption(      "jobs", "Used with '-j'. Number of job entries converted in parallel", "count"));
+      parser.addOption(QCommandLineOption(      "serve", "Run as converter server: read jobs as JSON lines, with the schema of a job file, from stdin ('-') or the local socket 'name' and write one JSON result line per job", "name"));
       parser.addOption(QCommandLineOption({"e", "experimental"}, "Enable experimental features"));
       parser.addOption(QCommandLineOption({"c", "config-folder"}, "Override configuration and settings folder", "dir"));
       parser.addOption(QCommandLineOption({"t", "test-mode"}, "Set test mode flag for all files")); // this includes --template-mode
@@ -7331,6 +7628,8 @@ MuseScoreApplication::CommandLineParseResult MuseScoreApplication::parseCommandL
       parser.addOption(QCommandLineOption({"b", "bitrate"}, "Used with '-o <file>.mp3', sets bitrate, in kbps", "bitrate"));
       parser.addOption(QCommandLineOption({"E", "install-extension"}, "Install an extension, load soundfont as default unless if -e is passed too", "extension file"));
       parser.addOption(QCommandLineOption("score-media", "Export all media (excepting mp3) for a given score in a single JSON file and print it to std out"));
+      parser.addOption(QCommandLineOption("threads", "Used with '--score-media', audio export and PDF export of parts. Number of worker threads, 1 exports serially", "count"));
+      parser.addOption(QCommandLineOption("memory-report", "Used with '-o' or '-j'. Print the elements of each converted score by type, and the element pools, to stderr"));
       parser.addOption(QCommandLineOption("score-meta", "Export score metadata to JSON document and print it to stdout"));
       parser.addOption(QCommandLineOption("score-mp3", "Generates mp3 for the given score and export the data to a single JSON file, print it to std out"));
       parser.addOption(QCommandLineOption("score-parts-pdf", "Generates parts data for the given score and export the data to a single JSON file, print it to std out"));
@@ -7378,6 +7677,13 @@ MuseScoreApplication::CommandLineParseResult MuseScoreApplication::parseCommandL
                   parser.showHelp(EXIT_FAILURE);
                   }
             }
+      if (parser.isSet("serve")) {
+            MScore::noGui = true;
+            converterMode = true;
+            serverName = parser.value("serve");
+            if (serverName.isEmpty())
+                  parser.showHelp(EXIT_FAILURE);
+            }
       if ((pluginMode = parser.isSet("p"))) {
             MScore::noGui = true;
             pluginName = parser.value("p");
@@ -7482,6 +7788,28 @@ MuseScoreApplication::CommandLineParseResult MuseScoreApplication::parseCommandL
             converterMode = true;
             }
 
+      if (parser.isSet("jobs")) {
+            QString temp = parser.value("jobs");
+            bool ok = false;
+            convertJobs = temp.toInt(&ok);
+            if (!ok || convertJobs < 1) {
+                  fprintf(stderr, "Job count '%s' not recognized, converting serially.\n", qPrintable(temp));
+                  convertJobs = 1;
+                  }
+            }
+      if (parser.isSet("threads")) {
+            QString temp = parser.value("threads");
+            bool ok = false;
+            exportThreads = temp.toInt(&ok);
+            if (!ok || exportThreads < 0) {
+                  fprintf(stderr, "Thread count '%s' not recognized, using default.\n", qPrintable(temp));
+                  exportThreads = 0;
+                  }
+            }
+
+      if (parser.isSet("memory-report"))
+            memoryReport = true;
+
       if (parser.isSet("score-meta")) {
             exportScoreMeta = true;
             MScore::noGui = true;
@@ -7764,6 +8092,9 @@ void MuseScore::init(QStringList& argv)
                   synti->setSampleRate(MScore::sampleRate);
                   synti->init();
                   }
+            // the sequencer does not wait for Fluid to load samples
+            if (FluidS::Fluid* fluid = static_cast<FluidS::Fluid*>(synti->synthesizer("Fluid")))
+                  fluid->setAsyncSampleLoading(true);
             seq->setMasterSynthesizer(synti);
             }
       else {
@@ -76,6 +76,7 @@ class MediaDialog;
 class Workspace;
 class WorkspaceDialog;
 class AlbumManager;
+class AutoSaver;
 class WebPageDockWidget;
 class ChordList;
 class Capella;
@@ -199,6 +200,10 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
 
       bool _playPartOnly = true; // play part only vs. full score
 
+      // MScore::sampleRate is switched to the export rate while
+      // rendering; conversion jobs on worker threads take turns
+      static QMutex sampleRateMutex;
+
       QVBoxLayout* layout;    // main window layout
       QSplitter* splitter;
       ScoreTab* tab1;
@@ -325,6 +330,7 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
 #endif
 
       QTimer* autoSaveTimer;
+      AutoSaver* autoSaver { 0 };
       QList<QAction*> pluginActions;
 
       PianorollEditor* pianorollEditor   { 0 };
@@ -724,6 +730,7 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       bool saveSvg(Score*, const QString& name);
       bool saveSvg(Score*, QIODevice*, int pageNum = 0, bool drawPageBackground = false);
       bool savePng(Score*, QIODevice*, int pageNum = 0, bool drawPageBackground = false);
+      QImage renderPng(Score*, int pageNum, bool drawPageBackground);
       bool savePng(Score*, const QString& name);
       bool saveMidi(Score*, const QString& name);
       bool saveMidi(Score*, QIODevice*);
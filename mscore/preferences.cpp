@@ -76,6 +76,7 @@ void Preferences::init(bool storeInMemoryOnly)
       {
             {PREF_APP_AUTOSAVE_AUTOSAVETIME,                       new IntPreference(2 /* minutes */, false)},
             {PREF_APP_AUTOSAVE_USEAUTOSAVE,                        new BoolPreference(true, false)},
+            {PREF_APP_AUTOSAVE_USEJOURNAL,                         new BoolPreference(false)},
             {PREF_APP_KEYBOARDLAYOUT,                              new StringPreference("US - International")},
             {PREF_APP_PATHS_INSTRUMENTLIST1,                       new StringPreference(":/data/instruments.xml", false)},
             {PREF_APP_PATHS_INSTRUMENTLIST2,                       new StringPreference("", false)},
@@ -111,6 +112,7 @@ void Preferences::init(bool storeInMemoryOnly)
             {PREF_IMPORT_GUITARPRO_CHARSET,                        new StringPreference("UTF-8", false)},
             {PREF_IMPORT_MUSICXML_IMPORTBREAKS,                    new BoolPreference(true, false)},
             {PREF_IMPORT_MUSICXML_IMPORTLAYOUT,                    new BoolPreference(true, false)},
+            {PREF_IMPORT_MUSICXML_VALIDATE,                        new BoolPreference(true)},
             {PREF_IMPORT_OVERTURE_CHARSET,                         new StringPreference("GBK", false)},
             {PREF_IMPORT_STYLE_STYLEFILE,                          new StringPreference("", false)},
             {PREF_IO_ALSA_DEVICE,                                  new StringPreference("default", false)},
@@ -141,6 +143,7 @@ void Preferences::init(bool storeInMemoryOnly)
             {PREF_IO_PORTMIDI_OUTPUTDEVICE,                        new StringPreference("")},
             {PREF_IO_PORTMIDI_OUTPUTLATENCYMILLISECONDS,           new IntPreference(0)},
             {PREF_IO_PULSEAUDIO_USEPULSEAUDIO,                     new BoolPreference(defaultUsePulseAudio, false)},
+            {PREF_IO_ZERBERUS_STREAMPRELOAD,                       new IntPreference(0 /* ms, 0: load samples completely */)},
             {PREF_SCORE_CHORD_PLAYONADDNOTE,                       new BoolPreference(true, false)},
             {PREF_SCORE_MAGNIFICATION,                             new DoublePreference(1.0, false)},
             {PREF_SCORE_NOTE_PLAYONCLICK,                          new BoolPreference(true, false)},
@@ -240,6 +243,7 @@ QSettings* Preferences::settings() const
 
 QVariant Preferences::get(const QString key) const
       {
+      QMutexLocker locker(&_mutex);
       QVariant pref = _inMemorySettings.value(key);
 
       if (_storeInMemoryOnly)
@@ -254,6 +258,7 @@ QVariant Preferences::get(const QString key) const
 
 void Preferences::set(const QString key, QVariant value, bool temporary)
       {
+      QMutexLocker locker(&_mutex);
       if (_storeInMemoryOnly || temporary)
             _inMemorySettings[key] = value;
       else if (useLocalPrefs && localPreferences.contains(key))
@@ -265,12 +270,14 @@ void Preferences::set(const QString key, QVariant value, bool temporary)
 void Preferences::remove(const QString key)
       {
       // remove both preference stored "in memory" and in QSettings
+      QMutexLocker locker(&_mutex);
       _inMemorySettings.remove(key);
       settings()->remove(key);
       }
 
 bool Preferences::has(const QString key) const
       {
+      QMutexLocker locker(&_mutex);
       return _inMemorySettings.contains(key) || settings()->contains(key);
       }
 
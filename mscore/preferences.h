@@ -155,6 +155,7 @@ class Preferences {
       bool _returnDefaultValues = false;
       bool _initialized = false;
       QSettings* _settings; // should not be used directly but through settings() accessor
+      mutable QMutex _mutex; // guards the stored values, conversion jobs read them from worker threads
 
       QSettings* settings() const;
       // the following functions must be used to access and change a preference
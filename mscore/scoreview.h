@@ -161,6 +161,7 @@ class ScoreView : public QWidget, public MuseScoreView {
       virtual bool event(QEvent* event) override;
       virtual bool gestureEvent(QGestureEvent*);            // ??
       virtual void resizeEvent(QResizeEvent*) override;
+      virtual void showEvent(QShowEvent*) override;
       virtual void dragEnterEvent(QDragEnterEvent*) override;
       virtual void dragLeaveEvent(QDragLeaveEvent*) override;
       virtual void dragMoveEvent(QDragMoveEvent*) override;
@@ -407,6 +408,7 @@ class ScoreView : public QWidget, public MuseScoreView {
       virtual void layoutChanged();
       virtual void dataChanged(const QRectF&);
       virtual void updateAll()    { update(); }
+      virtual bool isShown() const override { return isVisible(); }
       virtual void adjustCanvasPosition(const Element* el, bool playBack, int staff = -1) override;
       virtual void setCursor(const QCursor& c) { QWidget::setCursor(c); }
       virtual QCursor cursor() const { return QWidget::cursor(); }
@@ -230,10 +230,34 @@ void Seq::setScoreView(ScoreView* v)
       _synti->reset();
       if (cs) {
             initInstruments();
+            prefetchSamples();
             connect(cs, SIGNAL(playlistChanged()), this, SLOT(setPlaylistChanged()));
             }
       }
 
+//---------------------------------------------------------
+//   prefetchSamples
+//    start loading the samples of all instruments of the
+//    score, including later instrument changes, so they
+//    are ready when playback starts
+//---------------------------------------------------------
+
+void Seq::prefetchSamples()
+      {
+      QSet<QString> patches;
+      for (const Part* part : cs->parts()) {
+            for (const auto& i : *part->instruments()) {
+                  for (const Channel* channel : i.second->channel()) {
+                        QString key = QString("%1:%2:%3").arg(channel->synti()).arg(channel->bank()).arg(channel->program());
+                        if (patches.contains(key))
+                              continue;
+                        patches.insert(key);
+                        _synti->prefetch(channel->synti(), channel->bank(), channel->program());
+                        }
+                  }
+            }
+      }
+
 //---------------------------------------------------------
 //   Seq::CachedPreferences::update
 //---------------------------------------------------------
@@ -1105,7 +1129,7 @@ void Seq::ensureBufferAsync(int utick)
                   }
 
             if (!renderEvents.empty()) {
-                  // TODO: use C++17 map::merge()?
+                  // does not move existing events, playPos and guiPos stay valid
                   events.insert(renderEvents.begin(), renderEvents.end());
                   updateEventsEnd();
                   renderEvents.clear();
@@ -196,6 +196,7 @@ class Seq : public QObject, public Sequencer {
       void metronome(unsigned n, float* l, bool force);
       void seekCommon(int utick);
       void unmarkNotes();
+      void prefetchSamples();
       void updateSynthesizerState(int tick1, int tick2);
       void addCountInClicks();
 
@@ -0,0 +1,206 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <random>
+
+#include "mtest/testutils.h"
+#include "effects/zita1/zita.h"
+
+using namespace Ms;
+
+static const int SAMPLE_RATE = 44100;
+
+//---------------------------------------------------------
+//   TestReverb
+//    the lane parallel reverb renders the frame by frame
+//    impulse response and ramps parameter changes
+//---------------------------------------------------------
+
+class TestReverb : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      std::vector<float> render(bool vectorized, int sampleRate, int seconds, int buffer, bool noise, bool change);
+
+   private slots:
+      void initTestCase();
+      void impulseResponse_data();
+      void impulseResponse();
+      void parameterRamp();
+      void benchmark_data();
+      void benchmark();
+      };
+
+void TestReverb::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   render
+//    an impulse or noise through the reverb in buffers of
+//    the given size; change alters the damping filters
+//    after one second
+//---------------------------------------------------------
+
+std::vector<float> TestReverb::render(bool vectorized, int sampleRate, int seconds, int buffer, bool noise, bool change)
+      {
+      ZitaReverb reverb;
+      reverb.setVectorized(vectorized);
+      reverb.init(sampleRate);
+      reverb.set_opmix(1.0);
+
+      const int frames = sampleRate * seconds;
+      std::vector<float> in(frames * 2, 0.0f);
+      std::vector<float> out(frames * 2, 0.0f);
+      if (noise) {
+            std::mt19937 random(4711);
+            std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+            for (float& f : in)
+                  f = dist(random);
+            }
+      else {
+            in[0] = 1.0f;
+            in[1] = 0.5f;
+            }
+      bool changed = false;
+      for (int i = 0; i < frames; i += buffer) {
+            if (change && !changed && i >= sampleRate) {
+                  reverb.set_rtlow(8.0);
+                  reverb.set_xover(1000.0);
+                  reverb.set_fdamp(1500.0);
+                  changed = true;
+                  }
+            reverb.process(std::min(buffer, frames - i), &in[i * 2], &out[i * 2]);
+            }
+      return out;
+      }
+
+//---------------------------------------------------------
+//   impulseResponse
+//    The frame by frame rendering is the reference. Both
+//    compute the same operations; the tolerance only
+//    allows for a compiler contracting the scalar code to
+//    fused multiply-adds.
+//---------------------------------------------------------
+
+void TestReverb::impulseResponse_data()
+      {
+      QTest::addColumn<int>("sampleRate");
+      QTest::addColumn<int>("buffer");
+      QTest::addColumn<bool>("change");
+      QTest::newRow("44100")        << 44100 << 256 << false;
+      QTest::newRow("44100 odd")    << 44100 << 37  << false;
+      QTest::newRow("48000")        << 48000 << 64  << false;
+      QTest::newRow("96000")        << 96000 << 512 << false;
+      QTest::newRow("22050")        << 22050 << 100 << false;
+      QTest::newRow("44100 change") << 44100 << 37  << true;
+      }
+
+void TestReverb::impulseResponse()
+      {
+      QFETCH(int, sampleRate);
+      QFETCH(int, buffer);
+      QFETCH(bool, change);
+      std::vector<float> reference = render(false, sampleRate, 2, buffer, false, change);
+      std::vector<float> lanes     = render(true, sampleRate, 2, buffer, false, change);
+      QCOMPARE(reference.size(), lanes.size());
+
+      float peak    = 0.0f;
+      double maxDev = 0.0;
+      double early  = 0.0;
+      double late   = 0.0;
+      const size_t half = reference.size() / 2;
+      for (size_t i = 0; i < reference.size(); ++i) {
+            peak   = std::max(peak, std::fabs(reference[i]));
+            maxDev = std::max(maxDev, std::fabs(double(reference[i]) - double(lanes[i])));
+            (i < half ? early : late) += double(reference[i]) * reference[i];
+            }
+      qInfo("peak %f, max. deviation %g, decay %.1f dB", peak, maxDev, 10.0 * log10(late / early));
+      QVERIFY(peak > 0.001f);
+      QVERIFY(maxDev <= 1e-5 * peak);
+      // mid frequency reverb time is 2 s: -30 dB after one second
+      QVERIFY(late < 0.01 * early);
+      }
+
+//---------------------------------------------------------
+//   parameterRamp
+//    New damping filter coefficients are ramped in over a
+//    fragment. Their effect on continuous noise leaves the
+//    delay lines gradually instead of as a step.
+//---------------------------------------------------------
+
+void TestReverb::parameterRamp()
+      {
+      std::vector<float> steady  = render(true, SAMPLE_RATE, 2, 64, true, false);
+      std::vector<float> changed = render(true, SAMPLE_RATE, 2, 64, true, true);
+
+      auto rms = [&](size_t from, size_t n, bool difference) {
+            double sum = 0.0;
+            for (size_t i = from; i < from + n; ++i) {
+                  double d = steady[i * 2] - (difference ? changed[i * 2] : 0.0f);
+                  sum += d * d;
+                  }
+            return sqrt(sum / n);
+            };
+      const double level = rms(SAMPLE_RATE / 2, SAMPLE_RATE / 2, false);
+      size_t onset = 0;
+      for (size_t i = SAMPLE_RATE; i < steady.size() / 2; ++i) {
+            if (std::fabs(steady[i * 2] - changed[i * 2]) > 1e-3 * level) {
+                  onset = i;
+                  break;
+                  }
+            }
+      QVERIFY(onset > 0 && onset + 1152 < steady.size() / 2);
+
+      const double start = rms(onset, 128, true);
+      const double ramped = rms(onset + 1024, 128, true);
+      qInfo("change %g after the onset, %g one fragment later", start, ramped);
+      QVERIFY(ramped > 1e-3 * level);
+      QVERIFY(start < 0.25 * ramped);
+      }
+
+//---------------------------------------------------------
+//   benchmark
+//    one second of noise in small buffers
+//---------------------------------------------------------
+
+void TestReverb::benchmark_data()
+      {
+      QTest::addColumn<bool>("vectorized");
+      QTest::newRow("frames") << false;
+      QTest::newRow("lanes")  << true;
+      }
+
+void TestReverb::benchmark()
+      {
+      QFETCH(bool, vectorized);
+      const int buffer = 64;
+      ZitaReverb reverb;
+      reverb.setVectorized(vectorized);
+      reverb.init(SAMPLE_RATE);
+      std::vector<float> in(buffer * 2);
+      std::vector<float> out(buffer * 2);
+      std::mt19937 random(4711);
+      std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+      for (float& f : in)
+            f = dist(random);
+      QBENCHMARK {
+            for (int i = 0; i < SAMPLE_RATE / buffer; ++i)
+                  reverb.process(buffer, in.data(), out.data());
+            }
+      }
+
+QTEST_MAIN(TestReverb)
+
+#include "tst_reverb.moc"
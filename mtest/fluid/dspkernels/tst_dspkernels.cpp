@@ -0,0 +1,201 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <random>
+
+#include "mtest/testutils.h"
+#include "fluid/fluid.h"
+#include "fluid/voice.h"
+#include "fluid/dspkernels.h"
+
+using namespace FluidS;
+
+static const int DATA_SIZE = 1 << 16;
+static const int FRAMES    = 4096;
+static const char* modeNames[DSP_INTERP_COUNT] = { "none", "linear", "4th", "7th" };
+
+Q_DECLARE_METATYPE(const FluidS::DspKernels*)
+
+//---------------------------------------------------------
+//   TestDspKernels
+//    all kernel variants compute the scalar results;
+//    microbenchmark of every interpolation mode
+//---------------------------------------------------------
+
+class TestDspKernels : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      std::vector<short> data;
+      std::vector<float> amp;
+
+      qint64 startPhase() const { return qint64(8) << 32; }
+      void kernelRows(bool withIncr);
+
+   private slots:
+      void initTestCase();
+      void interpolationEqualsScalar_data();
+      void interpolationEqualsScalar();
+      void mixEqualsScalar();
+      void benchmarkInterpolation_data();
+      void benchmarkInterpolation();
+      void nsPerSample();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//    noise as sample data and an amplitude ramp
+//---------------------------------------------------------
+
+void TestDspKernels::initTestCase()
+      {
+      initMTest();
+      Voice::dsp_float_config();
+      std::mt19937 random(4711);
+      std::uniform_int_distribution<int> dist(-32768, 32767);
+      data.resize(DATA_SIZE);
+      for (short& s : data)
+            s = short(dist(random));
+      amp.resize(FRAMES);
+      for (int i = 0; i < FRAMES; ++i)
+            amp[i] = 0.1f + 0.8f * i / FRAMES;
+      }
+
+//---------------------------------------------------------
+//   kernelRows
+//    every supported variant and mode, optionally with
+//    several playback speeds
+//---------------------------------------------------------
+
+void TestDspKernels::kernelRows(bool withIncr)
+      {
+      QTest::addColumn<const DspKernels*>("kernels");
+      QTest::addColumn<int>("mode");
+      QTest::addColumn<double>("speed");
+      const std::vector<double> speeds = withIncr ? std::vector<double> { 0.37, 1.0, 1.4983, 3.99 } : std::vector<double> { 1.4983 };
+      for (const DspKernels* k : supportedDspKernels()) {
+            for (int mode = 0; mode < DSP_INTERP_COUNT; ++mode) {
+                  for (double speed : speeds) {
+                        QByteArray name = QByteArray(k->name) + " " + modeNames[mode];
+                        if (withIncr)
+                              name += " " + QByteArray::number(speed);
+                        QTest::newRow(name.constData()) << k << mode << speed;
+                        }
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   interpolationEqualsScalar
+//---------------------------------------------------------
+
+void TestDspKernels::interpolationEqualsScalar_data()
+      {
+      kernelRows(true);
+      }
+
+void TestDspKernels::interpolationEqualsScalar()
+      {
+      QFETCH(const DspKernels*, kernels);
+      QFETCH(int, mode);
+      QFETCH(double, speed);
+      Phase incr;
+      incr.setFloat(speed);
+      // stay 4 points before the end of data
+      const int frames = std::min(FRAMES, int((DATA_SIZE - 16) / speed));
+      std::vector<float> expected(frames + 3, -1.0f);
+      std::vector<float> result(frames + 3, -1.0f);
+
+      // odd lengths and offsets exercise the scalar tails
+      for (int n : { frames, frames - 1, 5 }) {
+            supportedDspKernels().front()->interpolate[mode](data.data(), startPhase() + 12345, incr.data, amp.data(), expected.data(), n);
+            kernels->interpolate[mode](data.data(), startPhase() + 12345, incr.data, amp.data(), result.data(), n);
+            for (int i = 0; i < n + 3; ++i) {
+                  if (memcmp(&expected[i], &result[i], sizeof(float)))
+                        QFAIL(qPrintable(QString("sample %1 of %2: %3 instead of %4").arg(i).arg(n).arg(result[i]).arg(expected[i])));
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   mixEqualsScalar
+//---------------------------------------------------------
+
+void TestDspKernels::mixEqualsScalar()
+      {
+      const int frames = 1027;
+      std::vector<float> in(amp.begin(), amp.begin() + frames);
+      std::vector<float> expected(frames * 6, 0.25f);
+      const DspKernels* scalar = supportedDspKernels().front();
+      scalar->mix(in.data(), frames, 0.7f, 0.3f, 0.2f, 0.1f, &expected[0], &expected[frames * 2], &expected[frames * 4]);
+
+      for (const DspKernels* k : supportedDspKernels()) {
+            std::vector<float> result(frames * 6, 0.25f);
+            k->mix(in.data(), frames, 0.7f, 0.3f, 0.2f, 0.1f, &result[0], &result[frames * 2], &result[frames * 4]);
+            QVERIFY2(memcmp(expected.data(), result.data(), expected.size() * sizeof(float)) == 0, k->name);
+            }
+      }
+
+//---------------------------------------------------------
+//   benchmarkInterpolation
+//---------------------------------------------------------
+
+void TestDspKernels::benchmarkInterpolation_data()
+      {
+      kernelRows(false);
+      }
+
+void TestDspKernels::benchmarkInterpolation()
+      {
+      QFETCH(const DspKernels*, kernels);
+      QFETCH(int, mode);
+      QFETCH(double, speed);
+      Phase incr;
+      incr.setFloat(speed);
+      std::vector<float> out(FRAMES);
+      QBENCHMARK {
+            kernels->interpolate[mode](data.data(), startPhase(), incr.data, amp.data(), out.data(), FRAMES);
+            }
+      }
+
+//---------------------------------------------------------
+//   nsPerSample
+//    table of the interpolation cost of every mode and
+//    variant
+//---------------------------------------------------------
+
+void TestDspKernels::nsPerSample()
+      {
+      const int repeat = 2000;
+      Phase incr;
+      incr.setFloat(1.4983);
+      std::vector<float> out(FRAMES);
+      qInfo("%-8s %10s %10s %10s %10s   ns/sample", "", modeNames[0], modeNames[1], modeNames[2], modeNames[3]);
+      for (const DspKernels* k : supportedDspKernels()) {
+            double ns[DSP_INTERP_COUNT];
+            for (int mode = 0; mode < DSP_INTERP_COUNT; ++mode) {
+                  k->interpolate[mode](data.data(), startPhase(), incr.data, amp.data(), out.data(), FRAMES);
+                  QElapsedTimer timer;
+                  timer.start();
+                  for (int i = 0; i < repeat; ++i)
+                        k->interpolate[mode](data.data(), startPhase(), incr.data, amp.data(), out.data(), FRAMES);
+                  ns[mode] = double(timer.nsecsElapsed()) / (double(repeat) * FRAMES);
+                  }
+            qInfo("%-8s %10.3f %10.3f %10.3f %10.3f", k->name, ns[0], ns[1], ns[2], ns[3]);
+            }
+      qInfo("selected: %s", dspKernels().name);
+      }
+
+QTEST_MAIN(TestDspKernels)
+
+#include "tst_dspkernels.moc"
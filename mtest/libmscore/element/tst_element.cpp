@@ -11,9 +11,11 @@
 //=============================================================================
 
 #include <QtTest/QtTest>
+#include <QtConcurrent>
 
 #include "libmscore/score.h"
 #include "libmscore/element.h"
+#include "libmscore/note.h"
 #include "mtest/testutils.h"
 
 using namespace Ms;
@@ -29,6 +31,8 @@ class TestElement : public QObject, public MTest
    private slots:
       void initTestCase() { initMTest(); }
       void testIds();
+      void elementPool();
+      void elementPoolBenchmark();
       };
 
 //---------------------------------------------------------
@@ -104,6 +108,68 @@ void TestElement::testIds()
             }
       }
 
+//---------------------------------------------------------
+//   elementPool
+//    freed slots are reused; trimAll() releases the slabs
+//    without live elements
+//---------------------------------------------------------
+
+void TestElement::elementPool()
+      {
+#ifdef ELEMENT_POOLS
+      ElementPool& pool = Note::elementPool();
+      ElementPool::trimAll();
+      const ElementPool::Statistics before = pool.statistics();
+
+      std::vector<Element*> notes;
+      for (int i = 0; i < 2000; ++i)
+            notes.push_back(Element::create(ElementType::NOTE, score));
+      QCOMPARE(pool.statistics().live, before.live + 2000);
+      QVERIFY(pool.statistics().slabs > before.slabs);
+
+      Element* last = notes.back();
+      delete last;
+      notes.back() = Element::create(ElementType::NOTE, score);
+      QCOMPARE(notes.back(), last);
+
+      qDeleteAll(notes);
+      QCOMPARE(pool.statistics().live, before.live);
+      QVERIFY(ElementPool::trimAll() > 0);
+      QVERIFY(pool.statistics().slabs <= before.slabs);
+#endif
+      }
+
+//---------------------------------------------------------
+//   elementPoolBenchmark
+//    notes created and deleted on all cores at once, as by
+//    the --jobs workers; build with ELEMENT_POOLS off to
+//    compare with the heap
+//---------------------------------------------------------
+
+void TestElement::elementPoolBenchmark()
+      {
+      std::vector<int> threads(QThread::idealThreadCount());
+      QBENCHMARK {
+            QtConcurrent::blockingMap(threads, [this](int&) {
+                  std::vector<Note*> notes;
+                  std::vector<Note*> batch;
+                  for (int round = 0; round < 10; ++round) {
+                        for (int i = 0; i < 1000; ++i)
+                              batch.push_back(new Note(score));
+                        // keep every third note, like the elements of a score being built
+                        for (size_t i = 0; i < batch.size(); ++i) {
+                              if (i % 3)
+                                    delete batch[i];
+                              else
+                                    notes.push_back(batch[i]);
+                              }
+                        batch.clear();
+                        }
+                  qDeleteAll(notes);
+                  });
+            }
+      }
+
 QTEST_MAIN(TestElement)
 
 #include "tst_element.moc"
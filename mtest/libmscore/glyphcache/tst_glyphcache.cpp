@@ -0,0 +1,96 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "libmscore/sym.h"
+#include "mtest/testutils.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestGlyphCache
+//---------------------------------------------------------
+
+class TestGlyphCache : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      static bool hasColor(const QImage& img, const QRect& r, QRgb color);
+
+   private slots:
+      void initTestCase();
+      void drawTwice();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestGlyphCache::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   hasColor
+//    whether r contains a fully covered pixel of color
+//---------------------------------------------------------
+
+bool TestGlyphCache::hasColor(const QImage& img, const QRect& r, QRgb color)
+      {
+      for (int y = r.top(); y <= r.bottom(); ++y) {
+            for (int x = r.left(); x <= r.right(); ++x) {
+                  if (img.pixel(x, y) == color)
+                        return true;
+                  }
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   drawTwice
+//    the second draw of a glyph and a draw in another
+//    color are served from the cache without rasterizing
+//    the glyph again
+//---------------------------------------------------------
+
+void TestGlyphCache::drawTwice()
+      {
+      ScoreFont* f = ScoreFont::fontFactory("Bravura");
+      QImage img(300, 100, QImage::Format_ARGB32_Premultiplied);
+      img.fill(Qt::white);
+      QPainter p(&img);
+      f->resetCacheStatistics();
+
+      p.setPen(Qt::black);
+      f->draw(SymId::noteheadBlack, &p, 3.0, QPointF(20.0, 50.0));
+      QCOMPARE(f->cacheMisses(), quint64(1));
+      QCOMPARE(f->cacheHits(), quint64(0));
+
+      f->draw(SymId::noteheadBlack, &p, 3.0, QPointF(120.0, 50.0));
+      QCOMPARE(f->cacheMisses(), quint64(1));
+      QCOMPARE(f->cacheHits(), quint64(1));
+
+      p.setPen(Qt::red);
+      f->draw(SymId::noteheadBlack, &p, 3.0, QPointF(220.0, 50.0));
+      QCOMPARE(f->cacheMisses(), quint64(1));
+      QCOMPARE(f->cacheHits(), quint64(2));
+      p.end();
+
+      QVERIFY(hasColor(img, QRect(0, 0, 100, 100), qRgb(0, 0, 0)));
+      QVERIFY(hasColor(img, QRect(100, 0, 100, 100), qRgb(0, 0, 0)));
+      QVERIFY(hasColor(img, QRect(200, 0, 100, 100), qRgb(255, 0, 0)));
+      QVERIFY(!hasColor(img, QRect(200, 0, 100, 100), qRgb(0, 0, 0)));
+      }
+
+QTEST_MAIN(TestGlyphCache)
+#include "tst_glyphcache.moc"
@@ -11,8 +11,12 @@
 //=============================================================================
 
 #include <QtTest/QtTest>
+#include <random>
 #include "mtest/testutils.h"
 #include "libmscore/score.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/shape.h"
 
 #define DIR QString("libmscore/layout/")
 
@@ -31,7 +35,9 @@ class TestBenchmark : public QObject, public MTest
       Q_OBJECT
 
       MasterScore* score;
+      std::vector<std::pair<const Shape*, const Shape*>> shapePairs;
       void beam(const char* path);
+      void collectShapePairs();
 
    private slots:
       void initTestCase();
@@ -39,6 +45,9 @@ class TestBenchmark : public QObject, public MTest
       void benchmark1();
       void benchmark2();
       void benchmark4();            // incremental layout (one page)
+      void benchmark5();            // minHorizontalDistance of adjacent segments
+      void benchmark6();            // same with the plain double loop, for comparison
+      void randomShapes();          // minHorizontalDistance of large random shapes
       };
 
 //---------------------------------------------------------
@@ -89,6 +98,107 @@ void TestBenchmark::benchmark4()
             }
       }
 
+//---------------------------------------------------------
+//   collectShapePairs
+//    staff shapes of adjacent segments, as compared
+//    in Measure::computeMinWidth()
+//---------------------------------------------------------
+
+void TestBenchmark::collectShapePairs()
+      {
+      if (!shapePairs.empty())
+            return;
+      score->doLayout();
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            for (Segment* s = m->first(); s; s = s->next()) {
+                  Segment* ns = s->next();
+                  if (!ns)
+                        break;
+                  for (int staffIdx = 0; staffIdx < score->nstaves(); ++staffIdx)
+                        shapePairs.push_back({ &s->staffShape(staffIdx), &ns->staffShape(staffIdx) });
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   minHorizontalDistanceLinear
+//    the O(n·m) loop Shape uses for small shapes
+//---------------------------------------------------------
+
+static qreal minHorizontalDistanceLinear(const Shape& s, const Shape& a)
+      {
+      qreal dist = -1000000.0;
+      for (const QRectF& r2 : a) {
+            for (const QRectF& r1 : s) {
+                  if (Ms::intersects(r1.top(), r1.bottom(), r2.top(), r2.bottom())
+                     || (r1.height() == 0.0 && r2.height() == 0.0 && r1.top() == r2.top())
+                     || r1.width() == 0.0 || r2.width() == 0.0)
+                        dist = qMax(dist, r1.right() - r2.left());
+                  }
+            }
+      return dist;
+      }
+
+void TestBenchmark::benchmark5()
+      {
+      collectShapePairs();
+      for (const auto& p : shapePairs)
+            QCOMPARE(p.first->minHorizontalDistance(*p.second), minHorizontalDistanceLinear(*p.first, *p.second));
+      qreal sum = 0.0;
+      QBENCHMARK {
+            for (const auto& p : shapePairs)
+                  sum += p.first->minHorizontalDistance(*p.second);
+            }
+      QVERIFY(sum != 0.0);
+      }
+
+void TestBenchmark::benchmark6()
+      {
+      collectShapePairs();
+      qreal sum = 0.0;
+      QBENCHMARK {
+            for (const auto& p : shapePairs)
+                  sum += minHorizontalDistanceLinear(*p.first, *p.second);
+            }
+      QVERIFY(sum != 0.0);
+      }
+
+//---------------------------------------------------------
+//   randomShapes
+//    large shapes take the sorted path of
+//    minHorizontalDistance; coordinates on a coarse grid
+//    so that edges coincide, with zero width, zero height
+//    and negative height rectangles
+//---------------------------------------------------------
+
+void TestBenchmark::randomShapes()
+      {
+      std::mt19937 random(4711);
+      auto grid = [&random](int from, int to) {
+            return std::uniform_int_distribution<int>(from, to)(random) * 0.25;
+            };
+      auto rect = [&]() {
+            const qreal x = grid(-40, 40);
+            const qreal y = grid(-40, 40);
+            const int kw  = std::uniform_int_distribution<int>(0, 9)(random);
+            const int kh  = std::uniform_int_distribution<int>(0, 9)(random);
+            const qreal w = kw == 0 ? 0.0 : grid(1, 40);
+            const qreal h = kh == 0 ? 0.0 : (kh == 1 ? -grid(1, 20) : grid(1, 40));
+            return QRectF(x, y, w, h);
+            };
+      for (int i = 0; i < 2000; ++i) {
+            Shape s;
+            Shape a;
+            const int n = std::uniform_int_distribution<int>(0, 120)(random);
+            const int m = std::uniform_int_distribution<int>(0, 120)(random);
+            for (int k = 0; k < n; ++k)
+                  s.add(rect());
+            for (int k = 0; k < m; ++k)
+                  a.add(rect());
+            QCOMPARE(s.minHorizontalDistance(a), minHorizontalDistanceLinear(s, a));
+            }
+      }
+
 QTEST_MAIN(TestBenchmark)
 #include "tst_benchmark.moc"
 
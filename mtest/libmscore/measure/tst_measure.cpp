@@ -57,6 +57,9 @@ class TestMeasure : public QObject, public MTest
 //      void minWidth();
       void undoDelInitialVBox_269919();
       void mmrest();
+      void tickIndex();
+      void incrementalLayout();
+      void incrementalLayoutUndo();
 
       void gap();
       void checkMeasure();
@@ -522,6 +525,188 @@ void TestMeasure::mmrest()
       delete score;
       }
 
+//---------------------------------------------------------
+///   tickIndex
+///    tick2measure lookups match the linear search
+///    after measures are inserted, removed and replaced
+///    by mmrests
+//---------------------------------------------------------
+
+static void checkTickLookups(MasterScore* score)
+      {
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            QCOMPARE(score->tick2measure(m->tick()), m);
+            QCOMPARE(score->tick2measure(m->endTick() - Fraction(1, 480)), m);
+            QCOMPARE(score->tick2measureBase(m->tick()), static_cast<MeasureBase*>(m));
+            }
+      for (Measure* m = score->firstMeasureMM(); m; m = m->nextMeasureMM())
+            QCOMPARE(score->tick2measureMM(m->tick()), m);
+      Measure* lm = score->lastMeasure();
+      QCOMPARE(score->tick2measure(lm->endTick()), lm);
+      QVERIFY(score->tick2measure(lm->endTick() + Fraction(1, 4)) == 0);
+      }
+
+void TestMeasure::tickIndex()
+      {
+      MScore::checkTickIndex = true;
+      MasterScore* score = readScore(DIR + "mmrest.mscx");
+      checkTickLookups(score);
+
+      score->startCmd();
+      score->insertMeasure(ElementType::MEASURE, score->firstMeasure()->nextMeasure());
+      score->insertMeasure(ElementType::VBOX, score->firstMeasure()->nextMeasure());
+      score->endCmd();
+      checkTickLookups(score);
+
+      score->startCmd();
+      score->deleteMeasures(score->firstMeasure(), score->firstMeasure());
+      score->endCmd();
+      checkTickLookups(score);
+
+      score->startCmd();
+      score->undo(new ChangeStyleVal(score, Sid::createMultiMeasureRests, true));
+      score->setLayoutAll();
+      score->endCmd();
+      checkTickLookups(score);
+
+      score->undoRedo(true, 0);
+      checkTickLookups(score);
+      score->undoRedo(true, 0);
+      checkTickLookups(score);
+      score->undoRedo(false, 0);
+      checkTickLookups(score);
+
+      delete score;
+      MScore::checkTickIndex = false;
+      }
+
+//---------------------------------------------------------
+///   incrementalLayout
+///    a single note edit only collects the systems up to
+///    the first unchanged one, and the result matches a
+///    full relayout
+//---------------------------------------------------------
+
+static QList<QRectF> measureRects(MasterScore* score)
+      {
+      QList<QRectF> rl;
+      for (Measure* m = score->firstMeasureMM(); m; m = m->nextMeasureMM())
+            rl.append(QRectF(m->pagePos(), QSizeF(m->width(), m->system()->height())));
+      return rl;
+      }
+
+//---------------------------------------------------------
+//   noteRects
+//---------------------------------------------------------
+
+static QList<QRectF> noteRects(MasterScore* score)
+      {
+      QList<QRectF> rl;
+      for (Segment* s = score->firstSegment(SegmentType::ChordRest); s; s = s->next1(SegmentType::ChordRest)) {
+            for (Element* e : s->elist()) {
+                  if (e && e->isChord()) {
+                        for (Note* n : toChord(e)->notes())
+                              rl.append(n->pageBoundingRect());
+                        }
+                  }
+            }
+      return rl;
+      }
+
+//---------------------------------------------------------
+//   sameRects
+//---------------------------------------------------------
+
+static bool sameRects(const QList<QRectF>& a, const QList<QRectF>& b)
+      {
+      if (a.size() != b.size())
+            return false;
+      for (int i = 0; i < a.size(); ++i) {
+            if (qAbs(a[i].x() - b[i].x()) >= 0.01 || qAbs(a[i].y() - b[i].y()) >= 0.01
+               || qAbs(a[i].width() - b[i].width()) >= 0.01 || qAbs(a[i].height() - b[i].height()) >= 0.01)
+                  return false;
+            }
+      return true;
+      }
+
+void TestMeasure::incrementalLayout()
+      {
+      MasterScore* score = readScore(DIR + "measure-2.mscx");
+      score->startCmd();
+      for (int i = 0; i < 40; ++i)
+            score->insertMeasure(ElementType::MEASURE, 0);
+      score->endCmd();
+
+      int nmeasures = score->nmeasures();
+      int nsystems  = score->systems().size();
+      QVERIFY(nsystems > 4);
+
+      Measure* m   = score->firstMeasure()->nextMeasure();
+      Chord* chord = 0;
+      for (Segment* s = m->first(SegmentType::ChordRest); s && !chord; s = s->next(SegmentType::ChordRest)) {
+            if (s->element(0) && s->element(0)->isChord())
+                  chord = toChord(s->element(0));
+            }
+      QVERIFY(chord);
+      Note* note = chord->upNote();
+
+      score->resetLayoutStatistics();
+      score->startCmd();
+      note->undoChangeProperty(Pid::PITCH, note->pitch() + 1);
+      score->endCmd();
+
+      const LayoutStatistics& ls = score->layoutStatistics();
+      QVERIFY(ls.measures > 0);
+      QVERIFY(ls.measures + ls.reusedMeasures < nmeasures);
+      QVERIFY(ls.systems < nsystems);
+
+      QList<QRectF> incremental = measureRects(score);
+      score->doLayout();
+      QVERIFY(sameRects(incremental, measureRects(score)));
+      delete score;
+      }
+
+//---------------------------------------------------------
+///   incrementalLayoutUndo
+///    undoing edits which change measure widths leaves
+///    the layout of a fresh full layout
+//---------------------------------------------------------
+
+void TestMeasure::incrementalLayoutUndo()
+      {
+      MasterScore* score = readScore(DIR + "measure-2.mscx");
+      score->startCmd();
+      for (int i = 0; i < 40; ++i)
+            score->insertMeasure(ElementType::MEASURE, 0);
+      score->endCmd();
+      score->doLayout();
+      QList<QRectF> measures = measureRects(score);
+      QList<QRectF> notes    = noteRects(score);
+
+      score->startCmd();
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+            for (Segment* s = m->first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
+                  if (s->element(0) && s->element(0)->isChord()) {
+                        Note* note = toChord(s->element(0))->upNote();
+                        note->undoChangeProperty(Pid::PITCH, note->pitch() + 1);
+                        note->undoChangeProperty(Pid::SMALL, true);
+                        }
+                  }
+            }
+      score->endCmd();
+      QVERIFY(!sameRects(notes, noteRects(score)));
+
+      score->undoRedo(true, 0);
+      QList<QRectF> undoneMeasures = measureRects(score);
+      QList<QRectF> undoneNotes    = noteRects(score);
+      QVERIFY(sameRects(undoneMeasures, measures));
+      QVERIFY(sameRects(undoneNotes, notes));
+
+      score->doLayout();
+      QVERIFY(sameRects(undoneMeasures, measureRects(score)));
+      QVERIFY(sameRects(undoneNotes, noteRects(score)));
+      delete score;
+      }
 
 QTEST_MAIN(TestMeasure)
 
@@ -23,8 +23,11 @@
 #include "libmscore/chord.h"
 #include "libmscore/note.h"
 #include "libmscore/keysig.h"
+#include "libmscore/rendermidi.h"
+#include "synthesizer/event.h"
 #include "mscore/exportmidi.h"
 #include <QIODevice>
+#include <tuple>
 
 #include "libmscore/mcursor.h"
 #include "mtest/testutils.h"
@@ -78,6 +81,13 @@ class TestMidi : public QObject, public MTest
       void midiTimeStretchFermataTempoEdit();
       void midiTimeStretchFermataTempoEditContinuousView();
       void midiSingleNoteDynamics();
+      void chunkedRender_data();
+      void chunkedRender();               // rendering measure by measure gives the same events as renderScore()
+      void threadedRender_data();
+      void threadedRender();              // staves rendered on several threads give the same events in the same order
+      void eventMapIterators();           // iterators held across insertChunk() stay valid
+      void eventMapBenchmark();           // EventMap filled chunk by chunk: memory and iteration
+      void multimapBenchmark();           // same events in a std::multimap, for comparison
       };
 
 //---------------------------------------------------------
@@ -601,6 +611,247 @@ void TestMidi::midiExportTestRef(const QString& file)
       delete score;
       }
 
+//---------------------------------------------------------
+//   benchmarkChunk
+//    overlapping notes on 16 channels, about as dense as
+//    a large orchestral score
+//---------------------------------------------------------
+
+static EventMap benchmarkChunk(int chunk)
+      {
+      static const int CHUNK_TICKS = 480 * 40;
+      EventMap events;
+      for (int tick = chunk * CHUNK_TICKS; tick < (chunk + 1) * CHUNK_TICKS; tick += 60) {
+            for (int channel = 0; channel < 16; ++channel) {
+                  NPlayEvent ev(ME_NOTEON, channel, 48 + (tick / 60 + channel) % 36, 80);
+                  ev.setOriginatingStaff(channel);
+                  events.insert(std::make_pair(tick, ev));
+                  ev.setVelo(0);
+                  events.insert(std::make_pair(tick + 90, ev));
+                  }
+            }
+      return events;
+      }
+
+//---------------------------------------------------------
+//   sortedEvents
+//    the events of a map, those of equal ticks in a fixed
+//    order: a chunk boundary changes the order in which the
+//    events of different staves at the boundary tick are
+//    merged, but not the events themselves
+//---------------------------------------------------------
+
+static std::vector<std::pair<int, NPlayEvent>> sortedEvents(const EventMap& events)
+      {
+      std::vector<std::pair<int, NPlayEvent>> sl(events.cbegin(), events.cend());
+      auto key = [](const std::pair<int, NPlayEvent>& e) {
+            const NPlayEvent& ev = e.second;
+            return std::make_tuple(e.first, ev.type(), ev.channel(), ev.dataA(), ev.dataB(), ev.getOriginatingStaff(), ev.discard());
+            };
+      std::sort(sl.begin(), sl.end(), [&key](const std::pair<int, NPlayEvent>& a, const std::pair<int, NPlayEvent>& b) {
+            return key(a) < key(b);
+            });
+      return sl;
+      }
+
+//---------------------------------------------------------
+//   chunkedRender
+//    Playback renders one chunk after the other and fixes
+//    up each chunk starting from the state the previous one
+//    left. Notes tied or sounding across a chunk boundary
+//    and pedal changes must come out as in a single pass.
+//---------------------------------------------------------
+
+void TestMidi::chunkedRender_data()
+      {
+      QTest::addColumn<QString>("file");
+      QTest::newRow("ties across measures") << "testAndanteExcerpts";
+      QTest::newRow("tied trills")          << "testTieTrill";
+      QTest::newRow("ornaments and ties")   << "testBaroqueOrnaments";
+      QTest::newRow("three parts")          << "testKantataBWV140Excerpts";
+      QTest::newRow("pedal")                << "testPedal";
+      }
+
+void TestMidi::chunkedRender()
+      {
+      QFETCH(QString, file);
+      MasterScore* score = readScore(DIR + file + ".mscx");
+      QVERIFY(score);
+      SynthesizerState ss;
+
+      EventMap whole;
+      MidiRenderer(score).renderScore(&whole, ss);
+
+      EventMap chunked;
+      MidiRenderer renderer(score);
+      renderer.setMinChunkSize(1);
+      int chunks = 0;
+      for (MidiRenderer::Chunk chunk = renderer.getChunkAt(0); chunk; chunk = renderer.getChunkAt(chunk.utick2())) {
+            renderer.renderChunk(chunk, &chunked, ss);
+            ++chunks;
+            }
+      QVERIFY(chunks > 1);
+
+      const std::vector<std::pair<int, NPlayEvent>> w = sortedEvents(whole);
+      const std::vector<std::pair<int, NPlayEvent>> c = sortedEvents(chunked);
+      QCOMPARE(c.size(), w.size());
+      for (size_t i = 0; i < w.size(); ++i) {
+            const NPlayEvent& a = w[i].second;
+            const NPlayEvent& b = c[i].second;
+            QCOMPARE(c[i].first, w[i].first);
+            QCOMPARE(b.type(), a.type());
+            QCOMPARE(b.channel(), a.channel());
+            QCOMPARE(b.dataA(), a.dataA());
+            QCOMPARE(b.dataB(), a.dataB());
+            QCOMPARE(b.getOriginatingStaff(), a.getOriginatingStaff());
+            QCOMPARE(b.discard(), a.discard());
+            }
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   threadedRender
+//    Every staff of a chunk is rendered into its own buffer
+//    on a thread pool and the buffers are merged in staff
+//    order, so the event map has to be the same as when
+//    rendered on one thread, including the order of events
+//    at the same tick.
+//---------------------------------------------------------
+
+void TestMidi::threadedRender_data()
+      {
+      QTest::addColumn<QString>("file");
+      QTest::newRow("three parts") << "testKantataBWV140Excerpts";
+      QTest::newRow("two staves")  << "testAndanteExcerpts";
+      QTest::newRow("cross staff") << "testTrillCrossStaff";
+      QTest::newRow("pedal")       << "testPedal";
+      QTest::newRow("metronome")   << "testMetronomeSimple";
+      }
+
+void TestMidi::threadedRender()
+      {
+      QFETCH(QString, file);
+      MasterScore* score = readScore(DIR + file + ".mscx");
+      QVERIFY(score);
+      SynthesizerState ss;
+
+      EventMap serial;
+      score->renderMidi(&serial, ss, 1);
+      EventMap threaded;
+      score->renderMidi(&threaded, ss, 4);
+      QVERIFY(!serial.empty());
+      QCOMPARE(threaded.size(), serial.size());
+
+      auto t = threaded.cbegin();
+      for (auto e = serial.cbegin(); e != serial.cend(); ++e, ++t) {
+            const NPlayEvent& a = e->second;
+            const NPlayEvent& b = t->second;
+            QCOMPARE(t->first, e->first);
+            QCOMPARE(b.type(), a.type());
+            QCOMPARE(b.channel(), a.channel());
+            QCOMPARE(b.dataA(), a.dataA());
+            QCOMPARE(b.dataB(), a.dataB());
+            QCOMPARE(b.getOriginatingStaff(), a.getOriginatingStaff());
+            QCOMPARE(b.discard(), a.discard());
+            }
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   eventMapIterators
+//    the sequencer keeps its play position while the next
+//    chunk is merged in; the note offs at the end of the
+//    first chunk fall between the events of the second
+//---------------------------------------------------------
+
+void TestMidi::eventMapIterators()
+      {
+      EventMap events;
+      events.insertChunk(benchmarkChunk(0));
+      const EventMap chunk = benchmarkChunk(1);
+      const int chunkTick  = chunk.cbegin()->first;
+
+      std::vector<EventMap::const_iterator> held;
+      held.push_back(events.cbegin());
+      held.push_back(events.lower_bound(chunkTick - 1));
+      held.push_back(events.upper_bound(chunkTick));
+      QVERIFY(held.back() != events.cend());
+      held.push_back(--events.cend());
+      std::vector<EventMap::value_type> heldEvents;
+      for (const auto& i : held)
+            heldEvents.push_back(*i);
+      const EventMap::value_type* heldAddress = &*held[2];
+
+      events.insertChunk(chunk);
+
+      for (size_t n = 0; n < held.size(); ++n) {
+            QCOMPARE(held[n]->first, heldEvents[n].first);
+            QVERIFY(held[n]->second == heldEvents[n].second);
+            }
+      QCOMPARE(&*held[2], heldAddress);
+
+      // iterating on from a held iterator sees the merged events
+      for (const auto& i : held) {
+            EventMap::const_iterator fresh = events.lower_bound(i->first);
+            while (fresh != i && fresh != events.cend())
+                  ++fresh;
+            QVERIFY(fresh == i);
+            int tick = i->first;
+            for (EventMap::const_iterator k = i; k != events.cend(); ++k, ++fresh) {
+                  QVERIFY(k == fresh);
+                  QVERIFY(k->first >= tick);
+                  tick = k->first;
+                  }
+            QVERIFY(fresh == events.cend());
+            }
+      // new events went after the held note offs with equal ticks
+      EventMap::const_iterator prev = held[2];
+      QVERIFY(prev->first > chunkTick);
+      QVERIFY((--prev)->first <= chunkTick);
+      }
+
+//---------------------------------------------------------
+//   eventMapBenchmark
+//---------------------------------------------------------
+
+void TestMidi::eventMapBenchmark()
+      {
+      EventMap events;
+      for (int chunk = 0; chunk < 100; ++chunk)
+            events.insertChunk(benchmarkChunk(chunk));
+      qDebug("EventMap: %d events, %.1f bytes per event", int(events.size()), double(events.memoryUsage()) / events.size());
+
+      int velo = 0;
+      QBENCHMARK {
+            for (const auto& ev : events)
+                  velo += ev.second.velo();
+            }
+      QVERIFY(velo > 0);
+      }
+
+//---------------------------------------------------------
+//   multimapBenchmark
+//---------------------------------------------------------
+
+void TestMidi::multimapBenchmark()
+      {
+      std::multimap<int, NPlayEvent> events;
+      for (int chunk = 0; chunk < 100; ++chunk) {
+            const EventMap ev = benchmarkChunk(chunk);
+            events.insert(ev.cbegin(), ev.cend());
+            }
+      // node header of a red-black tree, the allocator overhead is not counted
+      const size_t node = sizeof(std::multimap<int, NPlayEvent>::value_type) + 4 * sizeof(void*);
+      qDebug("std::multimap: %d events, at least %d bytes per event", int(events.size()), int(node));
+
+      int velo = 0;
+      QBENCHMARK {
+            for (const auto& ev : events)
+                  velo += ev.second.velo();
+            }
+      QVERIFY(velo > 0);
+      }
+
 QTEST_MAIN(TestMidi)
 
 #include "tst_midi.moc"
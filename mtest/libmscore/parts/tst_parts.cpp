@@ -112,6 +112,8 @@ class TestParts : public QObject, public MTest
 //      void staffStyles();
 
       void measureProperties();
+      void pendingLayout();
+      void pendingLayoutGui();
 
  // second part has system text on empty chordrest segment
       void createPart3() {
@@ -1046,6 +1048,118 @@ void TestParts::measureProperties()
       {
       }
 
+//---------------------------------------------------------
+//   pendingLayout
+//    parts laid out later by Score::doPendingLayouts(),
+//    here on worker threads, end up as laid out before
+//---------------------------------------------------------
+
+void TestParts::pendingLayout()
+      {
+      MasterScore* score = readScore(DIR + "part-all.mscx");
+      QVERIFY(score);
+      createParts(score);
+
+      QList<Score*> parts;
+      std::vector<QList<QPointF>> positions;
+      for (Excerpt* e : score->excerpts()) {
+            Score* s = e->partScore();
+            QVERIFY(!s->layoutPending());
+            QVERIFY(s->canLayoutConcurrently());
+            parts.append(s);
+            positions.emplace_back();
+            for (Measure* m = s->firstMeasure(); m; m = m->nextMeasure())
+                  positions.back().append(m->pagePos());
+            s->setLayoutPending(Fraction(2,1), Fraction(3,1));
+            s->setLayoutPending(Fraction(0,1), Fraction(-1,1));
+            QVERIFY(s->layoutPending());
+            }
+
+      Score::doPendingLayouts(parts, 2);
+
+      for (int i = 0; i < parts.size(); ++i) {
+            QVERIFY(!parts[i]->layoutPending());
+            QList<QPointF> pos;
+            for (Measure* m = parts[i]->firstMeasure(); m; m = m->nextMeasure())
+                  pos.append(m->pagePos());
+            QCOMPARE(pos, positions[i]);
+            }
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   mmRestCount
+//---------------------------------------------------------
+
+static int mmRestCount(Score* s)
+      {
+      int n = 0;
+      Measure* last = nullptr;
+      for (Measure* m = s->firstMeasure(); m; m = m->nextMeasure()) {
+            if (m->mmRest() && m->mmRest() != last) {
+                  last = m->mmRest();
+                  ++n;
+                  }
+            }
+      return n;
+      }
+
+//---------------------------------------------------------
+//   pendingLayoutGui
+//    in the GUI, a command on the master score defers the
+//    layout of hidden parts, but not of parts whose layout
+//    goes through the undo stack
+//---------------------------------------------------------
+
+void TestParts::pendingLayoutGui()
+      {
+      MasterScore* score = readScore(DIR + "part-all.mscx");
+      QVERIFY(score);
+      createParts(score);
+      Score* plain   = score->excerpts().at(0)->partScore();
+      Score* mmRests = score->excerpts().at(1)->partScore();
+      mmRests->startCmd();
+      mmRests->undoChangeStyleVal(Sid::createMultiMeasureRests, true);
+      mmRests->endCmd();
+      QVERIFY(!plain->layoutUsesUndo());
+      QVERIFY(mmRests->layoutUsesUndo());
+      const int mmRestsBefore = mmRestCount(mmRests);
+      QVERIFY(mmRestsBefore > 0);
+
+      // no view of the parts is shown
+      const int idx = score->undoStack()->getCurIdx();
+      MScore::noGui = false;
+      score->startCmd();
+      Measure* m = score->firstMeasure();
+      for (int i = 0; i < 8; ++i)
+            m = m->nextMeasure();
+      m->undoChangeProperty(Pid::BREAK_MMR, true);
+      score->endCmd();
+      MScore::noGui = true;
+
+      QVERIFY(!score->layoutPending());
+      QVERIFY(plain->layoutPending());
+      QVERIFY(!mmRests->layoutPending());
+      // the deferred part keeps no systems referring to its measures
+      QVERIFY(plain->systems().empty());
+      QVERIFY(plain->pages().empty());
+      QVERIFY(!score->memoryReport().isEmpty());
+      QVERIFY(!score->undoStack()->active());
+      QCOMPARE(score->undoStack()->getCurIdx(), idx + 1);
+
+      // showing or exporting the part lays it out, outside of any command
+      Score::doPendingLayouts(score->scoreList());
+      QVERIFY(!plain->layoutPending());
+      QVERIFY(!plain->pages().empty());
+      QVERIFY(!score->undoStack()->active());
+      QCOMPARE(score->undoStack()->getCurIdx(), idx + 1);
+
+      // the multimeasure rests changed by the command are undone with it
+      score->undoRedo(true, 0);
+      QCOMPARE(score->undoStack()->getCurIdx(), idx);
+      QCOMPARE(mmRestCount(mmRests), mmRestsBefore);
+      delete score;
+      }
 
 QTEST_MAIN(TestParts)
 
@@ -0,0 +1,202 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "libmscore/score.h"
+#include "libmscore/scorejournal.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/note.h"
+#include "thirdparty/qzip/qzipreader_p.h"
+#include "mtest/testutils.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestScoreJournal
+//---------------------------------------------------------
+
+class TestScoreJournal : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      void edit(MasterScore* score);
+      QByteArray write(MasterScore* score, ScoreJournal& journal, const QString& path);
+
+   private slots:
+      void initTestCase();
+      void replay();
+      void truncatedRecord();
+      void foreignJournal();
+      void replacedPicture();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestScoreJournal::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   edit
+//    raise the first note of the score by a semitone
+//---------------------------------------------------------
+
+void TestScoreJournal::edit(MasterScore* score)
+      {
+      Segment* s = score->firstMeasure()->first(SegmentType::ChordRest);
+      while (s && !(s->element(0) && s->element(0)->isChord()))
+            s = s->next1(SegmentType::ChordRest);
+      QVERIFY(s);
+      Note* note = toChord(s->element(0))->upNote();
+      score->startCmd();
+      note->undoChangeProperty(Pid::PITCH, note->pitch() + 1);
+      score->endCmd();
+      }
+
+//---------------------------------------------------------
+//   write
+//    journal the current state, return the score .mscx
+//---------------------------------------------------------
+
+QByteArray TestScoreJournal::write(MasterScore* score, ScoreJournal& journal, const QString& path)
+      {
+      MsczContents contents;
+      if (!score->msczContents(contents, QFileInfo(path), false, false) || !journal.write(contents))
+            return QByteArray();
+      return contents[1].second;
+      }
+
+static QByteArray readMscx(const QString& path)
+      {
+      MQZipReader uz(path);
+      return uz.fileData(QFileInfo(path).completeBaseName() + ".mscx");
+      }
+
+//---------------------------------------------------------
+//   replay
+//    edits are appended to the journal and folded into
+//    the .mscz by recover()
+//---------------------------------------------------------
+
+void TestScoreJournal::replay()
+      {
+      QTemporaryDir dir;
+      QString path = dir.path() + "/journal.mscz";
+      MasterScore* score = readScore("libmscore/measure/measure-2.mscx");
+      ScoreJournal journal(path);
+
+      QByteArray base = write(score, journal, path);
+      QVERIFY(!base.isEmpty());
+      QCOMPARE(readMscx(path), base);
+      qint64 msczSize = QFileInfo(path).size();
+
+      QByteArray mscx;
+      for (int i = 0; i < 3; ++i) {
+            edit(score);
+            mscx = write(score, journal, path);
+            QVERIFY(!mscx.isEmpty());
+            }
+      QVERIFY(mscx != base);
+      QCOMPARE(readMscx(path), base);                       // .mscz not rewritten
+      QVERIFY(journal.size() < msczSize);
+
+      QVERIFY(ScoreJournal::recover(path));
+      QVERIFY(!QFileInfo::exists(ScoreJournal::journalPath(path)));
+      QCOMPARE(readMscx(path), mscx);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   truncatedRecord
+//    a record cut off by a crash is ignored
+//---------------------------------------------------------
+
+void TestScoreJournal::truncatedRecord()
+      {
+      QTemporaryDir dir;
+      QString path = dir.path() + "/journal.mscz";
+      MasterScore* score = readScore("libmscore/measure/measure-2.mscx");
+      ScoreJournal journal(path);
+
+      write(score, journal, path);
+      edit(score);
+      QByteArray mscx = write(score, journal, path);
+
+      QFile f(journal.path());
+      QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Append));
+      f.write(QByteArray("\0\0\1\0\0", 5));
+      f.close();
+
+      QVERIFY(ScoreJournal::recover(path));
+      QCOMPARE(readMscx(path), mscx);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   foreignJournal
+//    a journal is not applied to another base snapshot
+//---------------------------------------------------------
+
+void TestScoreJournal::foreignJournal()
+      {
+      QTemporaryDir dir;
+      QString path = dir.path() + "/journal.mscz";
+      MasterScore* score = readScore("libmscore/measure/measure-2.mscx");
+      ScoreJournal journal(path);
+
+      write(score, journal, path);
+      edit(score);
+      write(score, journal, path);
+
+      // replace the base snapshot behind the journal's back
+      QFileInfo fi(path);
+      QVERIFY(score->saveCompressedFile(fi, false));
+      QByteArray mscx = readMscx(path);
+
+      QVERIFY(!ScoreJournal::recover(path));
+      QVERIFY(!QFileInfo::exists(journal.path()));
+      QCOMPARE(readMscx(path), mscx);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   replacedPicture
+//    a picture replaced under the same name is written
+//    to the .mscz
+//---------------------------------------------------------
+
+void TestScoreJournal::replacedPicture()
+      {
+      QTemporaryDir dir;
+      QString path = dir.path() + "/journal.mscz";
+      MasterScore* score = readScore("libmscore/measure/measure-2.mscx");
+      ScoreJournal journal(path);
+
+      MsczContents contents;
+      QVERIFY(score->msczContents(contents, QFileInfo(path), false, false));
+      contents.append(qMakePair(QString("Pictures/picture.png"), QByteArray("first picture")));
+      QVERIFY(journal.write(contents));
+      contents.last().second = QByteArray("second picture");
+      QVERIFY(journal.write(contents));
+
+      MQZipReader uz(path);
+      QCOMPARE(uz.fileData("Pictures/picture.png"), QByteArray("second picture"));
+      delete score;
+      }
+
+QTEST_MAIN(TestScoreJournal)
+#include "tst_scorejournal.moc"
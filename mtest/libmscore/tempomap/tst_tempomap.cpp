@@ -0,0 +1,263 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/tempo.h"
+#include "libmscore/repeatlist.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestTempoMap
+//---------------------------------------------------------
+
+class TestTempoMap : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      TempoMap tempoMap;
+      std::vector<int> ticks;
+      MasterScore* score { 0 };
+      std::vector<int> uticks;
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void tick2time();
+      void time2tick();
+      void repeatList();
+      void benchmarkTick2Time();
+      void benchmarkTick2TimeBatch();
+      void benchmarkUtick2Utime();
+      void benchmarkUtick2UtimeBatch();
+      };
+
+//---------------------------------------------------------
+//   refTick2time
+//    linear reference implementation
+//---------------------------------------------------------
+
+static qreal refTick2time(const TempoMap& tm, int tick)
+      {
+      int ptick   = 0;
+      qreal tempo = 2.0;
+      qreal time  = 0.0;
+      for (auto e = tm.begin(); e != tm.end() && e->first <= tick; ++e) {
+            ptick = e->first;
+            tempo = e->second.tempo;
+            time  = e->second.time;
+            }
+      return time + qreal(tick - ptick) / (MScore::division * tempo * tm.relTempo());
+      }
+
+//---------------------------------------------------------
+//   refTime2tick
+//---------------------------------------------------------
+
+static int refTime2tick(const TempoMap& tm, qreal time)
+      {
+      int tick    = 0;
+      qreal delta = 0.0;
+      qreal tempo = 2.0;
+      for (auto e = tm.begin(); e != tm.end(); ++e) {
+            if ((time <= e->second.time) && (time > e->second.time - e->second.pause)) {
+                  delta = (time - (e->second.time - e->second.pause) + delta);
+                  break;
+                  }
+            if (e->second.time >= time)
+                  break;
+            delta = e->second.time;
+            tick  = e->first;
+            tempo = e->second.tempo;
+            }
+      delta = time - delta;
+      return tick + lrint(delta * tm.relTempo() * MScore::division * tempo);
+      }
+
+//---------------------------------------------------------
+//   initTestCase
+//    a tempo map with 5000 tempo changes: ritardandi in
+//    steps of 24 ticks with a fermata pause at their ends
+//---------------------------------------------------------
+
+void TestTempoMap::initTestCase()
+      {
+      initMTest();
+
+      const int steps = 100;
+      for (int rit = 0; rit < 50; ++rit) {
+            int start = rit * steps * 24;
+            for (int i = 0; i < steps; ++i)
+                  tempoMap.setTempo(start + i * 24, 3.0 - 2.0 * i / steps);
+            tempoMap.setPause(start + steps * 24 - 12, 0.5);
+            }
+      QVERIFY(tempoMap.size() >= 5000);
+      for (int tick = -10; tick < 50 * steps * 24 + 1000; tick += 7)
+            ticks.push_back(tick);
+
+      score = readScore("libmscore/repeat/repeat14.mscx");
+      QVERIFY(score);
+      for (int tick = 0; tick < score->endTick().ticks(); tick += 10)
+            score->setTempo(Fraction::fromTicks(tick), 2.0 - (tick % 1920) / 1920.0);
+      score->setExpandRepeats(true);
+      for (int utick = 0; utick < score->repeatList().ticks(); utick += 5)
+            uticks.push_back(utick);
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//---------------------------------------------------------
+
+void TestTempoMap::cleanupTestCase()
+      {
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   tick2time
+//---------------------------------------------------------
+
+void TestTempoMap::tick2time()
+      {
+      std::vector<qreal> times;
+      tempoMap.tick2time(ticks, times);
+      QCOMPARE(times.size(), ticks.size());
+      for (size_t i = 0; i < ticks.size(); ++i) {
+            qreal t = refTick2time(tempoMap, ticks[i]);
+            QCOMPARE(tempoMap.tick2time(ticks[i]), t);
+            QCOMPARE(times[i], t);
+            }
+      // unsorted input
+      std::vector<int> rticks(ticks.rbegin(), ticks.rend());
+      tempoMap.tick2time(rticks, times);
+      for (size_t i = 0; i < rticks.size(); ++i)
+            QCOMPARE(times[i], refTick2time(tempoMap, rticks[i]));
+      }
+
+//---------------------------------------------------------
+//   time2tick
+//---------------------------------------------------------
+
+void TestTempoMap::time2tick()
+      {
+      qreal end = tempoMap.tick2time(ticks.back());
+      for (qreal t = 0.0; t < end; t += 0.0137)
+            QCOMPARE(tempoMap.time2tick(t), refTime2tick(tempoMap, t));
+      // inside and at the end of the pauses
+      for (const auto& e : tempoMap) {
+            if (e.second.pause > 0.0) {
+                  QCOMPARE(tempoMap.time2tick(e.second.time - 0.25), refTime2tick(tempoMap, e.second.time - 0.25));
+                  QCOMPARE(tempoMap.time2tick(e.second.time), refTime2tick(tempoMap, e.second.time));
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   repeatList
+//    compare lookups with a linear scan of the segments
+//---------------------------------------------------------
+
+void TestTempoMap::repeatList()
+      {
+      const RepeatList& rl = score->repeatList();
+      QVERIFY(rl.size() > 1);
+
+      std::vector<qreal> utimes;
+      rl.utick2utime(uticks, utimes);
+      for (size_t i = 0; i < uticks.size(); ++i) {
+            int utick = uticks[i];
+            const RepeatSegment* rs = 0;
+            for (const RepeatSegment* s : rl) {
+                  if (utick >= s->utick)
+                        rs = s;
+                  }
+            QVERIFY(rs);
+            int tick = utick - (rs->utick - rs->tick);
+            qreal utime = score->tempomap()->tick2time(tick) + rs->timeOffset;
+            QCOMPARE(rl.utick2tick(utick), tick);
+            QCOMPARE(rl.utick2utime(utick), utime);
+            QCOMPARE(utimes[i], utime);
+            QCOMPARE(rl.utime2utick(utime), utick);
+            }
+
+      for (int tick = 0; tick < score->endTick().ticks() + 100; tick += 5) {
+            int utick = rl.last()->utick + (tick - rl.last()->tick);
+            for (const RepeatSegment* s : rl) {
+                  if (tick >= s->tick && tick < s->tick + s->len()) {
+                        utick = s->utick + (tick - s->tick);
+                        break;
+                        }
+                  }
+            QCOMPARE(rl.tick2utick(tick), utick);
+            }
+      }
+
+//---------------------------------------------------------
+//   benchmarkTick2Time
+//---------------------------------------------------------
+
+void TestTempoMap::benchmarkTick2Time()
+      {
+      qreal sum = 0.0;
+      QBENCHMARK {
+            for (int tick : ticks)
+                  sum += tempoMap.tick2time(tick);
+            }
+      QVERIFY(sum > 0.0);
+      }
+
+//---------------------------------------------------------
+//   benchmarkTick2TimeBatch
+//---------------------------------------------------------
+
+void TestTempoMap::benchmarkTick2TimeBatch()
+      {
+      std::vector<qreal> times;
+      QBENCHMARK {
+            tempoMap.tick2time(ticks, times);
+            }
+      QCOMPARE(times.size(), ticks.size());
+      }
+
+//---------------------------------------------------------
+//   benchmarkUtick2Utime
+//---------------------------------------------------------
+
+void TestTempoMap::benchmarkUtick2Utime()
+      {
+      const RepeatList& rl = score->repeatList();
+      qreal sum = 0.0;
+      QBENCHMARK {
+            for (int utick : uticks)
+                  sum += rl.utick2utime(utick);
+            }
+      QVERIFY(sum > 0.0);
+      }
+
+//---------------------------------------------------------
+//   benchmarkUtick2UtimeBatch
+//---------------------------------------------------------
+
+void TestTempoMap::benchmarkUtick2UtimeBatch()
+      {
+      const RepeatList& rl = score->repeatList();
+      std::vector<qreal> utimes;
+      QBENCHMARK {
+            rl.utick2utime(uticks, utimes);
+            }
+      QCOMPARE(utimes.size(), uticks.size());
+      }
+
+QTEST_MAIN(TestTempoMap)
+#include "tst_tempomap.moc"
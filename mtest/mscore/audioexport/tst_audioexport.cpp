@@ -0,0 +1,211 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "mscore/globals.h"
+#include "mscore/musescore.h"
+#include "mscore/preferences.h"
+#include "libmscore/score.h"
+#include "fluid/samplepool.h"
+#include "fluid/fluid.h"
+#include "fluid/sfont.h"
+#include "synthesizer/msynthesizer.h"
+#include "synthesizer/event.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   TestAudioExport
+//---------------------------------------------------------
+
+class TestAudioExport : public QObject
+      {
+      Q_OBJECT
+
+      QTemporaryDir tmpDir;
+      MasterScore* score { nullptr };
+      MasterScore* multiPart { nullptr };       // one midi channel per part
+
+      QByteArray render(MasterScore* s, int threads);
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+
+      void threadedDeterministic();
+      void threadedMatchesSerial();
+      void sharedSamplePool();
+      void prefetchSamples();
+      void benchmark_data();
+      void benchmark();
+      };
+
+void TestAudioExport::initTestCase()
+      {
+      qputenv("QML_DISABLE_DISK_CACHE", "true");
+      qSetMessagePattern("%{function}: %{message}");
+      MScore::noGui = true;
+      MScore::testMode = true;
+      initMuseScoreResources();
+
+      Ms::dataPath = tmpDir.path();
+      QStringList temp;
+      MuseScore::init(temp);
+      score = mscore->readScore(QString(TESTROOT "/mtest/libmscore/layout_elements/moonlight.mscx"));
+      QVERIFY(score);
+      multiPart = mscore->readScore(QString(TESTROOT "/mtest/libmscore/midi/testKantataBWV140Excerpts.mscx"));
+      QVERIFY(multiPart);
+      }
+
+void TestAudioExport::cleanupTestCase()
+      {
+      delete score;
+      delete multiPart;
+      qApp->processEvents();
+      delete Ms::mscore;
+      Ms::mscore = nullptr;
+      }
+
+//---------------------------------------------------------
+//   render
+//---------------------------------------------------------
+
+QByteArray TestAudioExport::render(MasterScore* s, int threads)
+      {
+      exportThreads = threads;
+      QByteArray data;
+      QBuffer device(&data);
+      bool ok = mscore->saveAudio(s, &device);
+      exportThreads = 0;
+      return ok ? data : QByteArray();
+      }
+
+//---------------------------------------------------------
+///   threadedDeterministic
+///   rendering on a synthesizer lane gives the same
+///   output on every run, independent of scheduling
+//---------------------------------------------------------
+
+void TestAudioExport::threadedDeterministic()
+      {
+      QByteArray a = render(multiPart, 2);
+      QByteArray b = render(multiPart, 2);
+      QVERIFY(!a.isEmpty());
+      QCOMPARE(a, b);
+      }
+
+//---------------------------------------------------------
+///   threadedMatchesSerial
+///   the lane splits process() calls and applies the master
+///   effects exactly as the serial loop does, so the output
+///   is the same
+//---------------------------------------------------------
+
+void TestAudioExport::threadedMatchesSerial()
+      {
+      const QByteArray serial   = render(multiPart, 1);
+      const QByteArray threaded = render(multiPart, 2);
+      QVERIFY(!serial.isEmpty());
+      QCOMPARE(threaded, serial);
+      }
+
+//---------------------------------------------------------
+///   sharedSamplePool
+///   every export creates new synthesizers; the samples
+///   decoded by the first one are reused by the next
+//---------------------------------------------------------
+
+void TestAudioExport::sharedSamplePool()
+      {
+      FluidS::SamplePool* pool = FluidS::SamplePool::instance();
+      QVERIFY(!render(score, 1).isEmpty());
+      const int misses = pool->misses();
+      const int hits   = pool->hits();
+      QVERIFY(misses > 0);
+      QVERIFY(!render(score, 1).isEmpty());
+      QCOMPARE(pool->misses(), misses);
+      QVERIFY(pool->hits() > hits);
+      }
+
+//---------------------------------------------------------
+///   prefetchSamples
+///   prefetched presets are decoded in the background;
+///   with asynchronous loading a program change returns
+///   before its samples are ready
+//---------------------------------------------------------
+
+void TestAudioExport::prefetchSamples()
+      {
+      MasterSynthesizer* synth = synthesizerFactory();
+      synth->init();
+      synth->setSampleRate(44100);
+      FluidS::Fluid* fluid = static_cast<FluidS::Fluid*>(synth->synthesizer("Fluid"));
+      FluidS::Preset* piano   = fluid->find_preset(0, 0);
+      FluidS::Preset* strings = fluid->find_preset(0, 48);
+      QVERIFY(piano && strings);
+
+      QVERIFY(!strings->pendingSamples().isEmpty());
+      synth->prefetch("Fluid", 0, 48);
+      fluid->waitForSamples();
+      QVERIFY(strings->pendingSamples().isEmpty());
+
+      fluid->setAsyncSampleLoading(true);
+      const int idx = synth->index("Fluid");
+      synth->play(NPlayEvent(ME_PROGRAM, 0, 0, 0), idx);
+      synth->play(NPlayEvent(ME_NOTEON, 0, 60, 100), idx);   // silent until loaded
+      std::vector<float> buffer(2 * 1024);
+      synth->process(1024, buffer.data());
+      fluid->waitForSamples();
+      QVERIFY(piano->pendingSamples().isEmpty());
+      delete synth;
+      }
+
+//---------------------------------------------------------
+///   benchmark
+///   realtime factor of the serial offline render and of
+///   the render on a synthesizer lane
+//---------------------------------------------------------
+
+void TestAudioExport::benchmark_data()
+      {
+      QTest::addColumn<int>("threads");
+      QTest::addRow("serial") << 1;
+      QTest::addRow("lane") << 2;
+      }
+
+void TestAudioExport::benchmark()
+      {
+      QFETCH(int, threads);
+      QElapsedTimer timer;
+      timer.start();
+      QByteArray data = render(multiPart, threads);
+      const qint64 elapsed = timer.elapsed();
+      QVERIFY(!data.isEmpty());
+
+      const int sampleRate = preferences.getInt(PREF_EXPORT_AUDIO_SAMPLERATE);
+      const double seconds = double(data.size()) / (2 * sizeof(float) * sampleRate);
+      qInfo("%d threads: %.1f s audio in %lld ms, realtime factor %.1f",
+         threads, seconds, elapsed, elapsed ? seconds * 1000.0 / elapsed : 0.0);
+      }
+
+} // namespace Ms
+
+QTEST_MAIN(Ms::TestAudioExport)
+#include "tst_audioexport.moc"
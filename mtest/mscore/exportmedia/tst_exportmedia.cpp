@@ -0,0 +1,105 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "mscore/globals.h"
+#include "mscore/musescore.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   TestExportMedia
+//---------------------------------------------------------
+
+class TestExportMedia : public QObject
+      {
+      Q_OBJECT
+
+      QTemporaryDir tmpDir;
+
+      QJsonObject exportMedia(int threads);
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+
+      void threadedPagesIdentical();
+      };
+
+void TestExportMedia::initTestCase()
+      {
+      qputenv("QML_DISABLE_DISK_CACHE", "true");
+      qSetMessagePattern("%{function}: %{message}");
+      MScore::noGui = true;
+      MScore::testMode = true;
+      initMuseScoreResources();
+
+      Ms::dataPath = tmpDir.path();
+      QStringList temp;
+      MuseScore::init(temp);
+      }
+
+void TestExportMedia::cleanupTestCase()
+      {
+      qApp->processEvents();
+      delete Ms::mscore;
+      Ms::mscore = nullptr;
+      }
+
+//---------------------------------------------------------
+//   exportMedia
+//---------------------------------------------------------
+
+QJsonObject TestExportMedia::exportMedia(int threads)
+      {
+      exportThreads = threads;
+      const QString outPath = tmpDir.filePath(QString("media-%1.json").arg(threads));
+      const bool ok = mscore->exportAllMediaFiles(QString(TESTROOT "/mtest/libmscore/layout_elements/moonlight.mscx"), outPath);
+      exportThreads = 0;
+      if (!ok)
+            return QJsonObject();
+
+      QFile f(outPath);
+      if (!f.open(QIODevice::ReadOnly))
+            return QJsonObject();
+      return QJsonDocument::fromJson(f.readAll()).object();
+      }
+
+//---------------------------------------------------------
+///   threadedPagesIdentical
+///   page images encoded on a thread pool are identical
+///   to the serially encoded ones and in page order
+//---------------------------------------------------------
+
+void TestExportMedia::threadedPagesIdentical()
+      {
+      QJsonObject serial = exportMedia(1);
+      QJsonObject threaded = exportMedia(4);
+
+      QVERIFY(serial["pngs"].isArray());
+      QVERIFY(serial["pngs"].toArray().size() > 0);
+      QCOMPARE(threaded["pngs"], serial["pngs"]);
+      QCOMPARE(threaded["svgs"], serial["svgs"]);
+      }
+
+} // namespace Ms
+
+QTEST_MAIN(Ms::TestExportMedia)
+#include "tst_exportmedia.moc"
@@ -0,0 +1,198 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <thread>
+#include "mtest/testutils.h"
+#include "mscore/globals.h"
+#include "mscore/musescore.h"
+#include "mscore/preferences.h"
+#include "synthesizer/msynthesizer.h"
+#include "synthesizer/synthesizer.h"
+#include "synthesizer/event.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   RenderStats
+//---------------------------------------------------------
+
+struct RenderStats {
+      int blocks   { 0 };
+      int dropouts { 0 };     // blocks without output while a note sounds
+      int xruns    { 0 };     // blocks which took longer than real time
+      };
+
+//---------------------------------------------------------
+//   TestSynthesizer
+//    render on an audio thread while the GUI thread
+//    changes the synthesizer state
+//---------------------------------------------------------
+
+class TestSynthesizer : public QObject
+      {
+      Q_OBJECT
+
+      static const int SAMPLE_RATE = 44100;
+      static const int FRAMES      = 256;
+      static const int BLOCKS      = 4000;
+
+      QTemporaryDir tmpDir;
+      MasterSynthesizer* synth { nullptr };
+      Synthesizer* zerberus    { nullptr };
+
+      RenderStats render(std::function<void()> change);
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+
+      void toggleEffects();
+      void toggleSoundFonts();
+      };
+
+void TestSynthesizer::initTestCase()
+      {
+      qputenv("QML_DISABLE_DISK_CACHE", "true");
+      qSetMessagePattern("%{function}: %{message}");
+      MScore::noGui = true;
+      MScore::testMode = true;
+      initMuseScoreResources();
+
+      Ms::dataPath = tmpDir.path();
+      QStringList temp;
+      MuseScore::init(temp);
+
+      preferences.setPreference(PREF_APP_PATHS_MYSOUNDFONTS, QString(TESTROOT "/mtest/zerberus"));
+      synth = synthesizerFactory();
+      synth->init();
+      synth->setSampleRate(SAMPLE_RATE);
+      zerberus = synth->synthesizer("Zerberus");
+      if (!zerberus)
+            QSKIP("built without Zerberus");
+      QVERIFY(zerberus->addSoundFont("loopTest.sfz"));
+      }
+
+void TestSynthesizer::cleanupTestCase()
+      {
+      delete synth;
+      qApp->processEvents();
+      delete Ms::mscore;
+      Ms::mscore = nullptr;
+      }
+
+//---------------------------------------------------------
+//   render
+//    hold a looping note on an audio thread and call
+//    change() on this thread until rendering is done
+//---------------------------------------------------------
+
+RenderStats TestSynthesizer::render(std::function<void()> change)
+      {
+      const int idx = synth->index("Zerberus");
+      synth->allSoundsOff(-1);
+      synth->play(NPlayEvent(ME_PROGRAM, 0, 0, 0), idx);
+      synth->play(NPlayEvent(ME_NOTEON, 0, 22, 127), idx);     // loop_continuous
+
+      RenderStats stats;
+      std::atomic<bool> done { false };
+      const qint64 budget = qint64(FRAMES) * 1000000000LL / SAMPLE_RATE;
+      std::thread audio([&]() {
+            std::vector<float> buffer(FRAMES * 2);
+            QElapsedTimer timer;
+            for (int i = 0; i < BLOCKS; ++i) {
+                  std::fill(buffer.begin(), buffer.end(), 0.0f);
+                  timer.start();
+                  synth->process(FRAMES, buffer.data());
+                  if (timer.nsecsElapsed() > budget)
+                        ++stats.xruns;
+                  // the first samples of the loop are silent
+                  if (i > 0 && std::all_of(buffer.begin(), buffer.end(), [](float f) { return f == 0.0f; }))
+                        ++stats.dropouts;
+                  ++stats.blocks;
+                  }
+            done = true;
+            });
+      while (!done)
+            change();
+      audio.join();
+
+      synth->play(NPlayEvent(ME_NOTEON, 0, 22, 0), idx);
+      return stats;
+      }
+
+//---------------------------------------------------------
+//   toggleEffects
+//    switching master effects never interrupts the output
+//---------------------------------------------------------
+
+void TestSynthesizer::toggleEffects()
+      {
+      int toggles = 0;
+      const int dropouts = synth->dropouts();
+      RenderStats stats = render([&]() {
+            synth->setEffect(0, toggles % synth->effectList(0).size());
+            synth->setEffect(1, (toggles / 2) % synth->effectList(1).size());
+            ++toggles;
+            QThread::usleep(200);
+            });
+      synth->setEffect(0, 0);
+      synth->setEffect(1, 0);
+
+      qInfo("%d effect changes, %d blocks: %d dropouts, %d xruns", toggles, stats.blocks, stats.dropouts, stats.xruns);
+      QVERIFY(toggles > 1);
+      QCOMPARE(stats.blocks, BLOCKS);
+      QCOMPARE(stats.dropouts, 0);
+      QCOMPARE(synth->dropouts(), dropouts);
+      }
+
+//---------------------------------------------------------
+//   toggleSoundFonts
+//    loading and removing a second instrument; only
+//    installing it pauses the synthesizer
+//---------------------------------------------------------
+
+void TestSynthesizer::toggleSoundFonts()
+      {
+      QVERIFY(zerberus->addSoundFont("envelopesTest.sfz"));
+      const QString path = zerberus->soundFontsInfo().back().fileName;
+      QVERIFY(path.endsWith("envelopesTest.sfz"));
+      QVERIFY(zerberus->removeSoundFont(path));
+
+      int toggles = 0;
+      RenderStats stats = render([&]() {
+            if (toggles % 2)
+                  zerberus->removeSoundFont(path);
+            else
+                  zerberus->addSoundFont("envelopesTest.sfz");
+            ++toggles;
+            });
+      if (toggles % 2)
+            zerberus->removeSoundFont(path);
+
+      qInfo("%d soundfont changes, %d blocks: %d dropouts, %d xruns", toggles, stats.blocks, stats.dropouts, stats.xruns);
+      QVERIFY(toggles > 1);
+      QCOMPARE(stats.blocks, BLOCKS);
+      QVERIFY(stats.dropouts < toggles / 2 + 1);
+      }
+
+} // namespace Ms
+
+QTEST_MAIN(Ms::TestSynthesizer)
+#include "tst_synthesizer.moc"
@@ -41,6 +41,7 @@ class TestMxmlIO : public QObject, public MTest
       void mxmlMscxExportTestRef(const char* file);
       void mxmlReadTestCompr(const char* file);
       void mxmlReadWriteTestCompr(const char* file);
+      void mxmlReaderTest(const char* file, bool ref);
 
 
       // The list of MusicXML regression tests
@@ -141,6 +142,13 @@ private slots:
       void numberedLyrics() { mxmlIoTestRef("testNumberedLyrics"); }
       void overlappingSpanners() { mxmlIoTest("testOverlappingSpanners"); }
       void printSpacingNo() { mxmlIoTestRef("testPrintSpacingNo"); }
+      void readerAccidentals() { mxmlReaderTest("testAccidentals1", false); }
+      void readerGrace() { mxmlReaderTest("testGrace1", false); }
+      void readerDurationRoundingError() { mxmlReaderTest("testDurationRoundingError", true); }
+      void readerNoteAttributes() { mxmlReaderTest("testNoteAttributes2", true); }
+      void readerTablature() { mxmlReaderTest("testTablature1", false); }
+      void readerTuplets() { mxmlReaderTest("testTuplets1", true); }
+      void readerUnusualDurations() { mxmlReaderTest("testUnusualDurations", true); }
       void repeatCounts() { mxmlIoTest("testRepeatCounts"); }
       void repeatSingleMeasure() { mxmlIoTest("testRepeatSingleMeasure"); }
       void restNotations() { mxmlIoTestRef("testRestNotations"); }
@@ -258,6 +266,27 @@ void TestMxmlIO::mxmlIoTestRef(const char* file)
       delete score;
       }
 
+//---------------------------------------------------------
+//   mxmlReaderTest
+//   run mxmlIoTest or mxmlIoTestRef with schema validation
+//   enabled and disabled, the import replays the same
+//   event stream in both cases
+//---------------------------------------------------------
+
+void TestMxmlIO::mxmlReaderTest(const char* file, bool ref)
+      {
+      for (bool validate : { true, false }) {
+            preferences.setPreference(PREF_IMPORT_MUSICXML_VALIDATE, validate);
+            if (ref)
+                  mxmlIoTestRef(file);
+            else
+                  mxmlIoTest(file);
+            if (QTest::currentTestFailed())
+                  break;
+            }
+      preferences.setPreference(PREF_IMPORT_MUSICXML_VALIDATE, true);
+      }
+
 //---------------------------------------------------------
 //   mxmlMscxExportTestRef
 //   read a MuseScore mscx file, write to a MusicXML file and verify against reference
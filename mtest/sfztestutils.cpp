@@ -0,0 +1,114 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <sndfile.h>
+
+#include "testutils.h"
+#include "mscore/preferences.h"
+#include "synthesizer/event.h"
+#include "zerberus/zerberus.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   initSfzTest
+//    the temporary directory is where the synthesizer
+//    looks for instruments
+//---------------------------------------------------------
+
+bool SfzTest::initSfzTest()
+      {
+      if (!sfzDir.isValid())
+            return false;
+      preferences.setPreference(PREF_APP_PATHS_MYSOUNDFONTS, sfzDir.path());
+      return true;
+      }
+
+//---------------------------------------------------------
+//   writeSample
+//    16 bit wav; wave returns values in [-1, 1]
+//---------------------------------------------------------
+
+bool SfzTest::writeSample(const QString& name, int frames, int channels, std::function<double(int frame, int channel)> wave)
+      {
+      std::vector<short> data(frames * channels);
+      for (int i = 0; i < frames; ++i) {
+            for (int c = 0; c < channels; ++c)
+                  data[i * channels + c] = short(lrint(20000.0 * wave(i, c)));
+            }
+      SF_INFO info;
+      memset(&info, 0, sizeof(info));
+      info.channels   = channels;
+      info.samplerate = SAMPLE_RATE;
+      info.format     = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+      SNDFILE* sf = sf_open(QFile::encodeName(sfzDir.path() + "/" + name).constData(), SFM_WRITE, &info);
+      if (!sf)
+            return false;
+      bool ok = sf_writef_short(sf, data.data(), frames) == sf_count_t(frames);
+      sf_close(sf);
+      return ok;
+      }
+
+//---------------------------------------------------------
+//   writeSfz
+//---------------------------------------------------------
+
+bool SfzTest::writeSfz(const QString& name, const QByteArray& sfz)
+      {
+      QFile f(sfzDir.path() + "/" + name);
+      if (!f.open(QIODevice::WriteOnly))
+            return false;
+      return f.write(sfz) == sfz.size();
+      }
+
+//---------------------------------------------------------
+//   createSynth
+//    rendering offline, the synthesizer reads the streams
+//    itself; preload 0 loads all samples
+//---------------------------------------------------------
+
+Zerberus* SfzTest::createSynth(const QString& sfz, int preload)
+      {
+      Zerberus* synth = new Zerberus();
+      synth->init(SAMPLE_RATE);
+      synth->setOfflineRendering(true);
+      synth->setStreamPreload(preload);
+      synth->loadInstrument(sfz);
+      synth->play(PlayEvent(ME_PROGRAM, 0, 0, 0));
+      return synth;
+      }
+
+//---------------------------------------------------------
+//   render
+//    play key for blocks of BLOCK frames; the key is
+//    released before releaseBlock, or after the last
+//    block if releaseBlock is -1
+//---------------------------------------------------------
+
+std::vector<float> SfzTest::render(Zerberus* synth, int key, int blocks, int releaseBlock)
+      {
+      std::vector<float> out;
+      std::vector<float> buffer(BLOCK * 2);
+      synth->play(PlayEvent(ME_NOTEON, 0, key, 100));
+      for (int i = 0; i < blocks; ++i) {
+            if (i == releaseBlock)
+                  synth->play(PlayEvent(ME_NOTEON, 0, key, 0));
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+            synth->process(BLOCK, buffer.data(), nullptr, nullptr);
+            out.insert(out.end(), buffer.begin(), buffer.end());
+            }
+      if (releaseBlock < 0)
+            synth->play(PlayEvent(ME_NOTEON, 0, key, 0));
+      return out;
+      }
+
+}
@@ -14,8 +14,12 @@
 #define __TESTUTILS_H__
 
 
+#include <functional>
+#include <QTemporaryDir>
 #include "libmscore/element.h"
 
+class Zerberus;
+
 namespace Ms {
       class MScore;
       class MasterScore;
@@ -52,6 +56,26 @@ class MTest {
 
       static QString rootPath();
       };
+
+//---------------------------------------------------------
+//   SfzTest
+//    instruments written to a temporary directory, which
+//    is the soundfont directory of the test
+//---------------------------------------------------------
+
+class SfzTest {
+   protected:
+      static const int SAMPLE_RATE = 44100;
+      static const int BLOCK       = 256;
+
+      QTemporaryDir sfzDir;
+
+      bool initSfzTest();
+      bool writeSample(const QString& name, int frames, int channels, std::function<double(int frame, int channel)> wave);
+      bool writeSfz(const QString& name, const QByteArray& sfz);
+      Zerberus* createSynth(const QString& sfz, int preload = 0);
+      std::vector<float> render(Zerberus* synth, int key, int blocks, int releaseBlock = -1);
+      };
 }
 
 void initMuseScoreResources();
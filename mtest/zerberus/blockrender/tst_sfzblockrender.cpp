@@ -0,0 +1,175 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+
+#include "mtest/testutils.h"
+
+#include "zerberus/zerberus.h"
+#include "zerberus/voice.h"
+#include "synthesizer/event.h"
+
+using namespace Ms;
+
+static const int VOICES = 64;
+
+//---------------------------------------------------------
+//   TestSfzBlockRender
+//    block rendering stays close to the frame by frame
+//    reference and renders more voices per core
+//---------------------------------------------------------
+
+class TestSfzBlockRender : public QObject, public MTest, public SfzTest
+      {
+      Q_OBJECT
+
+      std::vector<float> render(int key, bool block);
+
+   private slots:
+      void initTestCase();
+      void goldenOutput_data();
+      void goldenOutput();
+      void voicesPerCore_data();
+      void voicesPerCore();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//    2 s samples of a sine with an overtone, the right
+//    channel a fifth above the left; instruments with
+//    variable envelopes, a loop, a short release, a stereo
+//    sample and one looping region for all keys
+//---------------------------------------------------------
+
+void TestSfzBlockRender::initTestCase()
+      {
+      initMTest();
+      QVERIFY(initSfzTest());
+      auto wave = [](int i, int c) {
+            double f = 441.0 * (c ? 1.5 : 1.0);
+            return sin(i * 2.0 * M_PI * f / SAMPLE_RATE) + 0.3 * sin(i * 6.0 * M_PI * f / SAMPLE_RATE);
+            };
+      QVERIFY(writeSample("mono.wav", 2 * SAMPLE_RATE, 1, wave));
+      QVERIFY(writeSample("stereo.wav", 2 * SAMPLE_RATE, 2, wave));
+      QVERIFY(writeSfz("render.sfz",
+            "<group> sample=mono.wav ampeg_attack=0.005 ampeg_decay=0.05 ampeg_sustain=60 ampeg_release=0.1\n"
+            "<region> lokey=48 hikey=71 pitch_keycenter=60 loop_mode=no_loop\n"
+            "<region> key=72 loop_mode=loop_continuous loop_start=1000 loop_end=1500\n"
+            "<region> key=73 ampeg_delay=0.01 ampeg_hold=0.02 ampeg_release=0.001 loop_mode=no_loop\n"
+            "<group> sample=stereo.wav ampeg_attack=0.002 ampeg_release=0.05\n"
+            "<region> lokey=84 hikey=95 pitch_keycenter=84 loop_mode=no_loop\n"));
+      QVERIFY(writeSfz("benchmark.sfz",
+            "<region> sample=mono.wav lokey=0 hikey=127 pitch_keycenter=60 loop_mode=loop_continuous loop_start=1000 loop_end=1500\n"));
+      }
+
+//---------------------------------------------------------
+//   render
+//    0.5 s note and 0.3 s release
+//---------------------------------------------------------
+
+std::vector<float> TestSfzBlockRender::render(int key, bool block)
+      {
+      Zerberus* synth = createSynth("render.sfz");
+      synth->setBlockRendering(block);
+      std::vector<float> out = SfzTest::render(synth, key, SAMPLE_RATE * 8 / 10 / BLOCK, SAMPLE_RATE / 2 / BLOCK);
+      delete synth;
+      return out;
+      }
+
+//---------------------------------------------------------
+//   goldenOutput
+//    The frame by frame rendering is the reference. Block
+//    rendering ramps the envelope linearly where the
+//    reference steps through its table, so a frame may be
+//    off by one step of the exponential table, 80 dB in
+//    EG_SIZE steps. The ramp crosses the steps, so on
+//    average the deviation is much smaller.
+//---------------------------------------------------------
+
+void TestSfzBlockRender::goldenOutput_data()
+      {
+      QTest::addColumn<int>("key");
+      QTest::newRow("mono")       << 60;
+      QTest::newRow("transposed") << 67;
+      QTest::newRow("loop")       << 72;
+      QTest::newRow("delay")      << 73;
+      QTest::newRow("stereo")     << 84;
+      QTest::newRow("stereo transposed") << 89;
+      }
+
+void TestSfzBlockRender::goldenOutput()
+      {
+      QFETCH(int, key);
+      std::vector<float> reference = render(key, false);
+      std::vector<float> block     = render(key, true);
+      QCOMPARE(reference.size(), block.size());
+
+      float peak    = 0.0;
+      double maxDev = 0.0;
+      double sum    = 0.0;
+      for (size_t i = 0; i < reference.size(); ++i) {
+            peak   = std::max(peak, std::fabs(reference[i]));
+            double d = std::fabs(double(reference[i]) - double(block[i]));
+            maxDev = std::max(maxDev, d);
+            sum   += d * d;
+            }
+      const double rms = sqrt(sum / reference.size());
+      qInfo("peak %f, max. deviation %g, rms deviation %g", peak, maxDev, rms);
+      const double envelopeStep = 1.0 - pow(10.0, -80.0 / EG_SIZE / 20.0);
+      QVERIFY(peak > 0.01);
+      QVERIFY(maxDev <= envelopeStep * peak);
+      QVERIFY(rms <= 0.002 * peak);
+      }
+
+//---------------------------------------------------------
+//   voicesPerCore
+//    render VOICES looping voices for one second on one
+//    thread and report how many voices a core renders in
+//    real time
+//---------------------------------------------------------
+
+void TestSfzBlockRender::voicesPerCore_data()
+      {
+      QTest::addColumn<bool>("block");
+      QTest::newRow("frames") << false;
+      QTest::newRow("blocks") << true;
+      }
+
+void TestSfzBlockRender::voicesPerCore()
+      {
+      QFETCH(bool, block);
+      Zerberus* synth = createSynth("benchmark.sfz");
+      synth->setBlockRendering(block);
+      for (int i = 0; i < VOICES; ++i)
+            synth->play(Ms::PlayEvent(ME_NOTEON, 0, 36 + i, 100));
+      std::vector<float> buffer(BLOCK * 2);
+      auto renderSecond = [&]() {
+            for (int i = 0; i < SAMPLE_RATE / BLOCK; ++i) {
+                  std::fill(buffer.begin(), buffer.end(), 0.0f);
+                  synth->process(BLOCK, buffer.data(), nullptr, nullptr);
+                  }
+            };
+      QBENCHMARK {
+            renderSecond();
+            }
+      QElapsedTimer timer;
+      timer.start();
+      renderSecond();
+      qint64 ns = std::max(timer.nsecsElapsed(), qint64(1));
+      qInfo("%d voices per core", int(VOICES * 1e9 * (SAMPLE_RATE / BLOCK * BLOCK) / SAMPLE_RATE / ns));
+      QVERIFY(std::any_of(buffer.begin(), buffer.end(), [](float f) { return f != 0.0f; }));
+      delete synth;
+      }
+
+QTEST_MAIN(TestSfzBlockRender)
+
+#include "tst_sfzblockrender.moc"
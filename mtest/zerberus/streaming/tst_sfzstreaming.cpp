@@ -0,0 +1,228 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+
+#include "mtest/testutils.h"
+
+#include "zerberus/instrument.h"
+#include "zerberus/streamer.h"
+#include "zerberus/zerberus.h"
+#include "zerberus/zone.h"
+#include "synthesizer/event.h"
+
+using namespace Ms;
+
+static const int SAMPLE_SECONDS = 10;
+static const int REGIONS        = 16;
+static const int PRELOAD        = 100;      // ms
+
+//---------------------------------------------------------
+//   TestSfzStreaming
+//    a streamed instrument sounds like the fully loaded
+//    one with a fraction of its memory
+//---------------------------------------------------------
+
+class TestSfzStreaming : public QObject, public MTest, public SfzTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase();
+      void streamedEqualsFull_data();
+      void streamedEqualsFull();
+      void memory();
+      void sharedInstrument();
+      void changePreload();
+      void removeWhilePlaying();
+      void benchmarkLoad_data();
+      void benchmarkLoad();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//    write a 10 s sine sample and instruments with a
+//    plain, a transposed and a looping region and one
+//    which plays to the end of the sample
+//---------------------------------------------------------
+
+void TestSfzStreaming::initTestCase()
+      {
+      initMTest();
+      QVERIFY(initSfzTest());
+
+      const int frames = SAMPLE_RATE * SAMPLE_SECONDS;
+      QVERIFY(writeSample("sine.wav", frames, 1, [frames](int i, int) {
+            return sin(i * 2.0 * M_PI * 441.0 / SAMPLE_RATE) * (1.0 - 0.5 * i / frames);
+            }));
+
+      QByteArray sfz = "<group> sample=sine.wav ampeg_release=0\n"
+                       "<region> lokey=48 hikey=71 pitch_keycenter=60 loop_mode=no_loop\n"
+                       "<region> key=72 loop_mode=loop_continuous loop_start=100000 loop_end=101000\n"
+                       "<region> key=84 pitch_keycenter=60 loop_mode=no_loop\n";
+      for (int i = 0; i < REGIONS; ++i)
+            sfz += QString("<region> key=%1 loop_mode=no_loop\n").arg(20 + i).toLatin1();
+      QVERIFY(writeSfz("sine.sfz", sfz));
+      QVERIFY(writeSfz("benchmark.sfz", sfz));
+      }
+
+//---------------------------------------------------------
+//   streamedEqualsFull
+//---------------------------------------------------------
+
+void TestSfzStreaming::streamedEqualsFull_data()
+      {
+      QTest::addColumn<int>("key");
+      QTest::newRow("plain")      << 60;
+      QTest::newRow("transposed") << 71;
+      QTest::newRow("loop")       << 72;
+      QTest::newRow("end")        << 84;
+      }
+
+void TestSfzStreaming::streamedEqualsFull()
+      {
+      QFETCH(int, key);
+      Zerberus* full     = createSynth("sine.sfz", 0);
+      Zerberus* streamed = createSynth("sine.sfz", PRELOAD);
+      QCOMPARE(streamed->instrument(0)->zones().size(), size_t(REGIONS + 3));
+      QVERIFY(streamed->instrument(0)->streamed());
+      QVERIFY(!full->instrument(0)->streamed());
+
+      // 5 s, past the preloaded part, through the loop and,
+      // two octaves up, past the end of the sample
+      const int blocks = 5 * SAMPLE_RATE / BLOCK;
+      std::vector<float> a = render(full, key, blocks);
+      std::vector<float> b = render(streamed, key, blocks);
+      QCOMPARE(a.size(), b.size());
+      QVERIFY(std::any_of(a.begin(), a.end(), [](float f) { return f != 0.0f; }));
+      for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i] != b[i])
+                  QFAIL(qPrintable(QString("streamed output differs at frame %1").arg(i / 2)));
+            }
+      QCOMPARE(streamed->streamUnderruns(), 0);
+      delete full;
+      delete streamed;
+      }
+
+//---------------------------------------------------------
+//   memory
+//    only the preloaded frames and loops are resident
+//---------------------------------------------------------
+
+void TestSfzStreaming::memory()
+      {
+      Zerberus* full     = createSynth("sine.sfz", 0);
+      Zerberus* streamed = createSynth("sine.sfz", PRELOAD);
+      qInfo("sample memory: full %zu kB, streamed %zu kB", full->sampleMemory() / 1024, streamed->sampleMemory() / 1024);
+      QVERIFY(streamed->sampleMemory() * 10 < full->sampleMemory());
+      delete full;
+      delete streamed;
+      }
+
+//---------------------------------------------------------
+//   sharedInstrument
+//    synthesizers share an instrument only if they load
+//    it in the same streaming mode
+//---------------------------------------------------------
+
+void TestSfzStreaming::sharedInstrument()
+      {
+      Zerberus* full      = createSynth("sine.sfz", 0);
+      Zerberus* streamed  = createSynth("sine.sfz", PRELOAD);
+      Zerberus* streamed2 = createSynth("sine.sfz", PRELOAD);
+      QVERIFY(full->instrument(0) != streamed->instrument(0));
+      QVERIFY(streamed->instrument(0) == streamed2->instrument(0));
+      QVERIFY(!full->instrument(0)->streamed());
+      QVERIFY(streamed->instrument(0)->streamed());
+      delete full;
+      delete streamed;
+      delete streamed2;
+      }
+
+//---------------------------------------------------------
+//   changePreload
+//    the loaded instrument is read again in the new mode
+//---------------------------------------------------------
+
+void TestSfzStreaming::changePreload()
+      {
+      Zerberus* synth = createSynth("sine.sfz", 0);
+      QVERIFY(!synth->instrument(0)->streamed());
+      synth->setStreamPreload(PRELOAD);
+      QVERIFY(synth->instrument(0));
+      QVERIFY(synth->instrument(0)->streamed());
+      std::vector<float> out = render(synth, 60, 2 * SAMPLE_RATE / BLOCK);
+      QVERIFY(std::any_of(out.begin(), out.end(), [](float f) { return f != 0.0f; }));
+      QCOMPARE(synth->streamUnderruns(), 0);
+      synth->setStreamPreload(0);
+      QVERIFY(!synth->instrument(0)->streamed());
+      delete synth;
+      }
+
+//---------------------------------------------------------
+//   removeWhilePlaying
+//    removing the instrument stops its streamed voices
+//    before the samples are deleted
+//---------------------------------------------------------
+
+void TestSfzStreaming::removeWhilePlaying()
+      {
+      Zerberus* synth = createSynth("sine.sfz", PRELOAD);
+      std::vector<float> buffer(BLOCK * 2);
+      synth->play(Ms::PlayEvent(ME_NOTEON, 0, 60, 127));
+      synth->play(Ms::PlayEvent(ME_NOTEON, 0, 72, 127));
+      for (int i = 0; i < SAMPLE_RATE / BLOCK; ++i)
+            synth->process(BLOCK, buffer.data(), nullptr, nullptr);
+      QVERIFY(synth->getActiveVoices());
+
+      QVERIFY(synth->removeSoundFont(synth->instrument(0)->path()));
+      QVERIFY(!synth->getActiveVoices());
+      for (int i = 0; i < MAX_VOICES; ++i)
+            QVERIFY(!synth->stream(i)->sample.load());
+      for (int i = 0; i < 10; ++i) {
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+            synth->process(BLOCK, buffer.data(), nullptr, nullptr);
+            QVERIFY(std::all_of(buffer.begin(), buffer.end(), [](float f) { return f == 0.0f; }));
+            }
+      delete synth;
+      }
+
+//---------------------------------------------------------
+//   benchmarkLoad
+//    instrument load time; after the first run the sample
+//    file is in the page cache, so the difference shows
+//    the cost of reading and converting all frames
+//---------------------------------------------------------
+
+void TestSfzStreaming::benchmarkLoad_data()
+      {
+      QTest::addColumn<int>("preload");
+      QTest::newRow("full")     << 0;
+      QTest::newRow("streamed") << PRELOAD;
+      }
+
+void TestSfzStreaming::benchmarkLoad()
+      {
+      QFETCH(int, preload);
+      size_t memory = 0;
+      QBENCHMARK {
+            Zerberus* synth = createSynth("benchmark.sfz", preload);
+            memory = synth->sampleMemory();
+            delete synth;
+            }
+      qInfo("%zu kB sample memory", memory / 1024);
+      QVERIFY(memory > 0);
+      }
+
+QTEST_MAIN(TestSfzStreaming)
+
+#include "tst_sfzstreaming.moc"
@@ -392,51 +392,449 @@ void EventList::insert(const Event& e)
       append(e);
       }
 
+// a block grows by single inserts up to this size; a full
+// block gets a successor of twice its size
+static const size_t EVENT_BLOCK_SIZE = 4096;
+static const size_t EVENT_BLOCK_MIN  = 16;
+
 //---------------------------------------------------------
-//   class EventMap::fixupMIDI
+//   EventMap
+//    a copy gets unsplit blocks of its own
 //---------------------------------------------------------
 
-void EventMap::fixupMIDI()
+EventMap::EventMap(const EventMap& m)
+   : _size(m._size), _highestChannel(m._highestChannel), _fixup(m._fixup),
+     _fixupTick(m._fixupTick), _fixupSize(m._fixupSize)
+      {
+      _blocks.reserve(m._blocks.size());
+      for (const auto& b : m._blocks) {
+            const auto first = b->events->begin();
+            _blocks.push_back(std::unique_ptr<Block>(new Block(std::vector<value_type>(first + b->begin, first + b->end))));
+            _blocks.back()->index = _blocks.size() - 1;
+            }
+      }
+
+EventMap& EventMap::operator=(const EventMap& m)
+      {
+      if (this != &m) {
+            EventMap copy(m);
+            _blocks.swap(copy._blocks);
+            _size           = m._size;
+            _highestChannel = m._highestChannel;
+            _fixup          = m._fixup;
+            _fixupTick      = m._fixupTick;
+            _fixupSize      = m._fixupSize;
+            }
+      return *this;
+      }
+
+//---------------------------------------------------------
+//   EventMap::clear
+//---------------------------------------------------------
+
+void EventMap::clear()
+      {
+      _blocks.clear();
+      _size = 0;
+      resetFixup();
+      _fixupSize = 0;
+      }
+
+//---------------------------------------------------------
+//   EventMap::memoryUsage
+//    bytes allocated for the events and their blocks; the
+//    storage of a split block is counted with its first piece
+//---------------------------------------------------------
+
+size_t EventMap::memoryUsage() const
+      {
+      size_t n = sizeof(EventMap) + _blocks.capacity() * sizeof(std::unique_ptr<Block>);
+      for (const auto& b : _blocks) {
+            n += sizeof(Block);
+            if (!b->splitFrom)
+                  n += b->events->capacity() * sizeof(value_type);
+            }
+      return n;
+      }
+
+//---------------------------------------------------------
+//   EventMap::blockAfter
+//    index of the first block with events after tick,
+//    or at tick if !equal
+//---------------------------------------------------------
+
+size_t EventMap::blockAfter(int tick, bool equal) const
+      {
+      auto i = std::partition_point(_blocks.begin(), _blocks.end(), [tick, equal](const std::unique_ptr<Block>& b) {
+            const int last = b->back().first;
+            return equal ? last <= tick : last < tick;
+            });
+      return i - _blocks.begin();
+      }
+
+//---------------------------------------------------------
+//   EventMap::bound
+//    upper_bound() if equal, else lower_bound()
+//---------------------------------------------------------
+
+EventMap::const_iterator EventMap::bound(int tick, bool equal) const
+      {
+      const size_t b = blockAfter(tick, equal);
+      if (b == _blocks.size())
+            return cend();
+      const Block* block = _blocks[b].get();
+      const auto first   = block->events->begin();
+      auto i = std::partition_point(first + block->begin, first + block->end, [tick, equal](const value_type& e) {
+            return equal ? e.first <= tick : e.first < tick;
+            });
+      return const_iterator(this, _blocks[b].get(), i - first);
+      }
+
+//---------------------------------------------------------
+//   EventMap::appendBlock
+//---------------------------------------------------------
+
+void EventMap::appendBlock(std::vector<value_type>&& events)
+      {
+      _blocks.push_back(std::unique_ptr<Block>(new Block(std::move(events))));
+      _blocks.back()->index = _blocks.size() - 1;
+      }
+
+//---------------------------------------------------------
+//   EventMap::eraseBlocks
+//    remove n blocks at pos; pieces of a split block that
+//    are still in use keep the storage alive
+//---------------------------------------------------------
+
+void EventMap::eraseBlocks(size_t pos, size_t n)
       {
-      /* track info for each of the 128 possible MIDI notes */
-      struct channelInfo {
-            /* which event the first ME_NOTEON came from */
-            NPlayEvent *event[128];
-            /* how often is the note on right now? */
-            unsigned short nowPlaying[128];
+      _blocks.erase(_blocks.begin() + pos, _blocks.begin() + pos + n);
+      for (size_t i = pos; i < _blocks.size(); ++i)
+            _blocks[i]->index = i;
+      }
+
+//---------------------------------------------------------
+//   EventMap::removeEvents
+//    remove the events from index from up to, but not
+//    including to from block b, moving the later events of
+//    the block down; the block may become empty
+//---------------------------------------------------------
+
+void EventMap::removeEvents(Block* b, size_t from, size_t to)
+      {
+      if (from == to)
+            return;
+      std::vector<value_type>& events = *b->events;
+      const size_t end = b->end - (to - from);
+      if (b->end == events.size())
+            events.erase(events.begin() + from, events.begin() + to);
+      else
+            std::move(events.begin() + to, events.begin() + b->end, events.begin() + from);
+      b->end = end;
+      _size -= to - from;
+      }
+
+//---------------------------------------------------------
+//   EventMap::insert
+//    An event at or after the last one is appended to the
+//    last block if that has room left without reallocation,
+//    so existing events never move.
+//---------------------------------------------------------
+
+void EventMap::insert(const value_type& event)
+      {
+      if (!_blocks.empty() && event.first < _blocks.back()->back().first) {
+            insertSorted(std::vector<value_type>(1, event));
+            return;
+            }
+      Block* last = _blocks.empty() ? nullptr : _blocks.back().get();
+      if (last && last->end == last->events->size() && last->end < last->events->capacity())
+            last->events->push_back(event);
+      else {
+            std::vector<value_type> events;
+            events.reserve(last ? qBound(EVENT_BLOCK_MIN, 2 * last->size(), EVENT_BLOCK_SIZE) : EVENT_BLOCK_MIN);
+            events.push_back(event);
+            appendBlock(std::move(events));
+            last = _blocks.back().get();
+            }
+      last->end = last->events->size();
+      ++_size;
+      }
+
+//---------------------------------------------------------
+//   EventMap::insertSorted
+//    Add a run of events sorted by tick. A run starting
+//    at or after the last event becomes a block of its
+//    own. Otherwise the run is cut where it falls between
+//    existing events; each part becomes a new block, and a
+//    block it falls into is split in two pieces around it.
+//---------------------------------------------------------
+
+void EventMap::insertSorted(std::vector<value_type>&& events)
+      {
+      _size += events.size();
+      if (_blocks.empty() || events.front().first >= _blocks.back()->back().first) {
+            appendBlock(std::move(events));
+            return;
+            }
+
+      // the parts of the run and where they go: new events go
+      // after existing ones with the same tick
+      struct Part {
+            size_t from, to;        // in events
+            const_iterator pos;
             };
+      std::vector<Part> parts;
+      for (size_t i = 0; i < events.size();) {
+            const const_iterator pos = bound(events[i].first, true);
+            size_t n = i + 1;
+            if (!pos._block)
+                  n = events.size();
+            else {
+                  const int limit = (*pos._block)[pos._idx].first;
+                  while (n < events.size() && events[n].first < limit)
+                        ++n;
+                  }
+            parts.push_back(Part { i, n, pos });
+            i = n;
+            }
 
-      /* track info for each channel (on the heap, 0-initialised) */
-      struct channelInfo *info = (struct channelInfo *)calloc(_highestChannel + 1, sizeof(struct channelInfo));
-
-      auto it = begin();
-      while (it != end()) {
-            NPlayEvent& event = it->second;
-            /* ME_NOTEOFF is never emitted, no need to check for it */
-            if (event.type() == ME_NOTEON && !event.isMuted()) {
-                  unsigned short np = info[event.channel()].nowPlaying[event.pitch()];
-                  if (event.velo() == 0) {
-                        /* already off (should not happen) or still playing? */
-                        if (np == 0 || --np > 0)
-                              event.setDiscard(1);
-                        else {
-                              /* hoist NOTEOFF to same track as NOTEON */
-                              event.setOriginatingStaff(info[event.channel()].event[event.pitch()]->getOriginatingStaff());
-                              }
+      std::vector<std::unique_ptr<Block>> blocks;
+      blocks.reserve(_blocks.size() + 2 * parts.size());
+      auto newBlock = [&](const Part& part) {
+            blocks.push_back(std::unique_ptr<Block>(new Block(part.to - part.from == events.size()
+               ? std::move(events)
+               : std::vector<value_type>(events.begin() + part.from, events.begin() + part.to))));
+            };
+      auto part = parts.begin();
+      for (std::unique_ptr<Block>& b : _blocks) {
+            const Block* old = b.get();
+            Block* block     = b.get();
+            for (; part != parts.end() && part->pos._block == old; ++part) {
+                  if (part->pos._idx > block->begin) {
+                        // split the block, the second piece keeps the storage
+                        Block* piece     = new Block(block->events, part->pos._idx, block->end);
+                        piece->split     = block->split;
+                        piece->splitFrom = block;
+                        if (block->split)
+                              block->split->splitFrom = piece;
+                        block->split     = piece;
+                        block->end       = part->pos._idx;
+                        blocks.push_back(std::move(b));
+                        b.reset(piece);
+                        block = piece;
                         }
+                  newBlock(*part);
+                  }
+            blocks.push_back(std::move(b));
+            }
+      for (; part != parts.end(); ++part)
+            newBlock(*part);
+
+      _blocks.swap(blocks);
+      for (size_t i = 0; i < _blocks.size(); ++i)
+            _blocks[i]->index = i;
+      }
+
+//---------------------------------------------------------
+//   EventMap::erase
+//---------------------------------------------------------
+
+EventMap::iterator EventMap::erase(const_iterator i)
+      {
+      i.normalize();
+      Block* b = i._block;
+      removeEvents(b, i._idx, i._idx + 1);
+      size_t idx = b->index;
+      if (b->end == b->begin)
+            eraseBlocks(idx, 1);
+      else if (i._idx < b->end)
+            return iterator(this, b, i._idx);
+      else
+            ++idx;
+      return idx < _blocks.size() ? iterator(this, _blocks[idx].get(), _blocks[idx]->begin) : end();
+      }
+
+EventMap::iterator EventMap::erase(const_iterator first, const_iterator last)
+      {
+      first.normalize();
+      last.normalize();
+      if (first == last)
+            return mutableIterator(first);
+      Block* fb = first._block;
+      Block* lb = last._block;
+      if (fb == lb) {
+            removeEvents(fb, first._idx, last._idx);
+            return iterator(this, fb, first._idx);
+            }
+
+      size_t pos = fb->index;
+      if (first._idx > fb->begin) {
+            removeEvents(fb, first._idx, fb->end);
+            ++pos;
+            }
+      const size_t stop = lb ? lb->index : _blocks.size();
+      for (size_t b = pos; b < stop; ++b)
+            _size -= _blocks[b]->size();
+      // the events before last are dropped from the front of its block
+      if (lb) {
+            _size   -= last._idx - lb->begin;
+            lb->begin = last._idx;
+            }
+      eraseBlocks(pos, stop - pos);
+      return lb ? iterator(this, lb, lb->begin) : end();
+      }
+
+//---------------------------------------------------------
+//   EventMap::fixupMIDI
+//    fix up the whole map
+//---------------------------------------------------------
+
+void EventMap::fixupMIDI()
+      {
+      resetFixup();
+      fixupFrom(INT_MIN);
+      }
+
+//---------------------------------------------------------
+//   EventMap::insertChunk
+//    Add the events of a freshly rendered chunk and fix up
+//    only the part of the map they can affect. The state of
+//    the fixup pass is carried over from the previous call,
+//    so rendering a score chunk by chunk stays linear.
+//---------------------------------------------------------
+
+void EventMap::insertChunk(const EventMap& chunk)
+      {
+      if (chunk.empty())
+            return;
+      // someone else inserted or removed events since the last call
+      if (size() != _fixupSize)
+            resetFixup();
+      registerChannel(chunk._highestChannel);
+      const int tick = chunk.cbegin()->first;
+      insert(chunk.cbegin(), chunk.cend());
+      fixupFrom(tick);
+      }
+
+//---------------------------------------------------------
+//   EventMap::resetFixup
+//---------------------------------------------------------
+
+void EventMap::resetFixup()
+      {
+      _fixup = FixupState();
+      _fixupTick = INT_MIN;
+      }
+
+//---------------------------------------------------------
+//   EventMap::fixupFrom
+//    Events before tick must not have changed since the
+//    last call. The saved state is advanced up to tick and
+//    kept for the next call, then the rest is fixed up.
+//---------------------------------------------------------
+
+void EventMap::fixupFrom(int tick)
+      {
+      if (tick < _fixupTick)
+            resetFixup();
+      _fixup.channels.resize(_highestChannel + 1);
+
+      fixupRange(_fixupTick, tick, _fixup);
+      _fixupTick = tick;
+
+      FixupState state = _fixup;
+      fixupRange(tick, INT_MAX, state);
+      _fixupSize = size();
+      }
+
+//---------------------------------------------------------
+//   EventMap::fixupRange
+//    fix up the events from fromTick up to, but not
+//    including toTick (INT_MAX: to the end), dropping
+//    duplicate controller events in place
+//---------------------------------------------------------
+
+void EventMap::fixupRange(int fromTick, int toTick, FixupState& state)
+      {
+      const_iterator start = bound(fromTick, false);
+      if (!start._block)
+            return;
+      size_t b = start._block->index;
+      size_t r = start._idx;
+      while (b < _blocks.size()) {
+            Block* block = _blocks[b].get();
+            size_t w = r;
+            for (; r < block->end && ((*block)[r].first < toTick || toTick == INT_MAX); ++r) {
+                  if (!fixupEvent((*block)[r].second, state))
+                        continue;
+                  if (w != r)
+                        (*block)[w] = (*block)[r];
+                  ++w;
+                  }
+            const bool done = r < block->end;
+            removeEvents(block, w, r);
+            if (block->end == block->begin)
+                  eraseBlocks(b, 1);
+            else
+                  ++b;
+            if (done || b == _blocks.size())
+                  break;
+            r = _blocks[b]->begin;
+            }
+      }
+
+//---------------------------------------------------------
+//   EventMap::fixupEvent
+//    returns false if the event is to be dropped
+//---------------------------------------------------------
+
+bool EventMap::fixupEvent(NPlayEvent& event, FixupState& state)
+      {
+      /* ME_NOTEOFF is never emitted, no need to check for it */
+      if (event.type() == ME_NOTEON && !event.isMuted()) {
+            ChannelInfo& info = state.channels[event.channel()];
+            unsigned short np = info.nowPlaying[event.pitch()];
+            if (event.velo() == 0) {
+                  /* already off (should not happen) or still playing? */
+                  if (np == 0 || --np > 0)
+                        event.setDiscard(1);
                   else {
-                        if (++np > 1)
-                              /* restrike, possibly on different track */
-                              event.setDiscard(info[event.channel()].event[event.pitch()]->getOriginatingStaff() + 1);
-                        info[event.channel()].event[event.pitch()] = &event;
+                        /* hoist NOTEOFF to same track as NOTEON */
+                        event.setOriginatingStaff(info.staff[event.pitch()]);
                         }
-                  info[event.channel()].nowPlaying[event.pitch()] = np;
                   }
-
-            ++it;
+            else {
+                  if (++np > 1)
+                        /* restrike, possibly on different track */
+                        event.setDiscard(info.staff[event.pitch()] + 1);
+                  info.staff[event.pitch()] = event.getOriginatingStaff();
+                  }
+            info.nowPlaying[event.pitch()] = np;
+            }
+      else if (event.type() == ME_CONTROLLER) {
+            // NOTE:JT this is a temporary fix for duplicate events until polyphonic aftertouch support
+            // can be implemented. This removes duplicate SND events.
+            if (event.channel() == state.lastChannel &&
+                event.controller() == state.lastController &&
+                event.value() == state.lastValue)
+                  return false;
+            state.lastChannel = event.channel();
+            state.lastController = event.controller();
+            state.lastValue = event.value();
             }
+      return true;
+      }
 
-            free((void *)info);
+//---------------------------------------------------------
+//   EventBuffer::sortByTick
+//---------------------------------------------------------
+
+void EventBuffer::sortByTick()
+      {
+      std::stable_sort(begin(), end(), [](const std::pair<int, NPlayEvent>& a, const std::pair<int, NPlayEvent>& b) {
+            return a.first < b.first;
+            });
       }
 
 }
@@ -13,7 +13,11 @@
 #ifndef __EVENT_H__
 #define __EVENT_H__
 
+#include <iterator>
 #include <map>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 namespace Ms {
 
@@ -322,11 +326,217 @@ class EventList : public QList<Event> {
       void insertNote(int channel, Note*);
       };
 
-class EventMap : public std::multimap<int, NPlayEvent> {
+//---------------------------------------------------------
+//   EventMap
+//    Events sorted by tick, like a multimap, but stored in
+//    blocks of contiguous memory. Events with equal ticks
+//    keep their insertion order.
+//    An iterator is a block and an index into the block's
+//    storage. Inserting never moves or frees existing events,
+//    so it invalidates no iterators: new events landing
+//    inside a block get a block of their own, and the block
+//    is split in two pieces sharing its storage. An iterator
+//    into the first piece that points past its end follows
+//    the split to the second piece.
+//    Erasing events, which includes duplicate controllers
+//    dropped by insertChunk(), invalidates iterators to the
+//    erased and the later events of the same block.
+//---------------------------------------------------------
+
+class EventMap {
+   public:
+      typedef std::pair<int, NPlayEvent> value_type;
+
+   private:
+      struct Block {
+            std::shared_ptr<std::vector<value_type>> events;      // shared by the pieces of a split block
+            size_t begin;                       // this block's events in *events,
+            size_t end;                         // never empty
+            size_t index;                       // position in _blocks
+            Block* split     { nullptr };       // piece holding the events from end on
+            Block* splitFrom { nullptr };       // piece this one was split from
+
+            Block(std::vector<value_type>&& ev)
+               : events(std::make_shared<std::vector<value_type>>(std::move(ev))), begin(0), end(events->size()) {}
+            Block(const std::shared_ptr<std::vector<value_type>>& ev, size_t b, size_t e)
+               : events(ev), begin(b), end(e) {}
+            Block(const Block&) = delete;
+            Block& operator=(const Block&) = delete;
+            ~Block() {
+                  if (splitFrom)
+                        splitFrom->split = split;
+                  if (split)
+                        split->splitFrom = splitFrom;
+                  }
+            value_type& operator[](size_t i) const { return (*events)[i]; }
+            const value_type& back() const         { return (*events)[end - 1]; }
+            size_t size() const                    { return end - begin; }
+            };
+
+      /* per channel: staff of the ME_NOTEON that started each pitch
+       * and how often the pitch is on right now */
+      struct ChannelInfo {
+            int staff[128];
+            unsigned short nowPlaying[128];
+            };
+      /* running state of the fixup pass, see fixupRange() */
+      struct FixupState {
+            std::vector<ChannelInfo> channels;
+            int lastChannel    { -1 };
+            int lastController { -1 };
+            int lastValue      { -1 };
+            };
+
+      template <bool Const>
+      class Iterator {
+            friend class EventMap;
+            template <bool> friend class Iterator;
+            typedef typename std::conditional<Const, const EventMap, EventMap>::type Map;
+
+            Map* _map     { nullptr };
+            Block* _block { nullptr };          // nullptr for end()
+            size_t _idx   { 0 };                // index into _block->events
+
+            Iterator(Map* map, Block* block, size_t idx) : _map(map), _block(block), _idx(idx) {}
+
+            // move to the piece now holding the event, if the block was split
+            void normalize() {
+                  while (_block && _idx >= _block->end && _block->split)
+                        _block = _block->split;
+                  }
+
+         public:
+            typedef std::bidirectional_iterator_tag iterator_category;
+            typedef EventMap::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef typename std::conditional<Const, const value_type*, value_type*>::type pointer;
+            typedef typename std::conditional<Const, const value_type&, value_type&>::type reference;
+
+            Iterator() {}
+            Iterator(const Iterator<false>& i) : _map(i._map), _block(i._block), _idx(i._idx) {}
+
+            reference operator*() const { return (*_block)[_idx]; }
+            pointer operator->() const  { return &(*_block)[_idx]; }
+
+            Iterator& operator++() {
+                  normalize();
+                  if (++_idx == _block->end) {
+                        const size_t next = _block->index + 1;
+                        _block = next < _map->_blocks.size() ? _map->_blocks[next].get() : nullptr;
+                        _idx   = _block ? _block->begin : 0;
+                        }
+                  return *this;
+                  }
+            Iterator& operator--() {
+                  normalize();
+                  if (_block && _idx > _block->begin)
+                        --_idx;
+                  else {
+                        _block = _block ? _map->_blocks[_block->index - 1].get() : _map->_blocks.back().get();
+                        _idx   = _block->end - 1;
+                        }
+                  return *this;
+                  }
+            Iterator operator++(int) { Iterator i(*this); ++*this; return i; }
+            Iterator operator--(int) { Iterator i(*this); --*this; return i; }
+
+            // the pieces of a split block share their storage
+            template <bool C> bool operator==(const Iterator<C>& i) const {
+                  if (!_block || !i._block)
+                        return _block == i._block;
+                  return _block->events == i._block->events && _idx == i._idx;
+                  }
+            template <bool C> bool operator!=(const Iterator<C>& i) const { return !(*this == i); }
+            };
+
+   public:
+      typedef Iterator<false> iterator;
+      typedef Iterator<true> const_iterator;
+
+   private:
+      std::vector<std::unique_ptr<Block>> _blocks;
+      size_t _size = 0;
       int _highestChannel = 15;
+
+      /* fixup state before the first event at _fixupTick; valid as
+       * long as the map still holds _fixupSize events */
+      FixupState _fixup;
+      int _fixupTick     { INT_MIN };
+      size_t _fixupSize  { 0 };
+
+      size_t blockAfter(int tick, bool equal) const;
+      const_iterator bound(int tick, bool equal) const;
+      iterator mutableIterator(const_iterator i) { i.normalize(); return iterator(this, i._block, i._idx); }
+      void appendBlock(std::vector<value_type>&& events);
+      void eraseBlocks(size_t pos, size_t n);
+      void removeEvents(Block* b, size_t from, size_t to);
+      void insertSorted(std::vector<value_type>&& events);
+
+      void resetFixup();
+      void fixupFrom(int tick);
+      void fixupRange(int fromTick, int toTick, FixupState& state);
+      static bool fixupEvent(NPlayEvent& event, FixupState& state);
+
    public:
+      EventMap() {}
+      EventMap(const EventMap&);
+      EventMap& operator=(const EventMap&);
+
+      iterator begin()              { return _blocks.empty() ? end() : iterator(this, _blocks.front().get(), _blocks.front()->begin); }
+      const_iterator begin() const  { return cbegin(); }
+      const_iterator cbegin() const { return _blocks.empty() ? cend() : const_iterator(this, _blocks.front().get(), _blocks.front()->begin); }
+      iterator end()                { return iterator(this, nullptr, 0); }
+      const_iterator end() const    { return cend(); }
+      const_iterator cend() const   { return const_iterator(this, nullptr, 0); }
+
+      bool empty() const            { return _size == 0; }
+      size_t size() const           { return _size; }
+      size_t memoryUsage() const;
+      void clear();
+
+      iterator lower_bound(int tick)             { return mutableIterator(bound(tick, false)); }
+      const_iterator lower_bound(int tick) const { return bound(tick, false); }
+      iterator upper_bound(int tick)             { return mutableIterator(bound(tick, true)); }
+      const_iterator upper_bound(int tick) const { return bound(tick, true); }
+
+      void insert(const value_type& event);
+      void insert(const_iterator, const value_type& event) { insert(event); }
+      template <class InputIterator>
+      void insert(InputIterator first, InputIterator last);     // range must be sorted by tick
+      iterator erase(const_iterator i);
+      iterator erase(const_iterator first, const_iterator last);
+
       void fixupMIDI();
+      void insertChunk(const EventMap& chunk);
+      void registerChannel(int c) { if (c > _highestChannel) _highestChannel = c; }
+      };
+
+//---------------------------------------------------------
+//   EventMap::insert
+//---------------------------------------------------------
+
+template <class InputIterator>
+void EventMap::insert(InputIterator first, InputIterator last)
+      {
+      std::vector<value_type> events(first, last);
+      if (!events.empty())
+            insertSorted(std::move(events));
+      }
+
+//---------------------------------------------------------
+//   EventBuffer
+//    flat event list, filled in any order and then sorted
+//    by tick; events with equal ticks keep their insertion
+//    order, as they would in an EventMap
+//---------------------------------------------------------
+
+class EventBuffer : public std::vector<std::pair<int, NPlayEvent>> {
+      int _highestChannel = 15;
+   public:
+      void insert(const std::pair<int, NPlayEvent>& e) { push_back(e); }
       void registerChannel(int c) { if (c > _highestChannel) _highestChannel = c; }
+      int highestChannel() const  { return _highestChannel; }
+      void sortByTick();
       };
 
 typedef EventList::iterator iEvent;
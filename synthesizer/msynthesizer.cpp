@@ -72,6 +72,44 @@ MasterSynthesizer::~MasterSynthesizer()
                   delete e;
             // delete _effect[i];   // _effect takes from _effectList
             }
+      delete _graph.load();
+      qDeleteAll(_retired);
+      }
+
+//---------------------------------------------------------
+//   publishGraph
+//    make the current synthesizers and effects visible
+//    to the audio thread; GUI thread only
+//---------------------------------------------------------
+
+void MasterSynthesizer::publishGraph()
+      {
+      Graph* g = new Graph;
+      g->synthesizer = _synthesizer;
+      for (int i = 0; i < MAX_EFFECTS; ++i)
+            g->effect[i] = _effect[i];
+      Graph* old = _graph.exchange(g);
+      if (old)
+            _retired.push_back(old);
+      reclaimGraphs();
+      }
+
+//---------------------------------------------------------
+//   reclaimGraphs
+//    delete replaced graphs the audio thread does not use;
+//    it can only pick up the current graph from now on
+//---------------------------------------------------------
+
+void MasterSynthesizer::reclaimGraphs()
+      {
+      Graph* inUse = _audioGraph.load();
+      auto i = std::remove_if(_retired.begin(), _retired.end(), [inUse](Graph* g) {
+            if (g == inUse)
+                  return false;
+            delete g;
+            return true;
+            });
+      _retired.erase(i, _retired.end());
       }
 
 //---------------------------------------------------------
@@ -172,6 +210,29 @@ void MasterSynthesizer::allNotesOff(int channel)
             s->allNotesOff(channel);
       }
 
+//---------------------------------------------------------
+//   prefetch
+//    load the samples of a patch before it is played
+//---------------------------------------------------------
+
+void MasterSynthesizer::prefetch(const QString& synti, int bank, int program)
+      {
+      Synthesizer* s = synthesizer(synti);
+      if (s)
+            s->prefetch(bank, program);
+      }
+
+//---------------------------------------------------------
+//   setOfflineRendering
+//    set for synthesizers which render an export
+//---------------------------------------------------------
+
+void MasterSynthesizer::setOfflineRendering(bool val)
+      {
+      for (Synthesizer* s : _synthesizer)
+            s->setOfflineRendering(val);
+      }
+
 //---------------------------------------------------------
 //   synth
 //---------------------------------------------------------
@@ -193,6 +254,8 @@ Synthesizer* MasterSynthesizer::synthesizer(const QString& name)
 void MasterSynthesizer::registerSynthesizer(Synthesizer* s)
       {
       _synthesizer.push_back(s);
+      if (_graph.load())
+            publishGraph();
       }
 
 //---------------------------------------------------------
@@ -214,15 +277,9 @@ void MasterSynthesizer::setEffect(int ab, int idx)
             qDebug("MasterSynthesizer::setEffect: bad idx %d %d", ab, idx);
             return;
             }
-      lock2 = true;
-      while(lock1)
-#if (!defined (_MSCVER) && !defined (_MSC_VER))
-         sleep(1);
-#else
-         Sleep(1000);      // MS-equivalent function, time in ms instead of seconds.
-#endif
       _effect[ab] = _effectList[ab][idx];
-      lock2 = false;
+      if (_graph.load())
+            publishGraph();
       }
 
 //---------------------------------------------------------
@@ -249,47 +306,87 @@ void MasterSynthesizer::setSampleRate(float val)
             e->init(_sampleRate);
       for (Effect* e : _effectList[1])
             e->init(_sampleRate);
-      lock2 = false;
-      lock1 = false;
+      publishGraph();
       }
 
 //---------------------------------------------------------
 //   process
+//    audio thread; never blocks on the GUI thread
 //---------------------------------------------------------
 
 void MasterSynthesizer::process(unsigned n, float* p)
       {
-      if (lock2)
-            return;
-      lock1 = true;
-      if (lock2) {
-            lock1 = false;
-            return;
-            }
       // avoid overflow
-      if (n > MAX_BUFFERSIZE / 2)
+      if (n > MAX_BUFFERSIZE / 2) {
+            ++_dropouts;
             return;
-      for (Synthesizer* s : _synthesizer) {
+            }
+      // announce the graph before using it, then make sure it
+      // was not replaced (and possibly reclaimed) meanwhile
+      Graph* g = _graph.load();
+      for (;;) {
+            _audioGraph.store(g);
+            Graph* cg = _graph.load();
+            if (cg == g)
+                  break;
+            g = cg;
+            }
+      if (g) {
+            processSynthesizers(g->synthesizer, n, p);
+            processEffects(g->effect, n, p, effect1Buffer);
+            }
+      else
+            ++_dropouts;
+      _audioGraph.store(nullptr);
+      }
+
+//---------------------------------------------------------
+//   processSynthesizers
+//    mix the dry output of all active synthesizers into p
+//---------------------------------------------------------
+
+void MasterSynthesizer::processSynthesizers(unsigned n, float* p)
+      {
+      processSynthesizers(_synthesizer, n, p);
+      }
+
+void MasterSynthesizer::processSynthesizers(const std::vector<Synthesizer*>& synthesizer, unsigned n, float* p)
+      {
+      for (Synthesizer* s : synthesizer) {
             if (s->active())
                   s->process(n, p, effect1Buffer, effect2Buffer);
             }
+      }
+
+//---------------------------------------------------------
+//   processEffects
+//    apply master effects and gain to p; buffer holds 2 * n
+//    floats of scratch space, so that the effects can run
+//    while processSynthesizers() runs on another thread
+//---------------------------------------------------------
+
+void MasterSynthesizer::processEffects(unsigned n, float* p, float* buffer)
+      {
+      processEffects(_effect, n, p, buffer);
+      }
 
-      if (_effect[0] && _effect[1]) {
-            memset(effect1Buffer, 0, n * sizeof(float) * 2);
-            _effect[0]->process(n, p, effect1Buffer);
-            _effect[1]->process(n, effect1Buffer, p);
+void MasterSynthesizer::processEffects(Effect* const effect[MAX_EFFECTS], unsigned n, float* p, float* buffer)
+      {
+      if (effect[0] && effect[1]) {
+            memset(buffer, 0, n * sizeof(float) * 2);
+            effect[0]->process(n, p, buffer);
+            effect[1]->process(n, buffer, p);
             }
-      else if (_effect[0] || _effect[1]) {
-            memcpy(effect1Buffer, p, n * sizeof(float) * 2);
-            if (_effect[0])
-                  _effect[0]->process(n, effect1Buffer, p);
+      else if (effect[0] || effect[1]) {
+            memcpy(buffer, p, n * sizeof(float) * 2);
+            if (effect[0])
+                  effect[0]->process(n, buffer, p);
             else
-                  _effect[1]->process(n, effect1Buffer, p);
+                  effect[1]->process(n, buffer, p);
             }
       float g = _gain * _boost;
       for (unsigned i = 0; i < n * 2; ++i)
             *p++ *= g;
-      lock1 = false;
       }
 
 //---------------------------------------------------------
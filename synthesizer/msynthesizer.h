@@ -50,8 +50,26 @@ class MasterSynthesizer : public QObject {
       static constexpr float defaultGain = 0.1f;  // -20dB
 
    private:
-      std::atomic<bool> lock1      { false };
-      std::atomic<bool> lock2      { true  };
+      //---------------------------------------------------
+      //   Graph
+      //    synthesizers and effects used by process();
+      //    never modified once published
+      //---------------------------------------------------
+
+      struct Graph {
+            std::vector<Synthesizer*> synthesizer;
+            Effect* effect[MAX_EFFECTS];
+            };
+
+      // The GUI thread builds a new Graph and swaps it into _graph.
+      // The audio thread announces the graph it renders with in
+      // _audioGraph; replaced graphs are kept in _retired and
+      // deleted by the GUI thread once the audio thread left them.
+      std::atomic<Graph*> _graph      { nullptr };
+      std::atomic<Graph*> _audioGraph { nullptr };
+      std::vector<Graph*> _retired;
+      std::atomic<int> _dropouts      { 0 };
+
       std::vector<Synthesizer*> _synthesizer;
       std::vector<Effect*> _effectList[MAX_EFFECTS];
       Effect* _effect[MAX_EFFECTS]  { nullptr, nullptr };
@@ -63,6 +81,11 @@ class MasterSynthesizer : public QObject {
       int indexOfEffect(int ab, const QString& name);
       float convertGainToDecibels(float gain) const;
 
+      void publishGraph();
+      void reclaimGraphs();
+      void processSynthesizers(const std::vector<Synthesizer*>&, unsigned, float*);
+      void processEffects(Effect* const effect[MAX_EFFECTS], unsigned, float*, float*);
+
    public slots:
       void sfChanged() { emit soundFontChanged(); }
       void setGain(float f);
@@ -82,7 +105,10 @@ class MasterSynthesizer : public QObject {
       void setSampleRate(float val);
 
       void process(unsigned, float*);
+      void processSynthesizers(unsigned, float*);
+      void processEffects(unsigned, float*, float*);
       void play(const NPlayEvent&, unsigned);
+      int dropouts() const          { return _dropouts; }
 
       void setMasterTuning(double val);
       double masterTuning() const      { return _masterTuning; }
@@ -104,6 +130,8 @@ class MasterSynthesizer : public QObject {
       void reset();
       void allSoundsOff(int channel);
       void allNotesOff(int channel);
+      void prefetch(const QString& synti, int bank, int program);
+      void setOfflineRendering(bool val);
 
       void setEffect(int ab, int idx);
       Effect* effect(int ab);
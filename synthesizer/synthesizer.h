@@ -80,6 +80,13 @@ class Synthesizer {
       virtual void allSoundsOff(int /*channel*/) {}
       virtual void allNotesOff(int /*channel*/) {}
 
+      // start loading the samples of a patch in the background
+      virtual void prefetch(int /*bank*/, int /*program*/) {}
+
+      // rendering faster than real time, e.g. for export;
+      // background work must be done inside process()
+      virtual void setOfflineRendering(bool) {}
+
       virtual SynthesizerGui* gui()  { return _gui; }
       };
 
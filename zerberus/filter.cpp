@@ -17,8 +17,12 @@
 #include <math.h>
 #include <functional>
 
+#ifdef ZERBERUS_SSE2
+#include <emmintrin.h>
+#endif
+
 static constexpr int INTERP_MAX = 256;
-static float interpCoeff[INTERP_MAX][4];
+alignas(16) static float interpCoeff[INTERP_MAX][4];
 
 //---------------------------------------------------------
 //   FilterBQ
@@ -286,3 +290,135 @@ float ZFilter::interpolate(unsigned phase, short prevVal, short currVal, short n
           + interpValTable[2] * nextVal
           + interpValTable[3] * nextNextVal);
       }
+
+//---------------------------------------------------------
+//   interpolate
+//    data points to the four samples around phase
+//---------------------------------------------------------
+
+float ZFilter::interpolate(unsigned phase, const short* data) const
+      {
+#ifdef ZERBERUS_SSE2
+      const __m128i s = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+      const __m128 x  = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+      __m128 y        = _mm_mul_ps(x, _mm_load_ps(interpCoeff[phase]));
+      y = _mm_add_ps(y, _mm_movehl_ps(y, y));
+      y = _mm_add_ss(y, _mm_shuffle_ps(y, y, 1));
+      return _mm_cvtss_f32(y);
+#else
+      return interpolate(phase, data[0], data[1], data[2], data[3]);
+#endif
+      }
+
+//---------------------------------------------------------
+//   interpolateStereo
+//    data points to the four interleaved frames around
+//    phase; out gets left and right
+//---------------------------------------------------------
+
+void ZFilter::interpolateStereo(unsigned phase, const short* data, float* out) const
+      {
+#ifdef ZERBERUS_SSE2
+      const __m128i s  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+      const __m128 lo  = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));     // L0 R0 L1 R1
+      const __m128 hi  = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));     // L2 R2 L3 R3
+      const __m128 c   = _mm_load_ps(interpCoeff[phase]);
+      __m128 y = _mm_add_ps(_mm_mul_ps(lo, _mm_unpacklo_ps(c, c)), _mm_mul_ps(hi, _mm_unpackhi_ps(c, c)));
+      y = _mm_add_ps(y, _mm_movehl_ps(y, y));
+      _mm_storel_pi(reinterpret_cast<__m64*>(out), y);
+#else
+      out[0] = interpolate(phase, data[0], data[2], data[4], data[6]);
+      out[1] = interpolate(phase, data[1], data[3], data[5], data[7]);
+#endif
+      }
+
+//---------------------------------------------------------
+//   applyBlock
+//    apply() to frames interleaved frames of channels
+//    channels, with the filter type resolved once
+//---------------------------------------------------------
+
+void ZFilter::applyBlock(float* buffer, int frames, int channels)
+      {
+      if (filter_coeff_incr_count) {
+            // coefficients still move towards a new frequency
+            for (int i = 0; i < frames * channels; ++i)
+                  buffer[i] = apply(buffer[i], channels == 1 || (i & 1) == 0);
+            return;
+            }
+      switch (sampleZone->fil_type) {
+            case FilterType::hpf_2p:
+            case FilterType::lpf_2p:
+            case FilterType::bpf_2p:
+            case FilterType::brf_2p:
+                  applyBiquad(buffer, frames, channels, monoL);
+                  if (channels == 2)
+                        applyBiquad(buffer + 1, frames, channels, monoR);
+                  break;
+            case FilterType::hpf_1p:
+                  applyHPF1P(buffer, frames, channels, monoL);
+                  if (channels == 2)
+                        applyHPF1P(buffer + 1, frames, channels, monoR);
+                  break;
+            case FilterType::lpf_1p:
+                  applyLPF1P(buffer, frames, channels, monoL);
+                  if (channels == 2)
+                        applyLPF1P(buffer + 1, frames, channels, monoR);
+                  break;
+            default:
+                  qWarning() << "this equation is not implemented" << (int)sampleZone->fil_type;
+                  std::fill(buffer, buffer + frames * channels, 0.f);
+            }
+      }
+
+//---------------------------------------------------------
+//   applyBiquad
+//    the equations of apply() with the coefficients and
+//    history kept in registers
+//---------------------------------------------------------
+
+void ZFilter::applyBiquad(float* buffer, int frames, int stride, FilterData& d) const
+      {
+      const float c0 = b0, c1 = b1, c2 = b2, d1 = a1, d2 = a2;
+      float x1 = d.histX1, x2 = d.histX2, y1 = d.histY1, y2 = d.histY2;
+      for (int i = 0; i < frames; ++i, buffer += stride) {
+            const float x = *buffer;
+            const float y = c0 * x + c1 * x1 + c2 * x2 + d1 * y1 + d2 * y2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            *buffer = y;
+            }
+      d.histX1 = x1;
+      d.histX2 = x2;
+      d.histY1 = y1;
+      d.histY2 = y2;
+      }
+
+void ZFilter::applyHPF1P(float* buffer, int frames, int stride, FilterData& d) const
+      {
+      const float c0 = b0, c1 = b1, d1 = a1;
+      float x1 = d.histX1, y1 = d.histY1;
+      for (int i = 0; i < frames; ++i, buffer += stride) {
+            const float x = *buffer;
+            const float y = c0 * x + c1 * x1 - d1 * y1;
+            x1 = x;
+            y1 = y;
+            *buffer = y;
+            }
+      d.histX1 = x1;
+      d.histY1 = y1;
+      }
+
+void ZFilter::applyLPF1P(float* buffer, int frames, int stride, FilterData& d) const
+      {
+      const float c0 = b0, d1 = a1;
+      float y1 = d.histY1;
+      for (int i = 0; i < frames; ++i, buffer += stride) {
+            const float y = c0 * *buffer - d1 * y1;
+            y1 = y;
+            *buffer = y;
+            }
+      d.histY1 = y1;
+      }
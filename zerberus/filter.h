@@ -16,6 +16,10 @@
 struct Zone;
 class Zerberus;
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZERBERUS_SSE2
+#endif
+
 //---------------------------------------------------------
 //   Envelope
 //---------------------------------------------------------
@@ -29,7 +33,10 @@ public:
 
       void update();
       float apply(float inputValue, bool leftChannel);
+      void applyBlock(float* buffer, int frames, int channels);
       float interpolate(unsigned phase, short prevVal, short currVal, short nextVal, short nextNextVal) const; //pure function
+      float interpolate(unsigned phase, const short* data) const;
+      void interpolateStereo(unsigned phase, const short* data, float* out) const;
 
 private:
       const Zerberus* zerberus;
@@ -56,6 +63,10 @@ private:
       FilterData monoL;
       FilterData monoR;
 
+      void applyBiquad(float* buffer, int frames, int stride, FilterData& d) const;
+      void applyHPF1P(float* buffer, int frames, int stride, FilterData& d) const;
+      void applyLPF1P(float* buffer, int frames, int stride, FilterData& d) const;
+
       // normalized filter coefficients (bX = bX/a0 and aX = aX/a0)
       // see Robert Bristow-Johnson's 'Cookbook formulae for audio EQ biquad filter coefficients'
       float b0 = 0.f;              // b0 / a0
@@ -21,6 +21,7 @@
 #include "thirdparty/qzip/qzipreader_p.h"
 
 #include "instrument.h"
+#include "zerberus.h"
 #include "zone.h"
 #include "sample.h"
 
@@ -36,12 +37,141 @@ Sample::~Sample()
       delete[] _data;
       }
 
+//---------------------------------------------------------
+//   setStreamed
+//    only the first residentFrames frames are in data()
+//---------------------------------------------------------
+
+void Sample::setStreamed(const QString& path, long long residentFrames)
+      {
+      _path           = path;
+      _residentFrames = residentFrames;
+      }
+
+//---------------------------------------------------------
+//   keepResident
+//    load the frames from start to end of a streamed
+//    sample into memory
+//---------------------------------------------------------
+
+bool Sample::keepResident(long long start, long long end)
+      {
+      start = std::max(start, _residentFrames);
+      end   = std::min(end, _frames);
+      if (!streamed() || start >= end)
+            return true;
+      AudioFile a;
+      if (!a.open(_path) || a.seekFrame(start) != start) {
+            qDebug("Sample::keepResident: cannot read <%s>", qPrintable(_path));
+            return false;
+            }
+      Span span { start, end, std::vector<short>((end - start) * _channel) };
+      if (a.readData(span.data.data(), end - start) != end - start) {
+            qDebug("Sample::keepResident: read failed: %s", a.error());
+            return false;
+            }
+      auto i = std::upper_bound(_spans.begin(), _spans.end(), start, [](long long f, const Span& sp) { return f < sp.start; });
+      _spans.insert(i, std::move(span));
+      return true;
+      }
+
+//---------------------------------------------------------
+//   residentValue
+//    the value of channel in frame if it is in memory
+//---------------------------------------------------------
+
+bool Sample::residentValue(long long frame, int channel, short* val) const
+      {
+      if (frame < _residentFrames) {
+            *val = data()[frame * _channel + channel];
+            return true;
+            }
+      for (const Span& sp : _spans) {
+            if (frame < sp.start)
+                  break;
+            if (frame < sp.end) {
+                  *val = sp.data[(frame - sp.start) * _channel + channel];
+                  return true;
+                  }
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   nextStreamedFrame
+//    the first frame at or after frame which is not in
+//    memory, frames() if there is none
+//---------------------------------------------------------
+
+long long Sample::nextStreamedFrame(long long frame) const
+      {
+      frame = std::max(frame, _residentFrames);
+      for (const Span& sp : _spans) {
+            if (frame >= sp.start && frame < sp.end)
+                  frame = sp.end;
+            }
+      return std::min(frame, _frames);
+      }
+
+//---------------------------------------------------------
+//   memoryUsed
+//---------------------------------------------------------
+
+size_t Sample::memoryUsed() const
+      {
+      size_t n = (_residentFrames + (streamed() ? 1 : 3)) * _channel;
+      for (const Span& sp : _spans)
+            n += sp.data.size();
+      return n * sizeof(short);
+      }
+
+//---------------------------------------------------------
+//   readStreamedSample
+//    read the first preload ms of the sample file s;
+//    returns 0 if the sample should be loaded completely
+//---------------------------------------------------------
+
+Sample* ZInstrument::readStreamedSample(const QString& s, int preload)
+      {
+      AudioFile a;
+      // vorbis data is normalized per read, it cannot be read in parts
+      if (!a.open(s) || a.isVorbis() || a.channels() > 2)
+            return 0;
+
+      int channel = a.channels();
+      sf_count_t frames = a.frames();
+      sf_count_t head   = sf_count_t(preload) * a.samplerate() / 1000;
+      if (frames <= 2 * head)
+            return 0;
+
+      short* data = new short[(head + 1) * channel];
+      Sample* sa  = new Sample(channel, data, frames, a.samplerate());
+      sa->setLoopStart(a.loopStart());
+      sa->setLoopEnd(a.loopEnd());
+      sa->setLoopMode(a.loopMode());
+
+      if (head != a.readData(data + channel, head)) {
+            qDebug("Sample read failed: %s\n", a.error());
+            delete sa;
+            return 0;
+            }
+      for (int i = 0; i < channel; ++i)
+            data[i] = data[channel + i];
+      sa->setStreamed(s, head);
+      return sa;
+      }
+
 //---------------------------------------------------------
 //   readSample
 //---------------------------------------------------------
 
 Sample* ZInstrument::readSample(const QString& s, MQZipReader* uz)
       {
+      if (!uz && _streamPreload > 0) {
+            Sample* sa = readStreamedSample(s, _streamPreload);
+            if (sa)
+                  return sa;
+            }
       if (uz) {
             QVector<MQZipReader::FileInfo> fi = uz->fileInfoList();
 
@@ -79,12 +209,15 @@ Sample* ZInstrument::readSample(const QString& s, MQZipReader* uz)
       if (frames != a.readData(data + channel, frames)) {
             qDebug("Sample read failed: %s\n", a.error());
             delete sa;
-            sa = 0;
+            return 0;
             }
       for (int i = 0; i < channel; ++i) {
             data[i]                        = data[channel + i];
             data[(frames-1) * channel + i] = data[(frames-3) * channel + i];
             data[(frames-2) * channel + i] = data[(frames-3) * channel + i];
+            // read past the end by interpolation; silent, as in streamed samples
+            data[(frames+1) * channel + i] = 0;
+            data[(frames+2) * channel + i] = 0;
             }
       return sa;
       }
@@ -100,6 +233,7 @@ ZInstrument::ZInstrument(Zerberus* z)
             _setcc[i] = -1;
       _program  = -1;
       _refCount = 0;
+      _streamPreload = z->streamPreload();
       }
 
 //---------------------------------------------------------
@@ -112,6 +246,20 @@ ZInstrument::~ZInstrument()
             delete z;
       }
 
+//---------------------------------------------------------
+//   streamed
+//    true if samples are read from disk while playing
+//---------------------------------------------------------
+
+bool ZInstrument::streamed() const
+      {
+      for (const Zone* z : _zones) {
+            if (z->sample->streamed())
+                  return true;
+            }
+      return false;
+      }
+
 //---------------------------------------------------------
 //   load
 //    return true on success
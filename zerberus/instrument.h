@@ -30,6 +30,7 @@ class Sample;
 class ZInstrument {
       Zerberus* zerberus;
       int _refCount;
+      int _streamPreload;           // of the Zerberus which loaded the instrument
       QString _name;
       int _program;
       QString instrumentPath;
@@ -54,6 +55,9 @@ class ZInstrument {
       const std::list<Zone*>& zones() const { return _zones;  }
       std::list<Zone*>& zones()             { return _zones;  }
       Sample* readSample(const QString& s, MQZipReader* uz);
+      Sample* readStreamedSample(const QString& s, int preload);
+      bool streamed() const;
+      int streamPreload() const             { return _streamPreload; }
       void addZone(Zone* z)                 { _zones.push_back(z); }
       void addRegion(SfzRegion&);
       int getSetCC(int v)                   { return _setcc[v]; }
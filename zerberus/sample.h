@@ -13,11 +13,23 @@
 #ifndef __SAMPLE_H__
 #define __SAMPLE_H__
 
+#include <vector>
+#include <QString>
+
 //---------------------------------------------------------
 //   Sample
+//    A streamed sample keeps only its first frames and its
+//    loop in memory; the rest is read from the file by
+//    the SampleStreamer while it plays.
 //---------------------------------------------------------
 
 class Sample {
+      struct Span {
+            long long start;
+            long long end;
+            std::vector<short> data;
+            };
+
       int _channel;
       short* _data;
       long long _frames;
@@ -26,9 +38,13 @@ class Sample {
       long long _loopEnd;
       int _loopMode;
 
+      QString _path;                // set if streamed
+      long long _residentFrames;    // frames in _data
+      std::vector<Span> _spans;     // other resident frames, sorted
+
    public:
       Sample(int ch, short* val, int f, int sr)
-         : _channel(ch), _data(val), _frames(f), _sampleRate(sr) {}
+         : _channel(ch), _data(val), _frames(f), _sampleRate(sr), _residentFrames(f) {}
       ~Sample();
       bool read(const QString&);
       long long frames() const     { return _frames;          }
@@ -42,6 +58,15 @@ class Sample {
       long long loopStart()           { return _loopStart; }
       long long loopEnd()             { return _loopEnd; }
       int loopMode()            { return _loopMode; }
+
+      void setStreamed(const QString& path, long long residentFrames);
+      bool streamed() const               { return !_path.isEmpty(); }
+      const QString& path() const         { return _path; }
+      long long residentFrames() const    { return _residentFrames; }
+      bool keepResident(long long start, long long end);
+      bool residentValue(long long frame, int channel, short* val) const;
+      long long nextStreamedFrame(long long frame) const;
+      size_t memoryUsed() const;
       };
 
 #endif
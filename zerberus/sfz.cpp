@@ -310,6 +310,9 @@ void ZInstrument::addRegion(SfzRegion& r)
                   r.loopEnd = z->sample->loopEnd();
             }
       r.setZone(z);
+      // the streamer only reads ahead; keep loops in memory
+      if (z->sample && z->sample->streamed() && z->loopStart >= 0 && z->loopEnd > z->loopStart)
+            z->sample->keepResident(z->offset + z->loopStart - 2, z->offset + z->loopEnd + 3);
       if (z->sample)
             addZone(z);
       }
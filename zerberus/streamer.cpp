@@ -0,0 +1,198 @@
+//=============================================================================
+//  Zerberus
+//  Zample player
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <climits>
+
+#include "audiofile/audiofile.h"
+
+#include "streamer.h"
+#include "sample.h"
+
+//---------------------------------------------------------
+//   start
+//    called by the voice when it starts playing s at
+//    frame
+//---------------------------------------------------------
+
+void SampleStream::start(Sample* s, long long frame)
+      {
+      sample.store(s);
+      readPos.store(frame);
+      generation.store(generation.load() + 1);
+      }
+
+//---------------------------------------------------------
+//   stop
+//---------------------------------------------------------
+
+void SampleStream::stop()
+      {
+      sample.store(nullptr);
+      generation.store(generation.load() + 1);
+      }
+
+//---------------------------------------------------------
+//   value
+//    audio thread; silence if the streamer has not read
+//    the frame yet
+//---------------------------------------------------------
+
+short SampleStream::value(long long frame, int channel)
+      {
+      Sample* s = sample.load(std::memory_order_relaxed);
+      if (!s || frame >= s->frames())
+            return 0;
+      if (filledGeneration.load(std::memory_order_acquire) == generation.load(std::memory_order_relaxed)) {
+            long long end = writePos.load(std::memory_order_acquire);
+            if (frame < end && frame >= startPos.load(std::memory_order_relaxed) && frame >= end - FRAMES)
+                  return ring[(frame & (FRAMES - 1)) * s->channel() + channel];
+            }
+      underruns.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   SampleStreamer
+//---------------------------------------------------------
+
+SampleStreamer::SampleStreamer(int streams)
+   : _streams(streams)
+      {
+      _thread = std::thread([this]() {
+            while (!_quit) {
+                  service();
+                  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                  }
+            });
+      }
+
+SampleStreamer::~SampleStreamer()
+      {
+      _quit = true;
+      _thread.join();
+      for (SampleStream& s : _streams)
+            closeFile(s);
+      }
+
+//---------------------------------------------------------
+//   service
+//    fill the streams of all playing voices
+//---------------------------------------------------------
+
+void SampleStreamer::service()
+      {
+      QMutexLocker locker(&_mutex);
+      for (SampleStream& s : _streams)
+            fill(s);
+      }
+
+//---------------------------------------------------------
+//   release
+//    wait until the streamer no longer reads for stopped
+//    streams and close their files; the samples of the
+//    stopped voices may be deleted afterwards
+//---------------------------------------------------------
+
+void SampleStreamer::release()
+      {
+      QMutexLocker locker(&_mutex);
+      for (SampleStream& s : _streams) {
+            if (!s.sample.load(std::memory_order_acquire))
+                  closeFile(s);
+            }
+      }
+
+//---------------------------------------------------------
+//   underruns
+//    number of sample values voices read as silence; a
+//    frame counts once per channel and interpolation point
+//---------------------------------------------------------
+
+int SampleStreamer::underruns() const
+      {
+      int n = 0;
+      for (const SampleStream& s : _streams)
+            n += s.underruns.load(std::memory_order_relaxed);
+      return n;
+      }
+
+//---------------------------------------------------------
+//   closeFile
+//---------------------------------------------------------
+
+void SampleStreamer::closeFile(SampleStream& s)
+      {
+      delete s.file;
+      s.file       = nullptr;
+      s.fileSample = nullptr;
+      }
+
+//---------------------------------------------------------
+//   fill
+//    read ahead of the voice, restart at the next frame
+//    which is not in memory if the voice jumped
+//---------------------------------------------------------
+
+void SampleStreamer::fill(SampleStream& s)
+      {
+      unsigned gen  = s.generation.load(std::memory_order_acquire);
+      Sample* sample = s.sample.load(std::memory_order_acquire);
+      if (!sample) {
+            if (s.file)
+                  closeFile(s);
+            return;
+            }
+      long long read = s.readPos.load(std::memory_order_relaxed);
+      long long want = sample->nextStreamedFrame(read);
+      long long start = s.startPos.load(std::memory_order_relaxed);
+      long long write = s.writePos.load(std::memory_order_relaxed);
+
+      if (gen != s.filledGeneration.load(std::memory_order_relaxed) || want < start || want > write) {
+            // invalidate before the ring is reused
+            s.writePos.store(LLONG_MIN);
+            if (s.ring.empty())
+                  s.ring.resize(SampleStream::FRAMES * 2);
+            s.startPos.store(want);
+            s.filledGeneration.store(gen);
+            s.writePos.store(want, std::memory_order_release);
+            start = write = want;
+            }
+      if (s.fileSample != sample) {
+            closeFile(s);
+            s.fileSample = sample;
+            s.file = new AudioFile;
+            if (!s.file->open(sample->path())) {
+                  qDebug("SampleStreamer: cannot open <%s>", qPrintable(sample->path()));
+                  delete s.file;
+                  s.file = nullptr;
+                  }
+            }
+      if (!s.file)
+            return;
+
+      const int channels = sample->channel();
+      long long end = std::min(sample->frames(), std::max(read, start) + SampleStream::FRAMES - SampleStream::GUARD);
+      if (write >= end)
+            return;
+      if (s.file->seekFrame(write) != write)
+            return;
+      while (write < end) {
+            long long pos = write & (SampleStream::FRAMES - 1);
+            long long n   = std::min(end - write, SampleStream::FRAMES - pos);
+            sf_count_t r  = s.file->readData(s.ring.data() + pos * channels, n);
+            if (r <= 0)
+                  break;
+            write += r;
+            s.writePos.store(write, std::memory_order_release);
+            }
+      }
+
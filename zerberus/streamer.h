@@ -0,0 +1,82 @@
+//=============================================================================
+//  Zerberus
+//  Zample player
+//
+//  Copyright (C) 2020 MuseScore BVBA
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __STREAMER_H__
+#define __STREAMER_H__
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <QMutex>
+
+class Sample;
+class AudioFile;
+
+//---------------------------------------------------------
+//   SampleStream
+//    Ring buffer with the frames of a streamed sample a
+//    voice plays. The voice (audio thread) sets sample
+//    and readPos, the streamer fills the frames from
+//    startPos to writePos.
+//---------------------------------------------------------
+
+struct SampleStream {
+      static const int FRAMES = 8192;     // power of 2
+      static const int GUARD  = 8;        // frames behind readPos kept for interpolation
+
+      std::vector<short> ring;            // FRAMES frames of up to two channels, allocated on first use
+
+      // written by the audio thread
+      std::atomic<Sample*> sample           { nullptr };
+      std::atomic<long long> readPos        { 0 };
+      std::atomic<unsigned> generation      { 0 };
+      std::atomic<int> underruns            { 0 };
+
+      // written by the streamer
+      std::atomic<unsigned> filledGeneration { 0 };
+      std::atomic<long long> startPos       { 0 };
+      std::atomic<long long> writePos       { 0 };
+      AudioFile* file                       { nullptr };
+      Sample* fileSample                    { nullptr };
+
+      void start(Sample*, long long frame);
+      void stop();
+      short value(long long frame, int channel);
+      };
+
+//---------------------------------------------------------
+//   SampleStreamer
+//    non realtime thread which reads streamed samples
+//    ahead of the voices playing them
+//---------------------------------------------------------
+
+class SampleStreamer {
+      std::vector<SampleStream> _streams;
+      QMutex _mutex;
+      std::thread _thread;
+      std::atomic<bool> _quit { false };
+
+      void fill(SampleStream&);
+      void closeFile(SampleStream&);
+
+   public:
+      SampleStreamer(int streams);
+      ~SampleStreamer();
+
+      SampleStream* stream(int idx)     { return &_streams[idx]; }
+      void service();
+      void release();
+      int underruns() const;
+      };
+
+#endif
+
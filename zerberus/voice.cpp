@@ -18,8 +18,13 @@
 #include "zerberus.h"
 #include "zone.h"
 #include "sample.h"
+#include "streamer.h"
 #include "synthesizer/msynthesizer.h"
 
+#ifdef ZERBERUS_SSE2
+#include <emmintrin.h>
+#endif
+
 float Envelope::egPow[EG_SIZE];
 float Envelope::egLin[EG_SIZE];
 
@@ -44,9 +49,24 @@ void Envelope::setTime(float ms, int sampleRate)
 //   Voice
 //---------------------------------------------------------
 
-Voice::Voice(Zerberus* z)
+Voice::Voice(Zerberus* z, int index)
       {
       _zerberus = z;
+      _index    = index;
+      _stream   = nullptr;
+      }
+
+//---------------------------------------------------------
+//   off
+//---------------------------------------------------------
+
+void Voice::off()
+      {
+      _state = VoiceState::OFF;
+      if (_stream) {
+            _stream->stop();
+            _stream = nullptr;
+            }
       }
 
 //---------------------------------------------------------
@@ -105,6 +125,17 @@ void Voice::start(Channel* c, int key, int v, const Zone* zone, double durSinceN
       _loopEnd   = z->loopEnd;
       _samplesSinceStart = 0;
 
+      if (_stream)
+            _stream->stop();
+      _stream     = nullptr;
+      residentEnd = std::numeric_limits<long long>::max();
+      if (s->streamed()) {
+            residentEnd = (s->residentFrames() - z->offset) * audioChan;
+            _stream     = _zerberus->stream(_index);
+            if (_stream)
+                  _stream->start(s, z->offset);
+            }
+
       _offMode  = z->offMode;
       _offBy    = z->offBy;
 
@@ -213,16 +244,186 @@ void Voice::updateEnvelopes() {
 
 //---------------------------------------------------------
 //   process
+//    Render frames in blocks; the frames at an envelope
+//    stage change, a loop wrap or the end of the sample
+//    are rendered one by one.
 //---------------------------------------------------------
 
 void Voice::process(int frames, float* p)
       {
       filter.update();
+      updateStream();
 
       const float opcodePanLeftGain = 1.f - std::fmax(0.0f, z->pan / 100.0); //[0, 1]
       const float opcodePanRightGain = 1.f + std::fmin(0.0f, z->pan / 100.0); //[0, 1]
       const float leftChannelVol = gain * z->ccGain * _channel->panLeftGain() * opcodePanLeftGain;
       const float rightChannelVol = gain * z->ccGain * _channel->panRightGain() * opcodePanRightGain;
+
+      if (!_zerberus->blockRendering()) {
+            processFrames(frames, p, leftChannelVol, rightChannelVol);
+            return;
+            }
+      while (frames > 0 && _state != VoiceState::OFF) {
+            bool direct;
+            int n = blockFrames(std::min(frames, int(BLOCK)), &direct);
+            if (n)
+                  processBlock(n, direct, p, leftChannelVol, rightChannelVol);
+            else {
+                  n = 1;
+                  processFrames(1, p, leftChannelVol, rightChannelVol);
+                  }
+            frames -= n;
+            p      += 2 * n;
+            }
+      }
+
+//---------------------------------------------------------
+//   updateStream
+//    tell the streamer where the voice reads
+//---------------------------------------------------------
+
+void Voice::updateStream()
+      {
+      if (_stream)
+            _stream->readPos.store(z->offset + phase.index(), std::memory_order_relaxed);
+      }
+
+//---------------------------------------------------------
+//   blockFrames
+//    Number of the next frames, at most maxFrames, which
+//    can be rendered as one block: the envelope stays in
+//    its stage, the loop neither starts nor wraps and the
+//    sample does not end. 0 if the next frame has to be
+//    rendered on its own.
+//    direct is set if all interpolation points can be
+//    read from data without getData().
+//---------------------------------------------------------
+
+int Voice::blockFrames(int maxFrames, bool* direct) const
+      {
+      int n = maxFrames;
+      if (_state == VoiceState::ATTACK || _state == VoiceState::STOP) {
+            const Envelope& e = envelopes[currentEnvelope];
+            n = std::min(n, e.count);
+            // keep the linear ramp close to an exponential stage
+            if (!e.constant && e.table == Envelope::egPow)
+                  n = std::min(n, e.steps * POW_RAMP / EG_SIZE);
+            }
+      if (n < MIN_BLOCK)
+            return 0;
+
+      const int64_t incr    = V1Envelopes::DELAY == currentEnvelope ? 0 : phaseIncr.data;
+      const long long first = phase.index();
+      const long long last  = (phase.data + (n - 1) * incr) >> 8;
+      if (last * audioChan >= eidx)
+            return 0;
+
+      // see updateLoop()
+      int loopOffset = (audioChan * 3) - 1;
+      bool validLoop = _loopEnd > 0 && _loopStart >= 0 && (_loopEnd <= (eidx/audioChan));
+      bool shallLoop = loopMode() == LoopMode::CONTINUOUS || (loopMode() == LoopMode::SUSTAIN && (_state < VoiceState::STOP));
+      if (validLoop && shallLoop) {
+            if (last > _loopEnd || (!_looping && last + loopOffset > _loopEnd))
+                  return 0;
+            }
+      else if (_looping)
+            return 0;
+
+      *direct = first >= 1 && (last + 3) * audioChan <= residentEnd
+                && (!_looping || (first - 1 >= _loopStart && last + 2 <= _loopEnd));
+      return n;
+      }
+
+//---------------------------------------------------------
+//   processBlock
+//    Render frames cleared by blockFrames(). The envelope
+//    is evaluated at the end of the block only and ramped
+//    linearly over it.
+//---------------------------------------------------------
+
+void Voice::processBlock(int frames, bool direct, float* p, float leftChannelVol, float rightChannelVol)
+      {
+      alignas(16) float buffer[BLOCK * 2];
+      const int64_t incr = V1Envelopes::DELAY == currentEnvelope ? 0 : phaseIncr.data;
+      int64_t pos        = phase.data;
+
+      if (audioChan == 1) {
+            if (direct) {
+                  for (int i = 0; i < frames; ++i, pos += incr)
+                        buffer[i] = filter.interpolate(unsigned(pos & 0xff), data + (pos >> 8) - 1);
+                  }
+            else {
+                  short points[4];
+                  for (int i = 0; i < frames; ++i, pos += incr) {
+                        long long idx = pos >> 8;
+                        for (int k = 0; k < 4; ++k)
+                              points[k] = getData(idx - 1 + k);
+                        buffer[i] = filter.interpolate(unsigned(pos & 0xff), points);
+                        }
+                  }
+            }
+      else {
+            if (direct) {
+                  for (int i = 0; i < frames; ++i, pos += incr)
+                        filter.interpolateStereo(unsigned(pos & 0xff), data + (pos >> 8) * 2 - 2, buffer + 2 * i);
+                  }
+            else {
+                  short points[8];
+                  for (int i = 0; i < frames; ++i, pos += incr) {
+                        long long idx = (pos >> 8) * 2;
+                        for (int k = 0; k < 8; ++k)
+                              points[k] = getData(idx - 2 + k);
+                        filter.interpolateStereo(unsigned(pos & 0xff), points, buffer + 2 * i);
+                        }
+                  }
+            }
+      filter.applyBlock(buffer, frames, audioChan);
+      phase.data          = pos;
+      _samplesSinceStart += frames;
+
+      Envelope& e    = envelopes[currentEnvelope];
+      const float e0 = e.val;
+      if (_state == VoiceState::ATTACK || _state == VoiceState::STOP)
+            e.skip(frames);
+      const float de = (e.val - e0) / frames;
+
+      int i = 0;
+#ifdef ZERBERUS_SSE2
+      const __m128 vol = _mm_setr_ps(leftChannelVol, rightChannelVol, leftChannelVol, rightChannelVol);
+      for (; i + 4 <= frames; i += 4) {
+            const __m128 env = _mm_add_ps(_mm_set1_ps(e0), _mm_mul_ps(_mm_set1_ps(de), _mm_setr_ps(i + 1, i + 2, i + 3, i + 4)));
+            __m128 lo, hi;
+            if (audioChan == 1) {
+                  const __m128 v = _mm_load_ps(buffer + i);
+                  lo = _mm_unpacklo_ps(v, v);
+                  hi = _mm_unpackhi_ps(v, v);
+                  }
+            else {
+                  lo = _mm_load_ps(buffer + 2 * i);
+                  hi = _mm_load_ps(buffer + 2 * i + 4);
+                  }
+            lo = _mm_mul_ps(_mm_mul_ps(lo, _mm_unpacklo_ps(env, env)), vol);
+            hi = _mm_mul_ps(_mm_mul_ps(hi, _mm_unpackhi_ps(env, env)), vol);
+            _mm_storeu_ps(p + 2 * i,     _mm_add_ps(_mm_loadu_ps(p + 2 * i), lo));
+            _mm_storeu_ps(p + 2 * i + 4, _mm_add_ps(_mm_loadu_ps(p + 2 * i + 4), hi));
+            }
+#endif
+      for (; i < frames; ++i) {
+            const float env = e0 + de * (i + 1);
+            const float l   = audioChan == 1 ? buffer[i] : buffer[2 * i];
+            const float r   = audioChan == 1 ? buffer[i] : buffer[2 * i + 1];
+            p[2 * i]       += l * env * leftChannelVol;
+            p[2 * i + 1]   += r * env * rightChannelVol;
+            }
+      }
+
+//---------------------------------------------------------
+//   processFrames
+//    render frame by frame
+//---------------------------------------------------------
+
+void Voice::processFrames(int frames, float* p, float leftChannelVol, float rightChannelVol)
+      {
       if (audioChan == 1) {
             while (frames--) {
 
@@ -316,18 +517,40 @@ short Voice::getData(long long pos) {
       if (pos < 0 && !_looping)
             return 0;
 
-      if (!_looping)
+      if (_looping) {
+            long long loopEnd = _loopEnd * audioChan;
+            long long loopStart = _loopStart * audioChan;
+
+            if (pos < loopStart)
+                  pos = loopEnd + (pos - loopStart) + audioChan;
+            else if (pos > (loopEnd + audioChan - 1))
+                  pos = loopStart + (pos - loopEnd) - audioChan;
+            }
+      if (pos < residentEnd)
             return data[pos];
+      return streamedData(pos);
+      }
 
-      long long loopEnd = _loopEnd * audioChan;
-      long long loopStart = _loopStart * audioChan;
+//---------------------------------------------------------
+//   streamedData
+//    data of a streamed sample beyond its resident head
+//---------------------------------------------------------
 
-      if (pos < loopStart)
-            return data[loopEnd + (pos - loopStart) + audioChan];
-      else if (pos > (loopEnd + audioChan - 1))
-            return data[loopStart + (pos - loopEnd) - audioChan];
-      else
-            return data[pos];
+short Voice::streamedData(long long pos)
+      {
+      long long i = z->offset * audioChan + pos;
+      if (i < 0)
+            return 0;
+      long long frame = i / audioChan;
+      int chan        = int(i % audioChan);
+      // pad the end as ZInstrument::readSample() does
+      const long long frames = z->sample->frames();
+      if (frame == frames - 3 || frame == frames - 2)
+            frame = frames - 4;
+      short val;
+      if (z->sample->residentValue(frame, chan, &val))
+            return val;
+      return _stream ? _stream->value(frame, chan) : 0;
       }
 
 //---------------------------------------------------------
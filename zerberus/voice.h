@@ -26,6 +26,7 @@ class Channel;
 struct Zone;
 class Sample;
 class Zerberus;
+struct SampleStream;
 
 enum class LoopMode : char;
 enum class OffMode : char;
@@ -59,6 +60,12 @@ struct Envelope {
             else
                   return true;
             }
+      // n calls of step() which all return false, n <= count
+      void skip(int n) {
+            count -= n;
+            if (!constant)
+                  val = table[EG_SIZE * count/steps]*(max-offset)+offset;
+            }
       void setTime(float ms, int sampleRate);
       void setConstant(float v) { constant = true; val = v; }
       void setVariable()        { constant = false; }
@@ -118,6 +125,7 @@ enum V1Envelopes : int {
 class Voice {
       Voice* _next;
       Zerberus* _zerberus;
+      int _index;
 
       VoiceState _state = VoiceState::OFF;
       Channel* _channel;
@@ -127,6 +135,8 @@ class Voice {
 
       short* data;
       long long eidx;
+      long long residentEnd;  // data beyond this index is streamed
+      SampleStream* _stream;
       LoopMode _loopMode;
       OffMode _offMode;
       int _offBy;
@@ -148,20 +158,31 @@ class Voice {
 
       const Zone* z;
 
+      int blockFrames(int maxFrames, bool* direct) const;
+      void processBlock(int frames, bool direct, float* p, float leftChannelVol, float rightChannelVol);
+      void processFrames(int frames, float* p, float leftChannelVol, float rightChannelVol);
+
    public:
-      Voice(Zerberus*);
+      static const int BLOCK     = 64;    // frames per envelope ramp
+      static const int MIN_BLOCK = 4;
+      static const int POW_RAMP  = 8;     // max. egPow entries one ramp spans
+
+      Voice(Zerberus*, int index);
       Voice* next() const         { return _next; }
       void setNext(Voice* v)      { _next = v; }
 
       void start(Channel* channel, int key, int velo, const Zone*, double durSinceNoteOn);
       void updateEnvelopes();
       void process(int frames, float*);
+      void updateStream();
       void updateLoop();
       short getData(long long pos);
+      short streamedData(long long pos);
 
       Channel* channel() const    { return _channel; }
       int key() const             { return _key;     }
       int velocity() const        { return _velocity; }
+      const Zone* zone() const    { return z; }
 
       bool isPlaying() const      { return _state == VoiceState::PLAYING || _state == VoiceState::ATTACK;   }
       bool isSustained() const    { return _state == VoiceState::SUSTAINED; }
@@ -170,7 +191,7 @@ class Voice {
       void stop()                 { envelopes[currentEnvelope].step(); envelopes[V1Envelopes::RELEASE].max = envelopes[currentEnvelope].val; currentEnvelope = V1Envelopes::RELEASE; _state = VoiceState::STOP;      }
       void stop(float time);
       void sustained()            { _state = VoiceState::SUSTAINED; }
-      void off()                  { _state = VoiceState::OFF;       }
+      void off();
       const char* state() const;
       LoopMode loopMode() const   { return _loopMode; }
       int getSamplesSinceStart()  { return _samplesSinceStart;    }
@@ -20,8 +20,16 @@
 #include "channel.h"
 #include "instrument.h"
 #include "zone.h"
+#include "sample.h"
+#include "streamer.h"
 
 #include <stdio.h>
+#include <algorithm>
+#include <thread>
+
+// frames rendered between two reads of the streamer when
+// rendering offline
+static const unsigned OFFLINE_STREAM_FRAMES = 256;
 
 bool Zerberus::initialized = false;
 // instruments can be shared between several zerberus instances
@@ -52,6 +60,7 @@ Zerberus::Zerberus()
       for (int i = 0; i < MAX_CHANNELS; ++i)
             _channel[i] = new Channel(this, i);
       busy = true;      // no sf loaded yet
+      _streamPreload = Ms::preferences.getInt(PREF_IO_ZERBERUS_STREAMPRELOAD);
       }
 
 //---------------------------------------------------------
@@ -61,6 +70,7 @@ Zerberus::Zerberus()
 Zerberus::~Zerberus()
       {
       busy = true;
+      delete _streamer.load();
       while (!instruments.empty()) {
             auto i  = instruments.front();
             auto it = instruments.begin();
@@ -220,8 +230,33 @@ void Zerberus::play(const Ms::PlayEvent& event)
 
 void Zerberus::process(unsigned frames, float* p, float*, float*)
       {
-      if (busy)
+      _processing = true;
+      if (busy) {
+            _processing = false;
             return;
+            }
+      SampleStreamer* streamer = _streamer.load(std::memory_order_acquire);
+      if (_offline && streamer) {
+            // no streamer thread can keep up with offline
+            // rendering; read ahead of the voices in between
+            for (unsigned n = 0; n < frames; n += OFFLINE_STREAM_FRAMES) {
+                  for (Voice* v = activeVoices; v; v = v->next())
+                        v->updateStream();
+                  streamer->service();
+                  processVoices(std::min(frames - n, OFFLINE_STREAM_FRAMES), p + 2 * n);
+                  }
+            }
+      else
+            processVoices(frames, p);
+      _processing = false;
+      }
+
+//---------------------------------------------------------
+//   processVoices
+//---------------------------------------------------------
+
+void Zerberus::processVoices(unsigned frames, float* p)
+      {
       Voice* v = activeVoices;
       Voice* pv = 0;
       while (v) {
@@ -380,6 +415,7 @@ bool Zerberus::removeSoundFont(const QString& s)
                         if (it1 == globalInstruments.end())
                               return false;
                         globalInstruments.erase(it1);
+                        stopVoices(i);
                         delete i;
                         }
                   
@@ -434,6 +470,109 @@ ZInstrument* Zerberus::instrument(int n) const
       return 0;
       }
 
+//---------------------------------------------------------
+//   stream
+//    the stream of a voice playing a streamed sample
+//---------------------------------------------------------
+
+SampleStream* Zerberus::stream(int voice) const
+      {
+      SampleStreamer* streamer = _streamer.load(std::memory_order_acquire);
+      return streamer ? streamer->stream(voice) : nullptr;
+      }
+
+//---------------------------------------------------------
+//   startStreamer
+//---------------------------------------------------------
+
+void Zerberus::startStreamer()
+      {
+      if (_streamer.load())
+            return;
+      SampleStreamer* streamer = new SampleStreamer(MAX_VOICES);
+      SampleStreamer* expected = nullptr;
+      if (!_streamer.compare_exchange_strong(expected, streamer))
+            delete streamer;
+      }
+
+//---------------------------------------------------------
+//   stopVoices
+//    stop the voices playing samples of instrument i and
+//    wait until neither process() nor the streamer read
+//    them any more; i can be deleted afterwards
+//---------------------------------------------------------
+
+void Zerberus::stopVoices(const ZInstrument* i)
+      {
+      bool wasBusy = busy.exchange(true);
+      while (_processing)
+            std::this_thread::yield();
+      Voice* pv = 0;
+      for (Voice* v = activeVoices; v;) {
+            Voice* next = v->next();
+            if (std::find(i->zones().begin(), i->zones().end(), v->zone()) != i->zones().end()) {
+                  v->off();
+                  if (pv)
+                        pv->setNext(next);
+                  else
+                        activeVoices = next;
+                  freeVoices.push(v);
+                  }
+            else
+                  pv = v;
+            v = next;
+            }
+      SampleStreamer* streamer = _streamer.load();
+      if (streamer)
+            streamer->release();
+      busy = wasBusy;
+      }
+
+//---------------------------------------------------------
+//   setStreamPreload
+//    reload the instruments if the streaming mode changes,
+//    as samples are read when an instrument is loaded
+//---------------------------------------------------------
+
+void Zerberus::setStreamPreload(int ms)
+      {
+      if (ms == _streamPreload)
+            return;
+      _streamPreload = ms;
+      QStringList sfs = soundFonts();
+      if (sfs.isEmpty())
+            return;
+      removeSoundFonts(sfs);
+      loadSoundFonts(sfs);
+      }
+
+//---------------------------------------------------------
+//   streamUnderruns
+//    number of sample values read as silence because the
+//    streamer could not keep up
+//---------------------------------------------------------
+
+int Zerberus::streamUnderruns() const
+      {
+      SampleStreamer* streamer = _streamer.load();
+      return streamer ? streamer->underruns() : 0;
+      }
+
+//---------------------------------------------------------
+//   sampleMemory
+//    bytes of sample data of the loaded instruments
+//---------------------------------------------------------
+
+size_t Zerberus::sampleMemory() const
+      {
+      size_t n = 0;
+      for (const ZInstrument* i : instruments) {
+            for (const Zone* z : i->zones())
+                  n += z->sample->memoryUsed();
+            }
+      return n;
+      }
+
 //---------------------------------------------------------
 //   loadInstrument
 //    return true on success
@@ -450,10 +589,14 @@ bool Zerberus::loadInstrument(const QString& s)
                   return true;
                   }
             }
+      // the samples of a shared instrument are loaded for one
+      // streaming mode
       for (ZInstrument* instr : globalInstruments) {
-            if (QFileInfo(instr->path()).fileName() == fileName) {
+            if (QFileInfo(instr->path()).fileName() == fileName && instr->streamPreload() == _streamPreload) {
                   instruments.push_back(instr);
                   instr->setRefCount(instr->refCount() + 1);
+                  if (instr->streamed())
+                        startStreamer();
                   if (instruments.size() == 1) {
                         for (int i = 0; i < MAX_CHANNELS; ++i)
                               _channel[i]->setInstrument(instr);
@@ -471,11 +614,15 @@ bool Zerberus::loadInstrument(const QString& s)
                   break;
                   }
             }
-      busy = true;
+      // read the instrument while process() keeps running, it
+      // only has to pause while the instrument is installed
       ZInstrument* instr = new ZInstrument(this);
 
       try {
             if (instr->load(path)) {
+                  busy = true;
+                  if (instr->streamed())
+                        startStreamer();
                   globalInstruments.push_back(instr);
                   instruments.push_back(instr);
                   instr->setRefCount(1);
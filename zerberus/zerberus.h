@@ -28,6 +28,7 @@
 
 class Channel;
 class ZInstrument;
+class SampleStreamer;
 enum class Trigger : char;
 
 static const int MAX_VOICES   = 512;
@@ -49,7 +50,7 @@ class VoiceFifo {
 
       void init(Zerberus* z) {
             for (int i = 0; i < MAX_VOICES; ++i) {
-                  voices.push_back(std::unique_ptr<Voice>(new Voice(z)));
+                  voices.push_back(std::unique_ptr<Voice>(new Voice(z, i)));
                   buffer.push(voices.back().get());
                   }
             }
@@ -79,6 +80,7 @@ class Zerberus : public Ms::Synthesizer {
       
       double _masterTuning = 440.0;
       std::atomic<bool> busy;
+      std::atomic<bool> _processing { false };   // process() is running
 
       std::list<ZInstrument*> instruments;
       Channel* _channel[MAX_CHANNELS];
@@ -89,12 +91,20 @@ class Zerberus : public Ms::Synthesizer {
       int _loadProgress = 0;
       bool _loadWasCanceled = false;
 
+      int _streamPreload = 0;             // ms of streamed samples kept in memory, 0: no streaming
+      std::atomic<SampleStreamer*> _streamer { nullptr };   // created with the first streamed instrument
+      bool _offline = false;
+      bool _blockRendering = true;
+
       QMutex mutex;
 
       void programChange(int channel, int program);
       void trigger(Channel*, int key, int velo, Trigger, int cc, int ccVal, double durSinceNoteOn);
       void processNoteOff(Channel*, int pitch);
       void processNoteOn(Channel* cp, int key, int velo);
+      void processVoices(unsigned frames, float*);
+      void startStreamer();
+      void stopVoices(const ZInstrument*);
 
    public:
       Zerberus();
@@ -113,6 +123,15 @@ class Zerberus : public Ms::Synthesizer {
       bool loadWasCanceled()        { return _loadWasCanceled; }
       void setLoadWasCanceled(bool status)     { _loadWasCanceled = status; }
 
+      int streamPreload() const     { return _streamPreload; }
+      void setStreamPreload(int ms);
+      SampleStream* stream(int voice) const;
+      int streamUnderruns() const;
+      size_t sampleMemory() const;
+      virtual void setOfflineRendering(bool val) override { _offline = val; }
+      bool blockRendering() const        { return _blockRendering; }
+      void setBlockRendering(bool val)   { _blockRendering = val; }   // off renders every frame on its own
+
       virtual void setMasterTuning(double val) { _masterTuning = val;  }
       virtual double masterTuning() const      { return _masterTuning; }
 